@@ -10,6 +10,8 @@
 
 namespace SAGE {
 
+class JobSystem;
+
 class Application {
 public:
     explicit Application(const ApplicationConfig& config = {});
@@ -28,6 +30,9 @@ public:
     Window& GetWindow() { return *m_Window; }
     const Window& GetWindow() const { return *m_Window; }
 
+    // Engine-owned worker pool (ApplicationConfig::workerThreads)
+    JobSystem& GetJobSystem() { return *m_JobSystem; }
+
 protected:
     virtual void OnInit() {}
     virtual void OnUpdate(double /*deltaTime*/) {}
@@ -42,6 +47,7 @@ private:
     void HandleResize(int width, int height);
 
     std::unique_ptr<Window> m_Window;
+    std::unique_ptr<JobSystem> m_JobSystem;
     bool m_Running = true;
     bool m_WindowActive = true;
     
@@ -9,6 +9,9 @@ struct ApplicationConfig {
     WindowConfig window;
     RendererConfig renderer;
     bool enableLogging = true;
+    // Worker threads of the engine job system: -1 = hardware_concurrency - 1,
+    // 0 = run jobs on the main thread
+    int workerThreads = -1;
 };
 
 } // namespace SAGE
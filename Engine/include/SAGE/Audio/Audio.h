@@ -36,6 +36,12 @@ public:
     void SetSpatial(bool spatial); // Enable/Disable 3D spatialization
 
     bool IsPlaying() const;
+    bool IsLoaded() const;
+
+    // Playback position and length in seconds (0 if the sound is not loaded)
+    float GetCursor() const;
+    float GetLength() const;
+    void Seek(float seconds);
 
     static std::shared_ptr<Sound> Create(const std::string& path, SoundType type = SoundType::Static);
 
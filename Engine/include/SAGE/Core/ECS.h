@@ -1,14 +1,44 @@
 #pragma once
 
+#include "SAGE/Core/JobSystem.h"
+#include "SAGE/Core/Profiler.h"
+
 #include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <exception>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
+// Debug validation of declared system access (see SystemAccess). On by default
+// in debug builds; define SAGE_ECS_ACCESS_CHECKS=0/1 to override.
+#ifndef SAGE_ECS_ACCESS_CHECKS
+    #ifdef NDEBUG
+        #define SAGE_ECS_ACCESS_CHECKS 0
+    #else
+        #define SAGE_ECS_ACCESS_CHECKS 1
+    #endif
+#endif
+
 namespace SAGE::ECS {
 
 // =========================================================
@@ -29,10 +59,10 @@ namespace detail {
         return (version << kVersionShift) | index;
     }
 
-    // Static Component Type ID Generator
+    // Static Component Type ID Generator (atomic: first use may happen on a worker thread)
     inline uint32_t GetNextComponentTypeID() {
-        static uint32_t typeID = 0;
-        return typeID++;
+        static std::atomic<uint32_t> typeID{0};
+        return typeID.fetch_add(1, std::memory_order_relaxed);
     }
 
     template<typename T>
@@ -40,83 +70,519 @@ namespace detail {
         static uint32_t typeID = GetNextComponentTypeID();
         return typeID;
     }
+
+    // Context (Registry::Ctx) types are numbered separately so they do not
+    // take component mask bits
+    inline uint32_t GetNextContextTypeID() {
+        static std::atomic<uint32_t> typeID{0};
+        return typeID.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    inline uint32_t GetContextTypeID() {
+        static uint32_t typeID = GetNextContextTypeID();
+        return typeID;
+    }
+} // namespace detail
+
+// =========================================================
+// System access declarations
+// =========================================================
+// Components and context (Registry::Ctx) types a system reads and writes.
+// The scheduler runs systems whose access sets do not conflict at the same
+// time. Context types keep their own ids and never take component mask bits.
+struct SystemAccess {
+    std::vector<uint32_t> reads;
+    std::vector<uint32_t> writes;
+    std::vector<uint32_t> ctxReads;
+    std::vector<uint32_t> ctxWrites;
+    bool mainThread = false; // must run on the main thread (GL, audio, physics world)
+    bool exclusive = false;  // conflicts with everything, may do structural changes
+
+    template<typename... Cs>
+    SystemAccess& Read() {
+        (Insert(reads, detail::GetComponentTypeID<Cs>()), ...);
+        return *this;
+    }
+
+    template<typename... Cs>
+    SystemAccess& Write() {
+        (Insert(writes, detail::GetComponentTypeID<Cs>()), ...);
+        return *this;
+    }
+
+    template<typename... Ts>
+    SystemAccess& ReadCtx() {
+        (Insert(ctxReads, detail::GetContextTypeID<Ts>()), ...);
+        return *this;
+    }
+
+    template<typename... Ts>
+    SystemAccess& WriteCtx() {
+        (Insert(ctxWrites, detail::GetContextTypeID<Ts>()), ...);
+        return *this;
+    }
+
+    SystemAccess& MainThread() {
+        mainThread = true;
+        return *this;
+    }
+
+    // Default for systems that do not declare anything
+    static SystemAccess Exclusive() {
+        SystemAccess access;
+        access.exclusive = true;
+        access.mainThread = true;
+        return access;
+    }
+
+    bool CanRead(uint32_t typeId) const {
+        return exclusive || Contains(reads, typeId) || Contains(writes, typeId);
+    }
+
+    bool CanWrite(uint32_t typeId) const {
+        return exclusive || Contains(writes, typeId);
+    }
+
+    bool ConflictsWith(const SystemAccess& other) const {
+        if (exclusive || other.exclusive) {
+            return true;
+        }
+        return Overlaps(reads, writes, other.reads, other.writes) ||
+               Overlaps(ctxReads, ctxWrites, other.ctxReads, other.ctxWrites);
+    }
+
+private:
+    static bool Overlaps(const std::vector<uint32_t>& reads, const std::vector<uint32_t>& writes,
+                         const std::vector<uint32_t>& otherReads, const std::vector<uint32_t>& otherWrites) {
+        for (uint32_t id : writes) {
+            if (Contains(otherReads, id) || Contains(otherWrites, id)) return true;
+        }
+        for (uint32_t id : otherWrites) {
+            if (Contains(reads, id)) return true;
+        }
+        return false;
+    }
+
+    static bool Contains(const std::vector<uint32_t>& ids, uint32_t id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    }
+
+    static void Insert(std::vector<uint32_t>& ids, uint32_t id) {
+        if (!Contains(ids, id)) ids.push_back(id);
+    }
+};
+
+struct AccessViolation {
+    size_t systemIndex = 0;
+    uint32_t componentTypeId = 0; // kAnyComponent for entity create/destroy/clear
+    bool structural = false;      // Add/Remove/Create/Destroy from a non-exclusive system
+    bool write = false;           // mutable access to a component not declared Write
+
+    static constexpr uint32_t kAnyComponent = std::numeric_limits<uint32_t>::max();
+};
+
+namespace detail {
+    // Installed by SystemScheduler on the thread running a system while validation is on
+    struct AccessScope {
+        const SystemAccess* access = nullptr;
+        size_t systemIndex = 0;
+        void* owner = nullptr;
+        void (*report)(void* owner, const AccessViolation& violation) = nullptr;
+    };
+
+    inline thread_local AccessScope* tl_AccessScope = nullptr;
+
+    // Counters of the system run on this thread while SystemScheduler
+    // profiling is on (nullptr otherwise). Parallel chunks add from workers.
+    struct SystemCounters {
+        std::atomic<uint64_t> entities{0};
+        std::atomic<uint64_t> structural{0};
+    };
+
+    inline thread_local SystemCounters* tl_Counters = nullptr;
+
+    inline void CountEntities(uint64_t count) {
+        if (SystemCounters* counters = tl_Counters) {
+            counters->entities.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    inline void CountStructural() {
+        if (SystemCounters* counters = tl_Counters) {
+            counters->structural.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // write: non-const Get, non-const query terms, Sort
+    inline void CheckAccess(uint32_t typeId, bool write = false) {
+#if SAGE_ECS_ACCESS_CHECKS
+        const AccessScope* scope = tl_AccessScope;
+        if (scope && !(write ? scope->access->CanWrite(typeId) : scope->access->CanRead(typeId))) {
+            scope->report(scope->owner, {scope->systemIndex, typeId, false, write});
+        }
+#else
+        (void)typeId;
+        (void)write;
+#endif
+    }
+
+    inline void CheckStructural(uint32_t typeId) {
+        CountStructural();
+#if SAGE_ECS_ACCESS_CHECKS
+        const AccessScope* scope = tl_AccessScope;
+        if (scope && !scope->access->exclusive) {
+            scope->report(scope->owner, {scope->systemIndex, typeId, true});
+        }
+#else
+        (void)typeId;
+#endif
+    }
 } // namespace detail
 
+// Which component types an entity owns. Types with an id beyond kBits are
+// not tracked individually; the entity is flagged as "untracked" instead.
+struct ComponentMask {
+    static constexpr uint32_t kWords = 2;
+    static constexpr uint32_t kBits = kWords * 64;
+
+    std::array<uint64_t, kWords> words{};
+    bool untracked = false;
+
+    static bool Tracks(uint32_t typeId) { return typeId < kBits; }
+
+    void Set(uint32_t typeId) {
+        if (Tracks(typeId)) words[typeId >> 6] |= (1ull << (typeId & 63));
+        else untracked = true;
+    }
+
+    void Reset(uint32_t typeId) {
+        if (Tracks(typeId)) words[typeId >> 6] &= ~(1ull << (typeId & 63));
+    }
+
+    bool Test(uint32_t typeId) const {
+        return Tracks(typeId) && (words[typeId >> 6] & (1ull << (typeId & 63))) != 0;
+    }
+
+    bool Any() const {
+        return untracked || std::any_of(words.begin(), words.end(), [](uint64_t w) { return w != 0; });
+    }
+
+    bool operator==(const ComponentMask& other) const = default;
+
+    bool ContainsAll(const ComponentMask& required) const {
+        for (uint32_t i = 0; i < kWords; ++i) {
+            if ((words[i] & required.words[i]) != required.words[i]) return false;
+        }
+        return true;
+    }
+
+    bool Intersects(const ComponentMask& other) const {
+        for (uint32_t i = 0; i < kWords; ++i) {
+            if ((words[i] & other.words[i]) != 0) return true;
+        }
+        return false;
+    }
+
+    template<typename Fn>
+    void ForEachSet(Fn&& fn) const {
+        for (uint32_t i = 0; i < kWords; ++i) {
+            uint64_t bits = words[i];
+            while (bits) {
+                const uint32_t bit = static_cast<uint32_t>(std::countr_zero(bits));
+                fn(i * 64 + bit);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    void Clear() {
+        words = {};
+        untracked = false;
+    }
+};
+
 struct EntityData {
     uint32_t version = 1;
     bool alive = false;
+    ComponentMask components;
+    // Archetype storage only: table and row of the entity's components
+    uint32_t archetype = 0;
+    uint32_t row = 0;
 };
 
 // =========================================================
 // Component pools (sparse set)
 // =========================================================
+namespace detail { struct GroupData; }
+
+struct PoolMemoryStats {
+    size_t entityCount = 0;
+    size_t sparseBytes = 0; // page table + allocated pages
+    size_t denseBytes = 0;  // components + entity list + change ticks (capacity)
+    size_t TotalBytes() const { return sparseBytes + denseBytes; }
+};
+
+// Change-detection stamps of one component slot (see Registry::CurrentTick)
+struct ComponentTicks {
+    uint32_t added = 0;
+    uint32_t changed = 0;
+};
+
+namespace detail {
+    // Stamps are written by whichever system touches the slot; relaxed atomics
+    // keep concurrent readers of the same component race-free.
+    inline void StoreTick(uint32_t& slot, uint32_t tick) {
+        std::atomic_ref<uint32_t>(slot).store(tick, std::memory_order_relaxed);
+    }
+    inline uint32_t LoadTick(const uint32_t& slot) {
+        return std::atomic_ref<uint32_t>(const_cast<uint32_t&>(slot)).load(std::memory_order_relaxed);
+    }
+}
+
+// =========================================================
+// Signals
+// =========================================================
+// Non-owning callback: an object pointer plus a plain function pointer, bound
+// at compile time to a free function or member function. Two pointers, no
+// allocation, comparable (so it can be disconnected).
+template<typename... Args>
+class Delegate {
+public:
+    Delegate() = default;
+
+    // void Fn(Args...)
+    template<auto Fn>
+    static Delegate Bind() {
+        Delegate d;
+        d.m_Call = [](void*, Args... args) { Fn(std::forward<Args>(args)...); };
+        return d;
+    }
+
+    // void C::Fn(Args...)
+    template<auto Fn, typename C>
+    static Delegate Bind(C* instance) {
+        Delegate d;
+        d.m_Instance = const_cast<void*>(static_cast<const void*>(instance));
+        d.m_Call = [](void* self, Args... args) { (static_cast<C*>(self)->*Fn)(std::forward<Args>(args)...); };
+        return d;
+    }
+
+    void operator()(Args... args) const { m_Call(m_Instance, std::forward<Args>(args)...); }
+    explicit operator bool() const { return m_Call != nullptr; }
+
+    bool operator==(const Delegate& other) const = default;
+
+    const void* Instance() const { return m_Instance; }
+
+private:
+    void* m_Instance = nullptr;
+    void (*m_Call)(void*, Args...) = nullptr;
+};
+
+// List of delegates called in connection order. Listeners may connect or
+// disconnect (themselves included) while the signal is being published.
+template<typename... Args>
+class Signal {
+public:
+    template<auto Fn>
+    void Connect() { m_Listeners.push_back(Delegate<Args...>::template Bind<Fn>()); }
+
+    template<auto Fn, typename C>
+    void Connect(C* instance) { m_Listeners.push_back(Delegate<Args...>::template Bind<Fn>(instance)); }
+
+    template<auto Fn>
+    void Disconnect() { Erase(Delegate<Args...>::template Bind<Fn>()); }
+
+    template<auto Fn, typename C>
+    void Disconnect(C* instance) { Erase(Delegate<Args...>::template Bind<Fn>(instance)); }
+
+    // Every listener bound to instance
+    void Disconnect(const void* instance) {
+        std::erase_if(m_Listeners, [instance](const Delegate<Args...>& d) { return d.Instance() == instance; });
+    }
+
+    void Publish(Args... args) const {
+        for (size_t i = 0; i < m_Listeners.size(); ++i) {
+            m_Listeners[i](args...);
+        }
+    }
+
+    bool Empty() const { return m_Listeners.empty(); }
+    size_t Size() const { return m_Listeners.size(); }
+
+private:
+    void Erase(const Delegate<Args...>& delegate) {
+        std::erase(m_Listeners, delegate);
+    }
+
+    std::vector<Delegate<Args...>> m_Listeners;
+};
+
+class Registry;
+
+// Construct/update/destroy notifications of one component type
+using ComponentSignal = Signal<Registry&, Entity>;
+
 struct IPool {
     virtual ~IPool() = default;
     virtual void Remove(Entity e) = 0;
     virtual bool Contains(Entity e) const = 0;
     virtual void Clear() = 0;
+    // Clear without the remove callback (Registry::Restore)
+    virtual void Reset() = 0;
     virtual size_t Size() const = 0;
     virtual const std::vector<Entity>& Entities() const = 0;
+
+    // Dense slot of e, or kInvalidSparse
+    virtual uint32_t IndexOf(Entity e) const = 0;
+    // Swap two dense slots (component, entity and sparse back-references)
+    virtual void SwapDense(uint32_t a, uint32_t b) = 0;
+
+    // Release empty sparse pages and unused dense capacity
+    virtual void Compact() = 0;
+    virtual PoolMemoryStats MemoryStats() const = 0;
+    virtual const char* TypeName() const = 0;
+
+    // Snapshots (see Registry::Snapshot): a detached copy of the data, and
+    // replacing the data with that of a pool of the same type
+    virtual std::unique_ptr<IPool> Clone() const = 0;
+    virtual void CopyFrom(const IPool& source) = 0;
+
+    // Group that keeps its members packed at the front of this pool, if any
+    detail::GroupData* ownerGroup = nullptr;
+
+    // Published by Registry (see Registry::OnConstruct)
+    ComponentSignal onConstruct;
+    ComponentSignal onUpdate;
+    ComponentSignal onDestroy;
 };
 
+namespace detail {
+    // Owning group: entities that have every owned component occupy
+    // slots [0, size) in each owned pool, in the same order.
+    struct GroupData {
+        std::vector<IPool*> pools;
+        size_t size = 0;
+
+        bool Holds(Entity e) const {
+            const uint32_t index = pools.front()->IndexOf(e);
+            return index != kInvalidSparse && index < size;
+        }
+
+        void Enter(Entity e) {
+            for (IPool* pool : pools) {
+                if (!pool->Contains(e)) return;
+            }
+            if (Holds(e)) return;
+            for (IPool* pool : pools) {
+                pool->SwapDense(pool->IndexOf(e), static_cast<uint32_t>(size));
+            }
+            ++size;
+        }
+
+        void Leave(Entity e) {
+            if (!Holds(e)) return;
+            --size;
+            for (IPool* pool : pools) {
+                pool->SwapDense(pool->IndexOf(e), static_cast<uint32_t>(size));
+            }
+        }
+    };
+} // namespace detail
+
+namespace detail {
+    // Dense "array" of an empty (tag) component: only a count. Every slot
+    // aliases one shared instance, so tags cost the entity list and the
+    // sparse index only.
+    template<typename T>
+    struct TagStorage {
+        size_t count = 0;
+        inline static T instance{};
+
+        size_t size() const { return count; }
+        size_t capacity() const { return 0; }
+        template<typename... Args>
+        void emplace_back(Args&&...) { ++count; }
+        T& back() { return instance; }
+        T& operator[](size_t) { return instance; }
+        const T& operator[](size_t) const { return instance; }
+        T* data() { return &instance; }
+        const T* data() const { return &instance; }
+        void pop_back() { --count; }
+        void clear() { count = 0; }
+        void shrink_to_fit() {}
+    };
+
+    // Element i of a pool's Data(); tags all share element 0
+    template<typename T>
+    T& DenseAt(T* data, size_t i) {
+        if constexpr (std::is_empty_v<std::remove_const_t<T>>) {
+            return *data;
+        } else {
+            return data[i];
+        }
+    }
+} // namespace detail
+
 template<typename T>
 class ComponentPool : public IPool {
 public:
+    // Empty types keep no dense array and no change ticks
+    static constexpr bool kIsTag = std::is_empty_v<T>;
+
     using OnRemoveCallback = std::function<void(Entity, T&)>;
+    // Copies a component into or out of a snapshot (deep copy of shared data)
+    using CopyHook = std::function<T(const T&)>;
 
     void SetOnRemove(OnRemoveCallback cb) { m_OnRemove = std::move(cb); }
+    void SetCopyHook(CopyHook hook) { m_CopyHook = std::move(hook); }
 
     template<typename... Args>
     T& Emplace(Entity e, Args&&... args) {
-        EnsureSparse(e);
         const uint32_t denseIndex = static_cast<uint32_t>(m_Dense.size());
-        m_Sparse[detail::DecodeIndex(e)] = denseIndex;
+        SparseSlot(detail::DecodeIndex(e)) = denseIndex;
         m_Entities.push_back(e);
+        if constexpr (!kIsTag) {
+            m_AddedTicks.push_back(0);
+            m_ChangedTicks.push_back(0);
+        }
         m_Dense.emplace_back(std::forward<Args>(args)...);
         return m_Dense.back();
     }
 
     bool Contains(Entity e) const override {
-        const uint32_t idx = detail::DecodeIndex(e);
-        if (idx >= m_Sparse.size()) {
-            return false;
-        }
-        const uint32_t denseIndex = m_Sparse[idx];
-        return denseIndex != detail::kInvalidSparse
-            && denseIndex < m_Dense.size()
-            && m_Entities[denseIndex] == e;
+        return IndexOf(e) != detail::kInvalidSparse;
     }
 
     T* Get(Entity e) {
-        // Direct access optimization: assume caller checked Contains or is sure
-        // But for safety in Get(), we check bounds via sparse array
-        const uint32_t idx = detail::DecodeIndex(e);
-        if (idx >= m_Sparse.size()) return nullptr;
-        
-        const uint32_t denseIndex = m_Sparse[idx];
-        if (denseIndex == detail::kInvalidSparse || denseIndex >= m_Dense.size() || m_Entities[denseIndex] != e) {
-            return nullptr;
-        }
-        return &m_Dense[denseIndex];
+        const uint32_t denseIndex = IndexOf(e);
+        return denseIndex != detail::kInvalidSparse ? &m_Dense[denseIndex] : nullptr;
     }
 
     const T* Get(Entity e) const {
-        const uint32_t idx = detail::DecodeIndex(e);
-        if (idx >= m_Sparse.size()) return nullptr;
+        const uint32_t denseIndex = IndexOf(e);
+        return denseIndex != detail::kInvalidSparse ? &m_Dense[denseIndex] : nullptr;
+    }
 
-        const uint32_t denseIndex = m_Sparse[idx];
-        if (denseIndex == detail::kInvalidSparse || denseIndex >= m_Dense.size() || m_Entities[denseIndex] != e) {
-            return nullptr;
+    // Room for `additional` more components and a page table reaching maxIndex
+    void Reserve(size_t additional, uint32_t maxIndex) {
+        const size_t total = m_Entities.size() + additional;
+        m_Entities.reserve(total);
+        if constexpr (!kIsTag) {
+            m_Dense.reserve(total);
+            m_AddedTicks.reserve(total);
+            m_ChangedTicks.reserve(total);
+        }
+        const size_t pages = maxIndex / kSparsePageSize + 1;
+        if (pages > m_SparsePages.size()) {
+            m_SparsePages.resize(pages);
         }
-        return &m_Dense[denseIndex];
     }
 
     void Remove(Entity e) override {
-        const uint32_t idx = detail::DecodeIndex(e);
-        if (idx >= m_Sparse.size()) return;
-
-        const uint32_t denseIndex = m_Sparse[idx];
-        if (denseIndex == detail::kInvalidSparse || denseIndex >= m_Dense.size() || m_Entities[denseIndex] != e) {
+        const uint32_t denseIndex = IndexOf(e);
+        if (denseIndex == detail::kInvalidSparse) {
             return;
         }
 
@@ -129,14 +595,22 @@ public:
 
         if (denseIndex != lastIndex) {
             Entity lastEntity = m_Entities[lastIndex];
-            std::swap(m_Dense[denseIndex], m_Dense[lastIndex]);
             std::swap(m_Entities[denseIndex], m_Entities[lastIndex]);
-            m_Sparse[detail::DecodeIndex(lastEntity)] = denseIndex;
+            if constexpr (!kIsTag) {
+                std::swap(m_Dense[denseIndex], m_Dense[lastIndex]);
+                std::swap(m_AddedTicks[denseIndex], m_AddedTicks[lastIndex]);
+                std::swap(m_ChangedTicks[denseIndex], m_ChangedTicks[lastIndex]);
+            }
+            SparseSlot(detail::DecodeIndex(lastEntity)) = denseIndex;
         }
 
         m_Dense.pop_back();
         m_Entities.pop_back();
-        m_Sparse[idx] = detail::kInvalidSparse;
+        if constexpr (!kIsTag) {
+            m_AddedTicks.pop_back();
+            m_ChangedTicks.pop_back();
+        }
+        SparseSlot(detail::DecodeIndex(e)) = detail::kInvalidSparse;
     }
 
     void Clear() override {
@@ -145,110 +619,1301 @@ public:
                 m_OnRemove(m_Entities[i], m_Dense[i]);
             }
         }
+        Reset();
+    }
+
+    void Reset() override {
         m_Dense.clear();
         m_Entities.clear();
-        m_Sparse.clear();
+        m_AddedTicks.clear();
+        m_ChangedTicks.clear();
+        std::vector<SparsePage>().swap(m_SparsePages); // release every page
     }
 
-    size_t Size() const override { return m_Dense.size(); }
+    size_t Size() const override { return m_Entities.size(); }
     const std::vector<Entity>& Entities() const override { return m_Entities; }
 
-private:
-    void EnsureSparse(Entity e) {
-        const uint32_t idx = detail::DecodeIndex(e);
-        if (idx >= m_Sparse.size()) {
-            m_Sparse.resize(idx + 1, detail::kInvalidSparse);
+    // For tags this points at the one shared instance (see detail::DenseAt)
+    T* Data() { return m_Dense.data(); }
+    const T* Data() const { return m_Dense.data(); }
+    T& At(uint32_t denseIndex) { return m_Dense[denseIndex]; }
+
+    // Change-detection stamps, parallel to Data(). Kept in separate arrays
+    // so stamping a write touches 4 bytes per entity.
+    uint32_t* AddedTicks() { return m_AddedTicks.data(); }
+    const uint32_t* AddedTicks() const { return m_AddedTicks.data(); }
+    uint32_t* ChangedTicks() { return m_ChangedTicks.data(); }
+    const uint32_t* ChangedTicks() const { return m_ChangedTicks.data(); }
+
+    ComponentTicks GetTicks(Entity e) const {
+        const uint32_t denseIndex = IndexOf(e);
+        if (denseIndex == detail::kInvalidSparse) {
+            return {};
+        }
+        if constexpr (kIsTag) {
+            return {};
+        } else {
+            return {detail::LoadTick(m_AddedTicks[denseIndex]), detail::LoadTick(m_ChangedTicks[denseIndex])};
         }
     }
 
-    std::vector<T> m_Dense;
-    std::vector<Entity> m_Entities;
-    std::vector<uint32_t> m_Sparse;
-    OnRemoveCallback m_OnRemove;
-};
-
-// =========================================================
-// Registry / World
-// =========================================================
-class Registry {
-public:
-    Registry() {
-        // Reserve index 0 as invalid
-        m_Entities.push_back({});
+    uint32_t IndexOf(Entity e) const override {
+        const uint32_t idx = detail::DecodeIndex(e);
+        const uint32_t page = idx / kSparsePageSize;
+        if (page >= m_SparsePages.size() || !m_SparsePages[page]) {
+            return detail::kInvalidSparse;
+        }
+        const uint32_t denseIndex = m_SparsePages[page][idx % kSparsePageSize];
+        if (denseIndex == detail::kInvalidSparse || denseIndex >= m_Entities.size() || m_Entities[denseIndex] != e) {
+            return detail::kInvalidSparse;
+        }
+        return denseIndex;
     }
 
-    Entity CreateEntity() {
-        uint32_t index = 0;
-        if (!m_FreeList.empty()) {
-            index = m_FreeList.back();
-            m_FreeList.pop_back();
-        } else {
-            index = static_cast<uint32_t>(m_Entities.size());
-            m_Entities.push_back({});
+    void SwapDense(uint32_t a, uint32_t b) override {
+        if (a == b) return;
+        std::swap(m_Entities[a], m_Entities[b]);
+        if constexpr (!kIsTag) {
+            std::swap(m_Dense[a], m_Dense[b]);
+            std::swap(m_AddedTicks[a], m_AddedTicks[b]);
+            std::swap(m_ChangedTicks[a], m_ChangedTicks[b]);
         }
-
-        EntityData& data = m_Entities[index];
-        data.alive = true;
-        Entity e = detail::Encode(index, data.version);
-        ++m_AliveCount;
-        return e;
+        SparseSlot(detail::DecodeIndex(m_Entities[a])) = a;
+        SparseSlot(detail::DecodeIndex(m_Entities[b])) = b;
     }
 
-    bool IsAlive(Entity e) const {
-        const uint32_t idx = detail::DecodeIndex(e);
-        if (idx >= m_Entities.size()) {
-            return false;
+    // Stable in-place sort of the dense array by comp(const T&, const T&).
+    // An already sorted pool costs one pass; a nearly sorted one (few
+    // out-of-order neighbours, e.g. a changed layer) is fixed by insertion sort.
+    template<typename Compare>
+    void Sort(Compare comp) {
+        static_assert(!kIsTag, "Tag components have no values to sort by");
+        const size_t count = m_Entities.size();
+        size_t descents = 0;
+        for (size_t i = 1; i < count; ++i) {
+            if (comp(m_Dense[i], m_Dense[i - 1])) ++descents;
         }
-        const EntityData& data = m_Entities[idx];
-        return data.alive && data.version == detail::DecodeVersion(e);
+        if (descents == 0) {
+            return;
+        }
+
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(i);
+        auto less = [this, &comp](uint32_t a, uint32_t b) { return comp(m_Dense[a], m_Dense[b]); };
+        if (descents <= kInsertionSortDescents) {
+            for (size_t i = 1; i < count; ++i) {
+                const uint32_t moving = order[i];
+                size_t j = i;
+                for (; j > 0 && less(moving, order[j - 1]); --j) {
+                    order[j] = order[j - 1];
+                }
+                order[j] = moving;
+            }
+        } else {
+            std::stable_sort(order.begin(), order.end(), less);
+        }
+        ApplyOrder(order);
     }
 
-    void DestroyEntity(Entity e) {
-        if (!IsAlive(e)) {
+    // Stable LSD radix sort by an unsigned integer key of each component.
+    // Byte passes where every key agrees are skipped. [begin, end) limits the
+    // sort to a slice of the dense array (incremental re-sorting).
+    template<typename KeyFn>
+    void SortByKey(KeyFn keyOf, size_t begin = 0, size_t end = static_cast<size_t>(-1)) {
+        static_assert(!kIsTag, "Tag components have no values to sort by");
+        using Key = std::remove_cvref_t<std::invoke_result_t<KeyFn&, const T&>>;
+        static_assert(std::is_unsigned_v<Key>, "Sort key must be an unsigned integer");
+
+        end = std::min(end, m_Entities.size());
+        const size_t count = end > begin ? end - begin : 0;
+        if (count < 2) {
+            return;
+        }
+        std::vector<Key> keys(count);
+        bool sorted = true;
+        for (size_t i = 0; i < count; ++i) {
+            keys[i] = keyOf(static_cast<const T&>(m_Dense[begin + i]));
+            sorted = sorted && (i == 0 || keys[i - 1] <= keys[i]);
+        }
+        if (sorted) {
             return;
         }
 
-        // Remove from all pools
-        // Optimization: We could track which pools an entity is in, but iterating all pools is safe for now
-        for (auto& pool : m_Pools) {
-            if (pool) pool->Remove(e);
+        std::vector<uint32_t> order(count);
+        std::vector<uint32_t> scratch(count);
+        for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(i);
+        for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+            std::array<uint32_t, 257> offsets{};
+            for (size_t i = 0; i < count; ++i) {
+                ++offsets[((keys[i] >> shift) & 0xFF) + 1];
+            }
+            if (std::find(offsets.begin(), offsets.end(), static_cast<uint32_t>(count)) != offsets.end()) {
+                continue; // every key has the same byte here
+            }
+            for (size_t b = 1; b < offsets.size(); ++b) offsets[b] += offsets[b - 1];
+            for (uint32_t index : order) {
+                scratch[offsets[(keys[index] >> shift) & 0xFF]++] = index;
+            }
+            order.swap(scratch);
         }
+        ApplyOrder(order, static_cast<uint32_t>(begin));
+    }
 
-        const uint32_t idx = detail::DecodeIndex(e);
-        EntityData& data = m_Entities[idx];
-        data.alive = false;
-        ++data.version; // invalidate stale handles
-        m_FreeList.push_back(idx);
-        if (m_AliveCount > 0) {
-            --m_AliveCount;
+    void Compact() override {
+        for (auto& page : m_SparsePages) {
+            if (page && std::all_of(page.get(), page.get() + kSparsePageSize,
+                                    [](uint32_t v) { return v == detail::kInvalidSparse; })) {
+                page.reset();
+            }
         }
+        while (!m_SparsePages.empty() && !m_SparsePages.back()) {
+            m_SparsePages.pop_back();
+        }
+        m_SparsePages.shrink_to_fit();
+        m_Dense.shrink_to_fit();
+        m_Entities.shrink_to_fit();
+        m_AddedTicks.shrink_to_fit();
+        m_ChangedTicks.shrink_to_fit();
     }
 
-    void Destroy(Entity e) {
-        DestroyEntity(e);
+    const char* TypeName() const override { return typeid(T).name(); }
+
+    std::unique_ptr<IPool> Clone() const override {
+        auto copy = std::make_unique<ComponentPool<T>>();
+        copy->m_CopyHook = m_CopyHook;
+        copy->CopyFrom(*this);
+        return copy;
     }
 
-    void Clear() {
-        for (auto& pool : m_Pools) {
-            if (pool) pool->Clear();
+    // Reuses this pool's allocations; no callbacks or signals
+    void CopyFrom(const IPool& source) override {
+        const auto& other = static_cast<const ComponentPool<T>&>(source);
+        CopyDense(other);
+        m_Entities = other.m_Entities;
+        m_AddedTicks = other.m_AddedTicks;
+        m_ChangedTicks = other.m_ChangedTicks;
+        m_SparsePages.resize(other.m_SparsePages.size());
+        for (size_t page = 0; page < m_SparsePages.size(); ++page) {
+            if (!other.m_SparsePages[page]) {
+                m_SparsePages[page].reset();
+                continue;
+            }
+            if (!m_SparsePages[page]) {
+                m_SparsePages[page] = std::make_unique_for_overwrite<uint32_t[]>(kSparsePageSize);
+            }
+            std::memcpy(m_SparsePages[page].get(), other.m_SparsePages[page].get(), kSparsePageSize * sizeof(uint32_t));
         }
-        // Do not clear m_Pools vector to preserve allocated pools
-        
-        m_Entities.clear();
-        m_FreeList.clear();
-        m_AliveCount = 0;
-        
-        // Reserve index 0 as invalid
-        m_Entities.push_back({});
     }
 
-    size_t AliveCount() const { return m_AliveCount; }
+    PoolMemoryStats MemoryStats() const override {
+        PoolMemoryStats stats;
+        stats.entityCount = m_Entities.size();
+        stats.sparseBytes = m_SparsePages.capacity() * sizeof(SparsePage);
+        for (const auto& page : m_SparsePages) {
+            if (page) stats.sparseBytes += kSparsePageSize * sizeof(uint32_t);
+        }
+        stats.denseBytes = m_Dense.capacity() * sizeof(T) + m_Entities.capacity() * sizeof(Entity)
+                         + (m_AddedTicks.capacity() + m_ChangedTicks.capacity()) * sizeof(uint32_t);
+        return stats;
+    }
 
-    void ForEachEntity(std::function<void(Entity)> fn) {
-        for (size_t i = 1; i < m_Entities.size(); ++i) {
-            if (m_Entities[i].alive) {
-                Entity e = detail::Encode(static_cast<uint32_t>(i), m_Entities[i].version);
-                fn(e);
+private:
+    // memcpy for trivially copyable components, the copy hook or copy
+    // constructor otherwise
+    void CopyDense(const ComponentPool<T>& other) {
+        if constexpr (kIsTag) {
+            m_Dense.count = other.m_Dense.count;
+        } else {
+            const size_t count = other.m_Dense.size();
+            if (m_CopyHook) {
+                m_Dense.clear();
+                m_Dense.reserve(count);
+                for (const T& component : other.m_Dense) m_Dense.push_back(m_CopyHook(component));
+            } else if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>) {
+                m_Dense.resize(count);
+                if (count > 0) std::memcpy(m_Dense.data(), other.m_Dense.data(), count * sizeof(T));
+            } else if constexpr (std::is_copy_constructible_v<T>) {
+                m_Dense.clear();
+                m_Dense.insert(m_Dense.end(), other.m_Dense.begin(), other.m_Dense.end());
+            } else {
+                throw std::logic_error(std::string("ECS: snapshot of move-only component ") + typeid(T).name()
+                                       + " needs Registry::SetCopyHook");
+            }
+        }
+    }
+
+    // Above this many out-of-order neighbours Sort falls back to stable_sort
+    static constexpr size_t kInsertionSortDescents = 32;
+
+    // order[k] = current dense index (relative to base) of the element that
+    // belongs at base + k. Every swap puts one element at its final position.
+    void ApplyOrder(const std::vector<uint32_t>& order, uint32_t base = 0) {
+        std::vector<uint32_t> destination(order.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            destination[order[k]] = static_cast<uint32_t>(k);
+        }
+        for (uint32_t i = 0; i < destination.size(); ++i) {
+            while (destination[i] != i) {
+                const uint32_t target = destination[i];
+                SwapDense(base + i, base + target);
+                std::swap(destination[i], destination[target]);
+            }
+        }
+    }
+
+    // Sparse index is paged so a single high entity index only costs one page
+    static constexpr uint32_t kSparsePageSize = 4096;
+    using SparsePage = std::unique_ptr<uint32_t[]>;
+
+    uint32_t& SparseSlot(uint32_t idx) {
+        const uint32_t page = idx / kSparsePageSize;
+        if (page >= m_SparsePages.size()) {
+            m_SparsePages.resize(page + 1);
+        }
+        if (!m_SparsePages[page]) {
+            m_SparsePages[page] = std::make_unique<uint32_t[]>(kSparsePageSize);
+            std::fill_n(m_SparsePages[page].get(), kSparsePageSize, detail::kInvalidSparse);
+        }
+        return m_SparsePages[page][idx % kSparsePageSize];
+    }
+
+    std::conditional_t<kIsTag, detail::TagStorage<T>, std::vector<T>> m_Dense;
+    std::vector<Entity> m_Entities;
+    std::vector<uint32_t> m_AddedTicks;
+    std::vector<uint32_t> m_ChangedTicks;
+    std::vector<SparsePage> m_SparsePages;
+    OnRemoveCallback m_OnRemove;
+    CopyHook m_CopyHook;
+};
+
+// =========================================================
+// Archetype storage (optional backend, see StorageMode)
+// =========================================================
+// SparseSet: one pool per component type (default; cheap add/remove, random
+// access through the sparse index).
+// Archetype: entities with the same component set share a table of 16KB
+// chunks with one column per component (SoA). Iteration is a linear walk
+// over matching chunks; adding or removing a component moves the entity's
+// row to another table.
+enum class StorageMode {
+    SparseSet,
+    Archetype
+};
+
+namespace detail {
+    constexpr size_t kArchetypeChunkBytes = 16 * 1024;
+    constexpr size_t kChunkAlignment = 64;
+
+    // Type-erased operations on one component type (one archetype column)
+    struct ColumnType {
+        uint32_t typeId = 0;
+        uint32_t size = 0; // 0 for tags: no storage, no ticks
+        uint32_t align = 1;
+        void* tagInstance = nullptr;
+        void (*relocate)(void* dst, void* src) = nullptr; // move-construct into dst, destroy src
+        void (*destroy)(void* object) = nullptr;
+    };
+
+    template<typename T>
+    const ColumnType* ColumnTypeOf() {
+        static const ColumnType type = [] {
+            ColumnType column;
+            column.typeId = GetComponentTypeID<T>();
+            if constexpr (std::is_empty_v<T>) {
+                column.tagInstance = &TagStorage<T>::instance;
+            } else {
+                column.size = static_cast<uint32_t>(sizeof(T));
+                column.align = static_cast<uint32_t>(alignof(T));
+                column.relocate = [](void* dst, void* src) {
+                    new (dst) T(std::move(*static_cast<T*>(src)));
+                    static_cast<T*>(src)->~T();
+                };
+                column.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+            }
+            return column;
+        }();
+        return &type;
+    }
+
+    // Entities with exactly one component set. Row r lives in chunk
+    // r / ChunkCapacity(); inside a chunk the entity ids come first, then per
+    // column its values, added ticks and changed ticks.
+    class Archetype {
+    public:
+        static constexpr int32_t kNoColumn = -1;
+
+        Archetype(const ComponentMask& mask, std::vector<const ColumnType*> columns)
+            : m_Mask(mask), m_Columns(std::move(columns)) {
+            std::sort(m_Columns.begin(), m_Columns.end(),
+                      [](const ColumnType* a, const ColumnType* b) { return a->typeId < b->typeId; });
+            for (size_t c = 0; c < m_Columns.size(); ++c) {
+                const uint32_t typeId = m_Columns[c]->typeId;
+                if (typeId >= m_ColumnIndex.size()) m_ColumnIndex.resize(typeId + 1, kNoColumn);
+                m_ColumnIndex[typeId] = static_cast<int32_t>(c);
+            }
+            ComputeLayout();
+        }
+
+        ~Archetype() {
+            DestroyRows();
+            for (std::byte* chunk : m_Chunks) FreeChunk(chunk);
+        }
+
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        const ComponentMask& Mask() const { return m_Mask; }
+        const std::vector<const ColumnType*>& Columns() const { return m_Columns; }
+        size_t Size() const { return m_Size; }
+        uint32_t ChunkCapacity() const { return m_Capacity; }
+        size_t ChunkCount() const { return (m_Size + m_Capacity - 1) / m_Capacity; }
+        uint32_t RowsInChunk(size_t chunk) const {
+            return static_cast<uint32_t>(std::min<size_t>(m_Capacity, m_Size - chunk * m_Capacity));
+        }
+        size_t AllocatedBytes() const { return m_Chunks.size() * m_ChunkBytes; }
+
+        int32_t ColumnOf(uint32_t typeId) const {
+            return typeId < m_ColumnIndex.size() ? m_ColumnIndex[typeId] : kNoColumn;
+        }
+
+        Entity* Entities(size_t chunk) { return reinterpret_cast<Entity*>(m_Chunks[chunk]); }
+        void* Column(size_t chunk, int32_t column) {
+            const ColumnType& type = *m_Columns[column];
+            return type.size ? m_Chunks[chunk] + m_Offsets[column].data : type.tagInstance;
+        }
+        uint32_t* AddedTicks(size_t chunk, int32_t column) {
+            return m_Columns[column]->size ? reinterpret_cast<uint32_t*>(m_Chunks[chunk] + m_Offsets[column].added) : nullptr;
+        }
+        uint32_t* ChangedTicks(size_t chunk, int32_t column) {
+            return m_Columns[column]->size ? reinterpret_cast<uint32_t*>(m_Chunks[chunk] + m_Offsets[column].changed) : nullptr;
+        }
+
+        void* At(uint32_t row, int32_t column) {
+            const ColumnType& type = *m_Columns[column];
+            if (!type.size) return type.tagInstance;
+            return m_Chunks[row / m_Capacity] + m_Offsets[column].data + size_t(row % m_Capacity) * type.size;
+        }
+        uint32_t& AddedTick(uint32_t row, int32_t column) { return AddedTicks(row / m_Capacity, column)[row % m_Capacity]; }
+        uint32_t& ChangedTick(uint32_t row, int32_t column) { return ChangedTicks(row / m_Capacity, column)[row % m_Capacity]; }
+        Entity EntityAt(uint32_t row) { return Entities(row / m_Capacity)[row % m_Capacity]; }
+
+        // New row with uninitialised columns; the caller constructs every one
+        uint32_t PushRow(Entity e) {
+            const uint32_t row = static_cast<uint32_t>(m_Size);
+            if (row / m_Capacity == m_Chunks.size()) {
+                m_Chunks.push_back(AllocateChunk());
+            }
+            Entities(row / m_Capacity)[row % m_Capacity] = e;
+            ++m_Size;
+            return row;
+        }
+
+        // Move column `column` of `row` into `dstRow` of dst (ticks included)
+        void MoveCell(uint32_t row, int32_t column, Archetype& dst, uint32_t dstRow, int32_t dstColumn) {
+            const ColumnType& type = *m_Columns[column];
+            if (!type.size) return;
+            type.relocate(dst.At(dstRow, dstColumn), At(row, column));
+            dst.AddedTick(dstRow, dstColumn) = AddedTick(row, column);
+            dst.ChangedTick(dstRow, dstColumn) = ChangedTick(row, column);
+        }
+
+        void DestroyCell(uint32_t row, int32_t column) {
+            if (m_Columns[column]->size) m_Columns[column]->destroy(At(row, column));
+        }
+
+        // Every cell of row has been destroyed or moved out: move the last row
+        // into the hole. Returns the entity that moved (kInvalidEntity if none).
+        Entity FillHole(uint32_t row) {
+            const uint32_t last = static_cast<uint32_t>(m_Size - 1);
+            Entity moved = kInvalidEntity;
+            if (row != last) {
+                for (size_t c = 0; c < m_Columns.size(); ++c) {
+                    MoveCell(last, static_cast<int32_t>(c), *this, row, static_cast<int32_t>(c));
+                }
+                moved = EntityAt(last);
+                Entities(row / m_Capacity)[row % m_Capacity] = moved;
+            }
+            --m_Size;
+            return moved;
+        }
+
+        Entity EraseRow(uint32_t row) {
+            for (size_t c = 0; c < m_Columns.size(); ++c) DestroyCell(row, static_cast<int32_t>(c));
+            return FillHole(row);
+        }
+
+        void Clear() {
+            DestroyRows();
+            m_Size = 0;
+        }
+
+        // Free chunks left empty by removals
+        void Compact() {
+            const size_t used = ChunkCount();
+            for (size_t i = used; i < m_Chunks.size(); ++i) FreeChunk(m_Chunks[i]);
+            m_Chunks.resize(used);
+            m_Chunks.shrink_to_fit();
+        }
+
+        // Edge cache: archetype reached by adding/removing one component
+        std::vector<std::pair<uint32_t, uint32_t>> addEdges;
+        std::vector<std::pair<uint32_t, uint32_t>> removeEdges;
+
+    private:
+        struct ColumnOffsets {
+            size_t data = 0;
+            size_t added = 0;
+            size_t changed = 0;
+        };
+
+        static size_t AlignUp(size_t value, size_t align) { return (value + align - 1) / align * align; }
+
+        size_t LayoutBytes(uint32_t capacity, std::vector<ColumnOffsets>* offsets) const {
+            size_t bytes = sizeof(Entity) * capacity;
+            for (const ColumnType* type : m_Columns) {
+                ColumnOffsets column;
+                if (type->size) {
+                    column.data = bytes = AlignUp(bytes, type->align);
+                    bytes += size_t(type->size) * capacity;
+                    column.added = bytes = AlignUp(bytes, alignof(uint32_t));
+                    bytes += sizeof(uint32_t) * capacity;
+                    column.changed = bytes;
+                    bytes += sizeof(uint32_t) * capacity;
+                }
+                if (offsets) offsets->push_back(column);
+            }
+            return bytes;
+        }
+
+        void ComputeLayout() {
+            size_t rowBytes = sizeof(Entity);
+            for (const ColumnType* type : m_Columns) {
+                if (type->size) rowBytes += type->size + 2 * sizeof(uint32_t);
+            }
+            uint32_t capacity = static_cast<uint32_t>(std::max<size_t>(1, kArchetypeChunkBytes / rowBytes));
+            // Alignment padding can push the estimate over the chunk size
+            while (capacity > 1 && LayoutBytes(capacity, nullptr) > kArchetypeChunkBytes) {
+                --capacity;
+            }
+            m_Capacity = capacity;
+            m_ChunkBytes = AlignUp(std::max(LayoutBytes(capacity, &m_Offsets), sizeof(Entity)), kChunkAlignment);
+        }
+
+        std::byte* AllocateChunk() const {
+            return static_cast<std::byte*>(::operator new(m_ChunkBytes, std::align_val_t{kChunkAlignment}));
+        }
+
+        static void FreeChunk(std::byte* chunk) {
+            ::operator delete(chunk, std::align_val_t{kChunkAlignment});
+        }
+
+        void DestroyRows() {
+            for (uint32_t row = 0; row < m_Size; ++row) {
+                for (size_t c = 0; c < m_Columns.size(); ++c) DestroyCell(row, static_cast<int32_t>(c));
+            }
+        }
+
+        ComponentMask m_Mask;
+        std::vector<const ColumnType*> m_Columns; // sorted by type id
+        std::vector<int32_t> m_ColumnIndex;       // type id -> column
+        std::vector<ColumnOffsets> m_Offsets;
+        std::vector<std::byte*> m_Chunks;
+        uint32_t m_Capacity = 1;
+        size_t m_ChunkBytes = 0;
+        size_t m_Size = 0;
+    };
+} // namespace detail
+
+// =========================================================
+// Deferred structural changes
+// =========================================================
+class Registry;
+
+// Records create/destroy/add/remove for later playback. Structural changes
+// are not safe while a pool is being iterated (swap-remove); systems record
+// them here and the scheduler plays them back at sync points.
+// A buffer is not thread-safe: use one per thread (Registry::Deferred()).
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+    ~CommandBuffer() { Clear(); }
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // Provisional handle, usable with Add/Remove/Destroy of this buffer.
+    // It is replaced by a real entity on playback.
+    Entity Create() {
+        detail::CountStructural();
+        const Entity provisional = detail::Encode(++m_CreateCount, 0);
+        m_Commands.push_back({Kind::Create, AccessViolation::kAnyComponent, provisional, nullptr, nullptr, nullptr});
+        return provisional;
+    }
+
+    void Destroy(Entity e) {
+        detail::CountStructural();
+        m_Commands.push_back({Kind::Destroy, AccessViolation::kAnyComponent, e, nullptr, nullptr, nullptr});
+    }
+
+    template<typename T, typename... Args>
+    void Add(Entity e, Args&&... args) {
+        detail::CountStructural();
+        void* payload = Allocate(sizeof(T), alignof(T));
+        new (payload) T(std::forward<Args>(args)...);
+        DestroyFn destroy = nullptr;
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+        }
+        m_Commands.push_back({Kind::Add, detail::GetComponentTypeID<T>(), e, payload, &ApplyAdd<T>, destroy});
+    }
+
+    template<typename T>
+    void Remove(Entity e) {
+        detail::CountStructural();
+        m_Commands.push_back({Kind::Remove, detail::GetComponentTypeID<T>(), e, nullptr, &ApplyRemove<T>, nullptr});
+    }
+
+    bool Empty() const { return m_Commands.empty(); }
+    size_t Size() const { return m_Commands.size(); }
+
+    // Drop all recorded commands (arena blocks are kept for reuse)
+    void Clear() {
+        for (auto& cmd : m_Commands) {
+            if (cmd.destroy) cmd.destroy(cmd.payload);
+        }
+        m_Commands.clear();
+        m_CreateCount = 0;
+        m_BlockIndex = 0;
+        m_BlockOffset = 0;
+    }
+
+    void Swap(CommandBuffer& other) noexcept {
+        std::swap(m_Commands, other.m_Commands);
+        std::swap(m_Blocks, other.m_Blocks);
+        std::swap(m_BlockIndex, other.m_BlockIndex);
+        std::swap(m_BlockOffset, other.m_BlockOffset);
+        std::swap(m_CreateCount, other.m_CreateCount);
+    }
+
+    // Apply and clear; same as Registry::FlushCommands for a single buffer
+    inline void Playback(Registry& registry);
+
+private:
+    friend class Registry;
+
+    enum class Kind : uint8_t { Create, Add, Remove, Destroy };
+    using ApplyFn = void (*)(Registry&, Entity, void*);
+    using DestroyFn = void (*)(void*);
+
+    struct Command {
+        Kind kind;
+        uint32_t typeId;
+        Entity entity;
+        void* payload;
+        ApplyFn apply;
+        DestroyFn destroy;
+    };
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    static constexpr size_t kBlockSize = 16 * 1024;
+
+    static bool IsProvisional(Entity e) {
+        return detail::DecodeVersion(e) == 0 && detail::DecodeIndex(e) != 0;
+    }
+
+    // Payloads never move once written: blocks are not reallocated
+    void* Allocate(size_t size, size_t align) {
+        for (;;) {
+            if (m_BlockIndex < m_Blocks.size()) {
+                Block& block = m_Blocks[m_BlockIndex];
+                const size_t offset = (m_BlockOffset + align - 1) & ~(align - 1);
+                if (offset + size <= block.size) {
+                    m_BlockOffset = offset + size;
+                    return block.data.get() + offset;
+                }
+                if (m_BlockIndex + 1 < m_Blocks.size() || m_BlockOffset != 0) {
+                    ++m_BlockIndex;
+                    m_BlockOffset = 0;
+                    continue;
+                }
+            }
+            const size_t blockSize = std::max(kBlockSize, size + align);
+            m_Blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+            m_BlockIndex = m_Blocks.size() - 1;
+            m_BlockOffset = 0;
+        }
+    }
+
+    template<typename T>
+    static void ApplyAdd(Registry& registry, Entity e, void* payload);
+
+    template<typename T>
+    static void ApplyRemove(Registry& registry, Entity e, void* payload);
+
+    std::vector<Command> m_Commands;
+    std::vector<Block> m_Blocks;
+    size_t m_BlockIndex = 0;
+    size_t m_BlockOffset = 0;
+    uint32_t m_CreateCount = 0;
+};
+
+// =========================================================
+// Query terms
+// =========================================================
+// ForEach<Terms...> takes components and filters:
+//   T              - passed as T&, stamps the slot as changed
+//   const T        - passed as const T&, read only
+//   Added<T>       - filter: T was added since the system last ran (no argument)
+//   Changed<T>     - filter: T was added or written since the system last ran
+//   With<Cs...>    - filter: the entity has every C (no argument)
+//   Without<Cs...> - filter: the entity has none of Cs (no argument)
+//   Optional<T>    - passed as T* (const T* for Optional<const T>), nullptr
+//                    when the entity lacks T
+// With and Without are resolved on the component signature (one mask test
+// per entity, or per archetype), not with per-type lookups.
+template<typename T> struct Added {};
+template<typename T> struct Changed {};
+template<typename... Cs> struct With {};
+template<typename... Cs> struct Without {};
+template<typename T> struct Optional {};
+
+namespace detail {
+    // Single-component forms With/Without expand to
+    template<typename T> struct WithOne {};
+    template<typename T> struct WithoutOne {};
+
+    template<typename... Terms> struct TermList {};
+
+    template<typename Done, typename... Terms>
+    struct ExpandTermsImpl { using type = Done; };
+    template<typename... Done, typename T, typename... Rest>
+    struct ExpandTermsImpl<TermList<Done...>, T, Rest...> : ExpandTermsImpl<TermList<Done..., T>, Rest...> {};
+    template<typename... Done, typename... Cs, typename... Rest>
+    struct ExpandTermsImpl<TermList<Done...>, With<Cs...>, Rest...>
+        : ExpandTermsImpl<TermList<Done..., WithOne<Cs>...>, Rest...> {};
+    template<typename... Done, typename... Cs, typename... Rest>
+    struct ExpandTermsImpl<TermList<Done...>, Without<Cs...>, Rest...>
+        : ExpandTermsImpl<TermList<Done..., WithoutOne<Cs>...>, Rest...> {};
+
+    // Every term of the list refers to exactly one component type
+    template<typename... Terms>
+    using ExpandTerms = typename ExpandTermsImpl<TermList<>, Terms...>::type;
+
+    // Required: the entity must have the component. Excluded: must not.
+    // Optional: looked up if present.
+    enum class TermRole { Required, Excluded, Optional };
+
+    // Per term: the component it refers to, how it takes part in matching,
+    // the per-entity tick test (Accept), the change stamp and the argument
+    // passed to fn. Tick arrays and data are nullptr where the entity or
+    // archetype has no such component.
+    template<typename T>
+    struct QueryTerm {
+        using Component = std::remove_const_t<T>;
+        static constexpr TermRole kRole = TermRole::Required;
+        static constexpr bool kPlain = true;  // argument only (owning group fast path)
+        static constexpr bool kFilter = false;
+        static constexpr bool kNeedsIndex = !std::is_empty_v<Component>;
+        static constexpr bool kStamps = !std::is_const_v<T> && !std::is_empty_v<Component>;
+        static constexpr bool kWrites = kStamps; // checked against SystemAccess::CanWrite
+        static bool Accept(const uint32_t*, const uint32_t*, size_t, uint32_t) { return true; }
+        static void Stamp(uint32_t* changed, size_t index, uint32_t tick) {
+            if constexpr (kStamps) StoreTick(changed[index], tick);
+        }
+        static std::tuple<T&> Arg(Component* data, size_t index) { return std::tuple<T&>(DenseAt(data, index)); }
+    };
+
+    // Shared by the argument-less terms
+    template<typename T, TermRole Role, bool Filter>
+    struct FilterTerm {
+        using Component = T;
+        static constexpr TermRole kRole = Role;
+        static constexpr bool kPlain = false;
+        static constexpr bool kFilter = Filter;
+        static constexpr bool kNeedsIndex = Filter;
+        static constexpr bool kWrites = false;
+        static bool Accept(const uint32_t*, const uint32_t*, size_t, uint32_t) { return true; }
+        static void Stamp(uint32_t*, size_t, uint32_t) {}
+        static std::tuple<> Arg(Component*, size_t) { return {}; }
+    };
+
+    template<typename T>
+    struct QueryTerm<Added<T>> : FilterTerm<T, TermRole::Required, true> {
+        static_assert(!std::is_empty_v<T>, "Tag components carry no change ticks");
+        static bool Accept(const uint32_t* added, const uint32_t*, size_t index, uint32_t since) {
+            return LoadTick(added[index]) > since;
+        }
+    };
+
+    template<typename T>
+    struct QueryTerm<Changed<T>> : FilterTerm<T, TermRole::Required, true> {
+        static_assert(!std::is_empty_v<T>, "Tag components carry no change ticks");
+        static bool Accept(const uint32_t*, const uint32_t* changed, size_t index, uint32_t since) {
+            return LoadTick(changed[index]) > since;
+        }
+    };
+
+    template<typename T>
+    struct QueryTerm<WithOne<T>> : FilterTerm<std::remove_const_t<T>, TermRole::Required, false> {};
+
+    template<typename T>
+    struct QueryTerm<WithoutOne<T>> : FilterTerm<std::remove_const_t<T>, TermRole::Excluded, false> {};
+
+    template<typename T>
+    struct QueryTerm<Optional<T>> {
+        using Component = std::remove_const_t<T>;
+        static constexpr TermRole kRole = TermRole::Optional;
+        static constexpr bool kPlain = false;
+        static constexpr bool kFilter = false;
+        static constexpr bool kNeedsIndex = true;
+        static constexpr bool kStamps = !std::is_const_v<T> && !std::is_empty_v<Component>;
+        static constexpr bool kWrites = kStamps;
+        static bool Accept(const uint32_t*, const uint32_t*, size_t, uint32_t) { return true; }
+        static void Stamp(uint32_t* changed, size_t index, uint32_t tick) {
+            if constexpr (kStamps) {
+                if (changed && index != kInvalidSparse) StoreTick(changed[index], tick);
+            }
+        }
+        static std::tuple<T*> Arg(Component* data, size_t index) {
+            return std::tuple<T*>(data ? &DenseAt(data, index) : nullptr);
+        }
+    };
+
+    template<typename T>
+    using QueryComponent = typename QueryTerm<T>::Component;
+
+    // Tick context of the system running on this thread (set by SystemScheduler)
+    struct TickContext {
+        const void* registry = nullptr;
+        uint32_t current = 0;
+        uint32_t lastRun = 0;
+    };
+
+    inline thread_local TickContext tl_Ticks;
+
+    // Carries a system's tick, access and profiling context onto a worker thread
+    struct SystemContextGuard {
+        TickContext previousTicks;
+        AccessScope* previousScope;
+        SystemCounters* previousCounters;
+
+        SystemContextGuard(const TickContext& ticks, AccessScope* scope, SystemCounters* counters)
+            : previousTicks(tl_Ticks), previousScope(tl_AccessScope), previousCounters(tl_Counters) {
+            tl_Ticks = ticks;
+            tl_AccessScope = scope;
+            tl_Counters = counters;
+        }
+        ~SystemContextGuard() {
+            tl_Ticks = previousTicks;
+            tl_AccessScope = previousScope;
+            tl_Counters = previousCounters;
+        }
+
+        SystemContextGuard(const SystemContextGuard&) = delete;
+        SystemContextGuard& operator=(const SystemContextGuard&) = delete;
+    };
+} // namespace detail
+
+// Iteration handle for an owning group created by Registry::Group
+template<typename... Cs>
+class OwningGroup {
+public:
+    OwningGroup() = default;
+    OwningGroup(detail::GroupData* data, Registry* registry)
+        : m_Data(data), m_Registry(registry) {}
+
+    size_t Size() const { return m_Data ? m_Data->size : 0; }
+    bool Contains(Entity e) const { return m_Data && m_Data->Holds(e); }
+
+    // Straight walk over the packed front of every owned pool
+    template<typename Fn>
+    void Each(Fn&& fn);
+
+private:
+    detail::GroupData* m_Data = nullptr;
+    Registry* m_Registry = nullptr;
+};
+
+// =========================================================
+// Snapshots
+// =========================================================
+// Frozen copy of a registry's entities and pools (Registry::Snapshot).
+// Read-only once taken, so it can be restored into another registry on a
+// worker thread (e.g. to serialise an autosave) while the game goes on.
+class RegistrySnapshot {
+public:
+    size_t AliveCount() const { return m_AliveCount; }
+    bool Empty() const { return m_Entities.empty(); }
+
+private:
+    friend class Registry;
+
+    std::vector<EntityData> m_Entities;
+    std::vector<uint32_t> m_FreeList;
+    size_t m_AliveCount = 0;
+    std::vector<std::unique_ptr<IPool>> m_Pools; // by component type id
+};
+
+// =========================================================
+// Registry / World
+// =========================================================
+class Registry {
+public:
+    explicit Registry(StorageMode mode = StorageMode::SparseSet) : m_Mode(mode), m_Id(NextId()) {
+        // Reserve index 0 as invalid
+        m_Entities.push_back({});
+        // Archetype 0: the empty component set (holds no rows)
+        m_Archetypes.push_back(std::make_unique<detail::Archetype>(ComponentMask{}, std::vector<const detail::ColumnType*>{}));
+    }
+
+    StorageMode GetStorageMode() const { return m_Mode; }
+
+    // Unique per constructed registry (never 0), unlike its address, which a
+    // registry rebuilt in place (scene reload) shares with the old one
+    uint64_t GetId() const { return m_Id; }
+
+    // Switch backends; only while no entity has components
+    void SetStorageMode(StorageMode mode) {
+        for (const EntityData& data : m_Entities) {
+            if (data.alive && data.components.Any()) {
+                throw std::logic_error("ECS: storage mode can only change while no entity has components");
+            }
+        }
+        m_Mode = mode;
+    }
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    Entity CreateEntity() {
+        detail::CheckStructural(AccessViolation::kAnyComponent);
+        uint32_t index = 0;
+        if (!m_FreeList.empty()) {
+            index = m_FreeList.back();
+            m_FreeList.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_Entities.size());
+            m_Entities.push_back({});
+        }
+
+        EntityData& data = m_Entities[index];
+        data.alive = true;
+        Entity e = detail::Encode(index, data.version);
+        ++m_AliveCount;
+        return e;
+    }
+
+    // Create count entities at once (clamped to out.size()); recycled slots are
+    // used first, the entity table grows once for the rest
+    void CreateEntities(size_t count, std::span<Entity> out) {
+        detail::CheckStructural(AccessViolation::kAnyComponent);
+        count = std::min(count, out.size());
+        const size_t recycled = std::min(count, m_FreeList.size());
+        const size_t fresh = count - recycled;
+        m_Entities.reserve(m_Entities.size() + fresh);
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = 0;
+            if (i < recycled) {
+                index = m_FreeList.back();
+                m_FreeList.pop_back();
+            } else {
+                index = static_cast<uint32_t>(m_Entities.size());
+                m_Entities.push_back({});
+            }
+            EntityData& data = m_Entities[index];
+            data.alive = true;
+            out[i] = detail::Encode(index, data.version);
+        }
+        m_AliveCount += count;
+    }
+
+    bool IsAlive(Entity e) const {
+        const uint32_t idx = detail::DecodeIndex(e);
+        if (idx >= m_Entities.size()) {
+            return false;
+        }
+        const EntityData& data = m_Entities[idx];
+        return data.alive && data.version == detail::DecodeVersion(e);
+    }
+
+    void DestroyEntity(Entity e) {
+        if (!IsAlive(e)) {
+            return;
+        }
+        detail::CheckStructural(AccessViolation::kAnyComponent);
+
+        for (auto& group : m_Groups) {
+            group->Leave(e);
+        }
+
+        const uint32_t idx = detail::DecodeIndex(e);
+        if (m_Mode == StorageMode::Archetype) {
+            ArchetypeDestroy(e);
+        } else {
+            // Only visit the pools the entity is actually in. Copy the mask:
+            // remove callbacks may touch the entity's other components.
+            const ComponentMask owned = m_Entities[idx].components;
+            owned.ForEachSet([this, e](uint32_t typeId) {
+                if (typeId < m_Pools.size() && m_Pools[typeId]) RemoveFromPool(*m_Pools[typeId], e);
+            });
+            if (owned.untracked) {
+                for (size_t typeId = ComponentMask::kBits; typeId < m_Pools.size(); ++typeId) {
+                    if (m_Pools[typeId]) RemoveFromPool(*m_Pools[typeId], e);
+                }
+            }
+        }
+
+        EntityData& data = m_Entities[idx];
+        data.components.Clear();
+        data.alive = false;
+        ++data.version; // invalidate stale handles
+        m_FreeList.push_back(idx);
+        if (m_AliveCount > 0) {
+            --m_AliveCount;
+        }
+    }
+
+    void Destroy(Entity e) {
+        DestroyEntity(e);
+    }
+
+    void Clear() {
+        detail::CheckStructural(AccessViolation::kAnyComponent);
+        if (m_Mode == StorageMode::Archetype) {
+            for (Entity e : AliveEntities()) {
+                PublishArchetypeDestroy(e);
+            }
+            for (auto& archetype : m_Archetypes) {
+                archetype->Clear();
+            }
+        }
+        for (auto& pool : m_Pools) {
+            if (!pool) continue;
+            if (!pool->onDestroy.Empty()) {
+                // Copy: listeners may remove other components of the same entity
+                const std::vector<Entity> entities = pool->Entities();
+                for (Entity e : entities) {
+                    if (pool->Contains(e)) pool->onDestroy.Publish(*this, e);
+                }
+            }
+            pool->Clear();
+        }
+        // Do not clear m_Pools vector to preserve allocated pools
+        for (auto& group : m_Groups) {
+            group->size = 0;
+        }
+        
+        m_Entities.clear();
+        m_FreeList.clear();
+        m_AliveCount = 0;
+
+        // Recorded commands refer to entities that no longer exist
+        std::lock_guard<std::mutex> lock(m_Deferred->mutex);
+        for (auto& entry : m_Deferred->buffers) {
+            entry.buffer->Clear();
+        }
+        
+        // Reserve index 0 as invalid
+        m_Entities.push_back({});
+    }
+
+    size_t AliveCount() const { return m_AliveCount; }
+
+    // =====================================================
+    // Context: one instance per type of world-wide state (active camera,
+    // physics world, input snapshot...). Lookup is an index into a vector.
+    // Survives Clear(); systems that use it declare the type in Access()
+    // with ReadCtx/WriteCtx.
+    // =====================================================
+
+    // Create or replace the instance of T
+    template<typename T, typename... Args>
+    T& EmplaceCtx(Args&&... args) {
+        const uint32_t id = detail::GetContextTypeID<T>();
+        if (id >= m_Context.size()) {
+            m_Context.resize(id + 1);
+        }
+        auto value = std::make_shared<T>(std::forward<Args>(args)...);
+        T& ref = *value;
+        m_Context[id] = std::move(value);
+        return ref;
+    }
+
+    // Instance of T, default-constructed on first use
+    template<typename T>
+    T& Ctx() {
+        if (T* value = FindCtx<T>()) {
+            return *value;
+        }
+        return EmplaceCtx<T>();
+    }
+
+    template<typename T>
+    T* FindCtx() {
+        const uint32_t id = detail::GetContextTypeID<T>();
+        return id < m_Context.size() ? static_cast<T*>(m_Context[id].get()) : nullptr;
+    }
+
+    template<typename T>
+    const T* FindCtx() const {
+        const uint32_t id = detail::GetContextTypeID<T>();
+        return id < m_Context.size() ? static_cast<const T*>(m_Context[id].get()) : nullptr;
+    }
+
+    template<typename T>
+    void EraseCtx() {
+        const uint32_t id = detail::GetContextTypeID<T>();
+        if (id < m_Context.size()) {
+            m_Context[id].reset();
+        }
+    }
+
+    // Number of entities that have T
+    template<typename T>
+    size_t Count() const {
+        if (m_Mode == StorageMode::Archetype) {
+            const uint32_t typeId = detail::GetComponentTypeID<T>();
+            size_t count = 0;
+            for (const auto& archetype : m_Archetypes) {
+                if (archetype->Mask().Test(typeId)) count += archetype->Size();
+            }
+            return count;
+        }
+        const auto* pool = GetPool<T>();
+        return pool ? pool->Size() : 0;
+    }
+
+    // Free empty sparse pages and spare dense capacity in every pool
+    // (archetype storage: chunks emptied by removals)
+    void Compact() {
+        for (auto& pool : m_Pools) {
+            if (pool) pool->Compact();
+        }
+        for (auto& archetype : m_Archetypes) {
+            archetype->Compact();
+        }
+        m_FreeList.shrink_to_fit();
+    }
+
+    // =====================================================
+    // Snapshots: the entity table, free list and every pool copied in bulk.
+    // Used for rollback and replays, resetting a level without rebuilding it,
+    // and saving from a frozen copy. Context, signals and group definitions
+    // stay with the registry; Restore publishes no signals. Restoring into
+    // another registry clones the world. Sparse-set storage only.
+    // =====================================================
+
+    // Copy used for T instead of memcpy/copy constructor, e.g. to deep-copy
+    // a shared_ptr member so the snapshot does not alias live data
+    template<typename T>
+    void SetCopyHook(typename ComponentPool<T>::CopyHook hook) {
+        GetOrCreatePool<T>().SetCopyHook(std::move(hook));
+    }
+
+    RegistrySnapshot Snapshot() const {
+        RequireSparseSet("Snapshot");
+        RegistrySnapshot snapshot;
+        snapshot.m_Entities = m_Entities;
+        snapshot.m_FreeList = m_FreeList;
+        snapshot.m_AliveCount = m_AliveCount;
+        snapshot.m_Pools.resize(m_Pools.size());
+        for (size_t typeId = 0; typeId < m_Pools.size(); ++typeId) {
+            if (m_Pools[typeId]) snapshot.m_Pools[typeId] = m_Pools[typeId]->Clone();
+        }
+        return snapshot;
+    }
+
+    // Replace every entity and component with the snapshot's. Pools created
+    // after the snapshot are emptied; pending deferred commands are dropped.
+    void Restore(const RegistrySnapshot& snapshot) {
+        detail::CheckStructural(AccessViolation::kAnyComponent);
+        RequireSparseSet("Restore");
+        if (snapshot.Empty()) {
+            throw std::logic_error("ECS: Restore from an empty snapshot");
+        }
+        m_Entities = snapshot.m_Entities;
+        m_FreeList = snapshot.m_FreeList;
+        m_AliveCount = snapshot.m_AliveCount;
+
+        if (snapshot.m_Pools.size() > m_Pools.size()) {
+            m_Pools.resize(snapshot.m_Pools.size());
+        }
+        for (size_t typeId = 0; typeId < m_Pools.size(); ++typeId) {
+            const IPool* source = typeId < snapshot.m_Pools.size() ? snapshot.m_Pools[typeId].get() : nullptr;
+            if (!source) {
+                if (m_Pools[typeId]) m_Pools[typeId]->Reset();
+            } else if (m_Pools[typeId]) {
+                m_Pools[typeId]->CopyFrom(*source);
+            } else {
+                m_Pools[typeId] = source->Clone();
+            }
+        }
+
+        // Pools arrive in snapshot order: re-pack every group (already packed
+        // members are swapped with themselves)
+        for (auto& group : m_Groups) {
+            group->size = 0;
+            const std::vector<Entity>& members = group->pools.front()->Entities();
+            for (size_t i = 0; i < members.size(); ++i) {
+                group->Enter(members[i]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Deferred->mutex);
+        for (auto& entry : m_Deferred->buffers) {
+            entry.buffer->Clear();
+        }
+    }
+
+    // Archetype storage: number of component sets in use and chunk memory
+    size_t ArchetypeCount() const {
+        return static_cast<size_t>(std::count_if(m_Archetypes.begin(), m_Archetypes.end(),
+                                                 [](const auto& archetype) { return archetype->Size() > 0; }));
+    }
+
+    size_t ArchetypeChunkBytes() const {
+        size_t bytes = 0;
+        for (const auto& archetype : m_Archetypes) bytes += archetype->AllocatedBytes();
+        return bytes;
+    }
+
+    struct PoolMemoryReport {
+        uint32_t typeId = 0;
+        const char* typeName = "";
+        PoolMemoryStats stats;
+    };
+
+    // Per-pool memory usage (sparse, dense, total) for tracking in production
+    std::vector<PoolMemoryReport> GetMemoryReport() const {
+        std::vector<PoolMemoryReport> report;
+        for (size_t typeId = 0; typeId < m_Pools.size(); ++typeId) {
+            if (m_Pools[typeId]) {
+                report.push_back({static_cast<uint32_t>(typeId), m_Pools[typeId]->TypeName(), m_Pools[typeId]->MemoryStats()});
+            }
+        }
+        return report;
+    }
+
+    template<typename T>
+    PoolMemoryStats GetPoolMemoryStats() const {
+        const auto* pool = GetPool<T>();
+        return pool ? pool->MemoryStats() : PoolMemoryStats{};
+    }
+
+    // Command buffer of the calling thread. Safe to use from parallel systems;
+    // recorded changes are applied by FlushCommands() (the scheduler does this
+    // at its sync points).
+    CommandBuffer& Deferred() {
+        struct Cache {
+            const Registry* owner = nullptr;
+            uint64_t serial = 0;
+            CommandBuffer* buffer = nullptr;
+        };
+        thread_local Cache cache;
+        if (cache.owner == this && cache.serial == m_Serial) {
+            return *cache.buffer;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Deferred->mutex);
+        const auto thread = std::this_thread::get_id();
+        CommandBuffer* buffer = nullptr;
+        for (auto& entry : m_Deferred->buffers) {
+            if (entry.thread == thread) buffer = entry.buffer.get();
+        }
+        if (!buffer) {
+            m_Deferred->buffers.push_back({thread, std::make_unique<CommandBuffer>()});
+            buffer = m_Deferred->buffers.back().buffer.get();
+        }
+        cache = {this, m_Serial, buffer};
+        return *buffer;
+    }
+
+    bool HasPendingCommands() const {
+        std::lock_guard<std::mutex> lock(m_Deferred->mutex);
+        for (const auto& entry : m_Deferred->buffers) {
+            if (!entry.buffer->Empty()) return true;
+        }
+        return false;
+    }
+
+    // Apply every thread's deferred commands in one batch
+    void FlushCommands() {
+        std::vector<CommandBuffer> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_Deferred->mutex);
+            pending = std::vector<CommandBuffer>(m_Deferred->buffers.size());
+            for (size_t i = 0; i < pending.size(); ++i) {
+                pending[i].Swap(*m_Deferred->buffers[i].buffer);
+            }
+        }
+        Playback(pending.data(), pending.size());
+    }
+
+    // Apply buffers and clear them. Creates run first (in recording order),
+    // then adds/removes grouped by pool so each pool is touched once, then
+    // destroys. Commands recorded during playback land in fresh buffers.
+    void Playback(CommandBuffer* buffers, size_t count) {
+        struct Ref {
+            uint32_t order;
+            uint32_t typeId;
+            uint32_t buffer;
+            uint32_t command;
+        };
+
+        std::vector<std::vector<Entity>> created(count);
+        std::vector<Ref> refs;
+        for (size_t b = 0; b < count; ++b) {
+            auto& commands = buffers[b].m_Commands;
+            created[b].resize(buffers[b].m_CreateCount + 1, kInvalidEntity);
+            for (size_t c = 0; c < commands.size(); ++c) {
+                const auto& cmd = commands[c];
+                if (cmd.kind == CommandBuffer::Kind::Create) {
+                    created[b][detail::DecodeIndex(cmd.entity)] = CreateEntity();
+                    continue;
+                }
+                const uint32_t order = cmd.kind == CommandBuffer::Kind::Destroy ? 1u : 0u;
+                refs.push_back({order, cmd.typeId, static_cast<uint32_t>(b), static_cast<uint32_t>(c)});
+            }
+        }
+
+        std::stable_sort(refs.begin(), refs.end(), [](const Ref& a, const Ref& b) {
+            if (a.order != b.order) return a.order < b.order;
+            return a.typeId < b.typeId;
+        });
+
+        for (const Ref& ref : refs) {
+            const auto& cmd = buffers[ref.buffer].m_Commands[ref.command];
+            Entity e = cmd.entity;
+            if (CommandBuffer::IsProvisional(e)) {
+                const uint32_t index = detail::DecodeIndex(e);
+                const auto& table = created[ref.buffer];
+                e = index < table.size() ? table[index] : kInvalidEntity;
+            }
+            if (!IsAlive(e)) {
+                continue;
+            }
+            if (cmd.kind == CommandBuffer::Kind::Destroy) {
+                DestroyEntity(e);
+            } else {
+                cmd.apply(*this, e, cmd.payload);
+            }
+        }
+
+        for (size_t b = 0; b < count; ++b) {
+            buffers[b].Clear();
+        }
+    }
+
+    void ForEachEntity(std::function<void(Entity)> fn) {
+        for (size_t i = 1; i < m_Entities.size(); ++i) {
+            if (m_Entities[i].alive) {
+                Entity e = detail::Encode(static_cast<uint32_t>(i), m_Entities[i].version);
+                fn(e);
             }
         }
     }
@@ -258,151 +1923,917 @@ public:
 
     template<typename T>
     void SetOnComponentRemoved(ComponentCallback<T> cb) {
+        RequireSparseSet("SetOnComponentRemoved (use OnDestroy)");
         GetOrCreatePool<T>().SetOnRemove(std::move(cb));
     }
 
     template<typename T, typename... Args>
-    T& Add(Entity e, Args&&... args) {
-        static_assert(std::is_default_constructible_v<T> || sizeof...(Args) > 0, "Component must be constructible");
-        auto& pool = GetOrCreatePool<T>();
-        if (pool.Contains(e)) {
-            return *pool.Get(e);
+    T& Add(Entity e, Args&&... args) {
+        static_assert(std::is_default_constructible_v<T> || sizeof...(Args) > 0, "Component must be constructible");
+        detail::CheckStructural(detail::GetComponentTypeID<T>());
+        if (m_Mode == StorageMode::Archetype) {
+            return ArchetypeAdd<T>(e, std::forward<Args>(args)...);
+        }
+        auto& pool = GetOrCreatePool<T>();
+        const uint32_t tick = CurrentTick();
+        if (const uint32_t existing = pool.IndexOf(e); existing != detail::kInvalidSparse) {
+            if constexpr (!ComponentPool<T>::kIsTag) detail::StoreTick(pool.ChangedTicks()[existing], tick);
+            return pool.At(existing);
+        }
+        T& component = pool.Emplace(e, std::forward<Args>(args)...);
+        if constexpr (!ComponentPool<T>::kIsTag) {
+            pool.AddedTicks()[pool.Size() - 1] = tick;
+            pool.ChangedTicks()[pool.Size() - 1] = tick;
+        }
+        if (IsAlive(e)) {
+            m_Entities[detail::DecodeIndex(e)].components.Set(detail::GetComponentTypeID<T>());
+        }
+        if (pool.ownerGroup) {
+            // Entering the group moves the new component into the packed range
+            pool.ownerGroup->Enter(e);
+        }
+        if (!pool.onConstruct.Empty()) {
+            pool.onConstruct.Publish(*this, e);
+        }
+        // Group moves and listeners may have relocated the component
+        return pool.ownerGroup || !pool.onConstruct.Empty() ? *pool.Get(e) : component;
+    }
+
+    // =====================================================
+    // Signals: listeners get (Registry&, Entity).
+    //   OnConstruct - after T is added (Add, Insert)
+    //   OnUpdate    - after Patch, MarkChanged or an Insert over an existing T
+    //   OnDestroy   - before T is removed (Remove, DestroyEntity, Clear)
+    // Listeners must not add or remove T itself.
+    // =====================================================
+    template<typename T>
+    ComponentSignal& OnConstruct() { return GetOrCreatePool<T>().onConstruct; }
+
+    template<typename T>
+    ComponentSignal& OnUpdate() { return GetOrCreatePool<T>().onUpdate; }
+
+    template<typename T>
+    ComponentSignal& OnDestroy() { return GetOrCreatePool<T>().onDestroy; }
+
+    // Bulk Add: values[i] goes to entities[i] (entities that already have T are
+    // overwritten). Pool storage and sparse pages are reserved once up front.
+    template<typename T>
+    void Insert(std::span<const Entity> entities, std::span<const T> values) {
+        const size_t count = std::min(entities.size(), values.size());
+        InsertWith<T>(entities.first(count), [&values](size_t i) -> const T& { return values[i]; });
+    }
+
+    // Bulk Add of the same value to every entity
+    template<typename T>
+    void Insert(std::span<const Entity> entities, const T& value = T{}) {
+        InsertWith<T>(entities, [&value](size_t) -> const T& { return value; });
+    }
+
+    template<typename T>
+    bool Has(Entity e) const {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        if (ComponentMask::Tracks(typeId)) {
+            detail::CheckAccess(typeId);
+            return IsAlive(e) && m_Entities[detail::DecodeIndex(e)].components.Test(typeId);
+        }
+        const auto* pool = GetPool<T>();
+        return pool && pool->Contains(e);
+    }
+
+    // Component signature of a live entity (nullptr for stale handles)
+    const ComponentMask* GetComponentMask(Entity e) const {
+        return IsAlive(e) ? &m_Entities[detail::DecodeIndex(e)].components : nullptr;
+    }
+
+    // Mutable access: stamps the component as changed (see Changed<T>)
+    template<typename T>
+    T* Get(Entity e) {
+        if (m_Mode == StorageMode::Archetype) {
+            return ArchetypeGet<T>(e, true);
+        }
+        auto* pool = GetPool<T>();
+        if (!pool) {
+            return nullptr;
+        }
+        const uint32_t denseIndex = pool->IndexOf(e);
+        if (denseIndex == detail::kInvalidSparse) {
+            return nullptr;
+        }
+        if constexpr (!ComponentPool<T>::kIsTag) {
+            detail::StoreTick(pool->ChangedTicks()[denseIndex], CurrentTick());
+        }
+        return &pool->At(denseIndex);
+    }
+
+    template<typename T>
+    const T* Get(Entity e) const {
+        if (m_Mode == StorageMode::Archetype) {
+            return const_cast<Registry*>(this)->ArchetypeGet<T>(e, false);
+        }
+        const auto* pool = GetPool<T>();
+        return pool ? pool->Get(e) : nullptr;
+    }
+
+    // =====================================================
+    // Change detection
+    // =====================================================
+    // Every slot carries the tick it was added and last written at. Writes are
+    // stamped by Add, non-const Get, Patch, MarkChanged and ForEach over
+    // non-const T. Inside a scheduled system the tick is unique to that run and
+    // Added<T>/Changed<T> compare against the system's previous run; outside
+    // the scheduler they compare against the last ClearChangeTracking().
+    // Writes through a pointer kept across frames need MarkChanged.
+
+    uint32_t CurrentTick() const {
+        const detail::TickContext& ctx = detail::tl_Ticks;
+        return ctx.registry == this ? ctx.current : m_Tick.load(std::memory_order_relaxed);
+    }
+
+    uint32_t LastRunTick() const {
+        const detail::TickContext& ctx = detail::tl_Ticks;
+        return ctx.registry == this ? ctx.lastRun : m_ExternalLastRun;
+    }
+
+    // Take the current tick and open a newer one for later writes
+    // (used by SystemScheduler for every system run)
+    uint32_t AdvanceTick() {
+        return m_Tick.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Outside the scheduler: changes made so far no longer match Added/Changed
+    void ClearChangeTracking() {
+        m_ExternalLastRun = AdvanceTick();
+    }
+
+    // Modify a component in place and stamp it as changed
+    template<typename T, typename Fn>
+    bool Patch(Entity e, Fn&& fn) {
+        T* component = Get<T>(e);
+        if (!component) {
+            return false;
+        }
+        fn(*component);
+        PublishUpdate<T>(e);
+        return true;
+    }
+
+    template<typename T>
+    void MarkChanged(Entity e) {
+        if (Get<T>(e)) {
+            PublishUpdate<T>(e);
+        }
+    }
+
+    template<typename T>
+    ComponentTicks GetTicks(Entity e) const {
+        if (m_Mode == StorageMode::Archetype) {
+            if constexpr (std::is_empty_v<T>) {
+                return {};
+            } else {
+                return const_cast<Registry*>(this)->ArchetypeTicks<T>(e);
+            }
+        }
+        const auto* pool = GetPool<T>();
+        return pool ? pool->GetTicks(e) : ComponentTicks{};
+    }
+
+    template<typename T>
+    bool IsAdded(Entity e) const {
+        return GetTicks<T>(e).added > LastRunTick();
+    }
+
+    template<typename T>
+    bool IsChanged(Entity e) const {
+        return GetTicks<T>(e).changed > LastRunTick();
+    }
+
+    template<typename T>
+    void Remove(Entity e) {
+        detail::CheckStructural(detail::GetComponentTypeID<T>());
+        if (m_Mode == StorageMode::Archetype) {
+            ArchetypeRemove<T>(e);
+            return;
+        }
+        auto* pool = FindPool<T>();
+        if (pool) {
+            if (!pool->onDestroy.Empty() && pool->Contains(e)) {
+                pool->onDestroy.Publish(*this, e);
+            }
+            if (pool->ownerGroup) {
+                pool->ownerGroup->Leave(e);
+            }
+            pool->Remove(e);
+            if (IsAlive(e)) {
+                m_Entities[detail::DecodeIndex(e)].components.Reset(detail::GetComponentTypeID<T>());
+            }
+        }
+    }
+
+    // Create (or fetch) an owning group. Entities with all of Cs are kept
+    // packed at the front of each pool so iteration is a linear walk over
+    // parallel arrays; ForEach<Cs...> uses the group automatically.
+    // A pool can be owned by one group only.
+    template<typename... Cs>
+    OwningGroup<Cs...> Group() {
+        static_assert(sizeof...(Cs) > 1, "Group requires at least two components");
+        detail::CheckStructural(AccessViolation::kAnyComponent);
+        RequireSparseSet("Group");
+
+        std::vector<IPool*> pools{&GetOrCreatePool<Cs>()...};
+
+        detail::GroupData* existing = pools.front()->ownerGroup;
+        if (existing && existing->pools.size() == pools.size()
+            && std::all_of(pools.begin(), pools.end(), [existing](IPool* p) { return p->ownerGroup == existing; })) {
+            return OwningGroup<Cs...>(existing, this);
+        }
+        for (IPool* pool : pools) {
+            if (pool->ownerGroup) {
+                throw std::logic_error("ECS: component pool is already owned by another group");
+            }
+        }
+
+        auto data = std::make_unique<detail::GroupData>();
+        data->pools = pools;
+        for (IPool* pool : pools) {
+            pool->ownerGroup = data.get();
+        }
+
+        IPool* smallest = *std::min_element(pools.begin(), pools.end(),
+            [](IPool* a, IPool* b) { return a->Size() < b->Size(); });
+        // Copy: Enter() reorders the pool being walked
+        const std::vector<Entity> candidates = smallest->Entities();
+        for (Entity e : candidates) {
+            data->Enter(e);
+        }
+
+        detail::GroupData* raw = data.get();
+        m_Groups.push_back(std::move(data));
+        return OwningGroup<Cs...>(raw, this);
+    }
+
+    // Reorder T's pool in place (stable). Iteration over T then follows the
+    // order. Pools owned by a group keep the group's order and cannot be sorted.
+    template<typename T, typename Compare>
+    void Sort(Compare comp) {
+        if (auto* pool = GetSortablePool<T>()) pool->Sort(comp);
+    }
+
+    // Cheaper variant for unsigned integer keys (radix sort). A [begin, end)
+    // slice of the pool's iteration order can be sorted on its own, to spread
+    // the re-sorting of a large pool over several frames.
+    template<typename T, typename KeyFn>
+    void SortByKey(KeyFn keyOf, size_t begin = 0, size_t end = static_cast<size_t>(-1)) {
+        if (auto* pool = GetSortablePool<T>()) pool->SortByKey(keyOf, begin, end);
+    }
+
+    // Give U's pool the order of T's pool: entities that have both come first,
+    // in T's order; the rest follow
+    template<typename U, typename T>
+    void SortAs() {
+        auto* pool = GetSortablePool<U>();
+        const auto* reference = std::as_const(*this).template GetPool<T>();
+        if (!pool || !reference) {
+            return;
+        }
+        uint32_t next = 0;
+        for (Entity e : reference->Entities()) {
+            const uint32_t index = pool->IndexOf(e);
+            if (index != detail::kInvalidSparse) {
+                pool->SwapDense(index, next++);
+            }
+        }
+    }
+
+    // Iterate entities with a required component set (see Query terms)
+    template<typename... Terms, typename Fn>
+    void ForEach(Fn&& fn) {
+        RunForEach(fn, 0, detail::ExpandTerms<Terms...>{});
+    }
+
+    // Worker pool for ParallelForEach (nullptr: it runs like ForEach)
+    void SetJobSystem(JobSystem* jobs) { m_Jobs = jobs; }
+    JobSystem* GetJobSystem() const { return m_Jobs; }
+
+    static constexpr size_t kDefaultGrainSize = 1024;
+
+    // ForEach split into chunks of the driving pool's dense range and run on
+    // the job system; the calling thread works too and returns when all chunks
+    // are done. fn runs concurrently: it may write the components it is given
+    // and record structural changes through Deferred(), nothing else.
+    template<typename... Terms, typename Fn>
+    void ParallelForEach(Fn&& fn, size_t grainSize = kDefaultGrainSize) {
+        RunForEach(fn, std::max<size_t>(grainSize, 1), detail::ExpandTerms<Terms...>{});
+    }
+
+    // View API for cleaner iteration
+    template<typename... Components>
+    auto View() {
+        return [this](auto func) {
+            this->ForEach<Components...>(func);
+        };
+    }
+
+private:
+    static uint64_t NextId() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Mutable pool for writes through it (access-checked as a write)
+    template<typename T>
+    ComponentPool<T>* GetPool() {
+        detail::CheckAccess(detail::GetComponentTypeID<T>(), true);
+        return FindPool<T>();
+    }
+
+    // Unchecked lookup for bookkeeping whose access the caller has checked
+    template<typename T>
+    ComponentPool<T>* FindPool() {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        if (typeId >= m_Pools.size() || !m_Pools[typeId]) {
+            return nullptr;
+        }
+        return static_cast<ComponentPool<T>*>(m_Pools[typeId].get());
+    }
+
+    template<typename T>
+    const ComponentPool<T>* GetPool() const {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        detail::CheckAccess(typeId);
+        if (typeId >= m_Pools.size() || !m_Pools[typeId]) {
+            return nullptr;
+        }
+        return static_cast<const ComponentPool<T>*>(m_Pools[typeId].get());
+    }
+
+    template<typename T>
+    ComponentPool<T>& GetOrCreatePool() {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        if (typeId >= m_Pools.size()) {
+            m_Pools.resize(typeId + 1);
+        }
+        if (!m_Pools[typeId]) {
+            m_Pools[typeId] = std::make_unique<ComponentPool<T>>();
+        }
+        return *static_cast<ComponentPool<T>*>(m_Pools[typeId].get());
+    }
+
+    // Group owning exactly the pools of Cs, if one exists
+    template<typename First, typename... Rest>
+    detail::GroupData* FindGroup() {
+        auto* first = FindPool<First>();
+        if (!first || !first->ownerGroup) {
+            return nullptr;
+        }
+        detail::GroupData* group = first->ownerGroup;
+        if (group->pools.size() != 1 + sizeof...(Rest)) {
+            return nullptr;
+        }
+        const bool ownsAll = ((FindPool<Rest>() && FindPool<Rest>()->ownerGroup == group) && ...);
+        return ownsAll ? group : nullptr;
+    }
+
+    void RequireSparseSet(const char* feature) const {
+        if (m_Mode != StorageMode::SparseSet) {
+            throw std::logic_error(std::string("ECS: ") + feature + " needs sparse-set storage");
+        }
+    }
+
+    std::vector<Entity> AliveEntities() const {
+        std::vector<Entity> alive;
+        alive.reserve(m_AliveCount);
+        for (uint32_t idx = 1; idx < m_Entities.size(); ++idx) {
+            if (m_Entities[idx].alive) alive.push_back(detail::Encode(idx, m_Entities[idx].version));
+        }
+        return alive;
+    }
+
+    // ----- Archetype storage -----
+
+    static void RequireTracked(uint32_t typeId) {
+        if (!ComponentMask::Tracks(typeId)) {
+            throw std::logic_error("ECS: archetype storage supports up to ComponentMask::kBits component types");
+        }
+    }
+
+    // Archetype with `mask`, created from `columns` if it does not exist yet
+    uint32_t FindOrCreateArchetype(const ComponentMask& mask, std::vector<const detail::ColumnType*> columns) {
+        for (uint32_t i = 0; i < m_Archetypes.size(); ++i) {
+            if (m_Archetypes[i]->Mask() == mask) return i;
+        }
+        m_Archetypes.push_back(std::make_unique<detail::Archetype>(mask, std::move(columns)));
+        return static_cast<uint32_t>(m_Archetypes.size() - 1);
+    }
+
+    uint32_t ArchetypeWith(uint32_t from, const detail::ColumnType* added) {
+        detail::Archetype& source = *m_Archetypes[from];
+        for (const auto& [typeId, target] : source.addEdges) {
+            if (typeId == added->typeId) return target;
+        }
+        ComponentMask mask = source.Mask();
+        mask.Set(added->typeId);
+        std::vector<const detail::ColumnType*> columns = source.Columns();
+        columns.push_back(added);
+        const uint32_t target = FindOrCreateArchetype(mask, std::move(columns));
+        m_Archetypes[from]->addEdges.emplace_back(added->typeId, target);
+        return target;
+    }
+
+    uint32_t ArchetypeWithout(uint32_t from, uint32_t removedType) {
+        detail::Archetype& source = *m_Archetypes[from];
+        for (const auto& [typeId, target] : source.removeEdges) {
+            if (typeId == removedType) return target;
+        }
+        ComponentMask mask = source.Mask();
+        mask.Reset(removedType);
+        std::vector<const detail::ColumnType*> columns;
+        for (const detail::ColumnType* column : source.Columns()) {
+            if (column->typeId != removedType) columns.push_back(column);
+        }
+        const uint32_t target = FindOrCreateArchetype(mask, std::move(columns));
+        m_Archetypes[from]->removeEdges.emplace_back(removedType, target);
+        return target;
+    }
+
+    // Move e's row to `target`: shared columns are relocated, columns the
+    // target lacks are destroyed. Columns new in the target stay uninitialised.
+    void MoveToArchetype(Entity e, uint32_t target) {
+        EntityData& data = m_Entities[detail::DecodeIndex(e)];
+        detail::Archetype& destination = *m_Archetypes[target];
+        const uint32_t row = target != 0 ? destination.PushRow(e) : 0;
+        if (data.archetype != 0) {
+            detail::Archetype& source = *m_Archetypes[data.archetype];
+            const auto& columns = source.Columns();
+            for (size_t c = 0; c < columns.size(); ++c) {
+                const int32_t column = static_cast<int32_t>(c);
+                const int32_t destColumn = destination.ColumnOf(columns[c]->typeId);
+                if (destColumn != detail::Archetype::kNoColumn) {
+                    source.MoveCell(data.row, column, destination, row, destColumn);
+                } else {
+                    source.DestroyCell(data.row, column);
+                }
+            }
+            if (const Entity moved = source.FillHole(data.row); moved != kInvalidEntity) {
+                m_Entities[detail::DecodeIndex(moved)].row = data.row;
+            }
+        }
+        data.archetype = target;
+        data.row = row;
+    }
+
+    template<typename T>
+    T* ArchetypeGet(Entity e, bool stamp) {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        detail::CheckAccess(typeId, stamp);
+        if (!IsAlive(e)) {
+            return nullptr;
+        }
+        const EntityData& data = m_Entities[detail::DecodeIndex(e)];
+        if (!data.components.Test(typeId)) {
+            return nullptr;
+        }
+        detail::Archetype& archetype = *m_Archetypes[data.archetype];
+        const int32_t column = archetype.ColumnOf(typeId);
+        if constexpr (!std::is_empty_v<T>) {
+            if (stamp) detail::StoreTick(archetype.ChangedTick(data.row, column), CurrentTick());
+        }
+        return static_cast<T*>(archetype.At(data.row, column));
+    }
+
+    template<typename T>
+    ComponentTicks ArchetypeTicks(Entity e) {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        if (!IsAlive(e) || !m_Entities[detail::DecodeIndex(e)].components.Test(typeId)) {
+            return {};
+        }
+        const EntityData& data = m_Entities[detail::DecodeIndex(e)];
+        detail::Archetype& archetype = *m_Archetypes[data.archetype];
+        const int32_t column = archetype.ColumnOf(typeId);
+        return {detail::LoadTick(archetype.AddedTick(data.row, column)), detail::LoadTick(archetype.ChangedTick(data.row, column))};
+    }
+
+    template<typename T, typename... Args>
+    T& ArchetypeAdd(Entity e, Args&&... args) {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        RequireTracked(typeId);
+        if (!IsAlive(e)) {
+            throw std::logic_error("ECS: Add on a destroyed entity");
+        }
+        auto& pool = GetOrCreatePool<T>(); // carries the signals
+        if (T* existing = ArchetypeGet<T>(e, true)) {
+            return *existing;
+        }
+
+        // Constructed first so a throwing constructor leaves the entity untouched
+        T value(std::forward<Args>(args)...);
+        EntityData& data = m_Entities[detail::DecodeIndex(e)];
+        MoveToArchetype(e, ArchetypeWith(data.archetype, detail::ColumnTypeOf<T>()));
+        detail::Archetype& archetype = *m_Archetypes[data.archetype];
+        const int32_t column = archetype.ColumnOf(typeId);
+        T* component = static_cast<T*>(archetype.At(data.row, column));
+        if constexpr (!std::is_empty_v<T>) {
+            new (component) T(std::move(value));
+            const uint32_t tick = CurrentTick();
+            archetype.AddedTick(data.row, column) = tick;
+            archetype.ChangedTick(data.row, column) = tick;
+        }
+        data.components.Set(typeId);
+
+        if (!pool.onConstruct.Empty()) {
+            pool.onConstruct.Publish(*this, e);
+            // Listeners may have moved the entity to another archetype
+            return *ArchetypeGet<T>(e, false);
         }
-        return pool.Emplace(e, std::forward<Args>(args)...);
+        return *component;
     }
 
     template<typename T>
-    bool Has(Entity e) const {
-        const auto* pool = GetPool<T>();
-        return pool && pool->Contains(e);
+    void ArchetypeRemove(Entity e) {
+        const uint32_t typeId = detail::GetComponentTypeID<T>();
+        if (!IsAlive(e) || !m_Entities[detail::DecodeIndex(e)].components.Test(typeId)) {
+            return;
+        }
+        if (auto* pool = FindPool<T>(); pool && !pool->onDestroy.Empty()) {
+            pool->onDestroy.Publish(*this, e);
+            if (!Has<T>(e)) return;
+        }
+        EntityData& data = m_Entities[detail::DecodeIndex(e)];
+        MoveToArchetype(e, ArchetypeWithout(data.archetype, typeId));
+        data.components.Reset(typeId);
     }
 
-    template<typename T>
-    T* Get(Entity e) {
-        auto* pool = GetPool<T>();
-        return pool ? pool->Get(e) : nullptr;
+    void PublishArchetypeDestroy(Entity e) {
+        const ComponentMask owned = m_Entities[detail::DecodeIndex(e)].components;
+        owned.ForEachSet([this, e](uint32_t typeId) {
+            IPool* pool = typeId < m_Pools.size() ? m_Pools[typeId].get() : nullptr;
+            if (pool && !pool->onDestroy.Empty() && m_Entities[detail::DecodeIndex(e)].components.Test(typeId)) {
+                pool->onDestroy.Publish(*this, e);
+            }
+        });
     }
 
-    template<typename T>
-    const T* Get(Entity e) const {
-        const auto* pool = GetPool<T>();
-        return pool ? pool->Get(e) : nullptr;
+    void ArchetypeDestroy(Entity e) {
+        PublishArchetypeDestroy(e);
+        EntityData& data = m_Entities[detail::DecodeIndex(e)];
+        if (data.archetype != 0) {
+            if (const Entity moved = m_Archetypes[data.archetype]->EraseRow(data.row); moved != kInvalidEntity) {
+                m_Entities[detail::DecodeIndex(moved)].row = data.row;
+            }
+        }
+        data.archetype = 0;
+        data.row = 0;
     }
 
-    template<typename T>
-    void Remove(Entity e) {
-        auto* pool = GetPool<T>();
-        if (pool) {
-            pool->Remove(e);
+    // ForEach (grainSize 0) and ParallelForEach over the expanded terms
+    template<typename Fn, typename... Terms>
+    void RunForEach(Fn& fn, size_t grainSize, detail::TermList<Terms...>) {
+        if (m_Mode == StorageMode::Archetype) {
+            ArchetypeForEach<Terms...>(fn, grainSize);
+            return;
+        }
+        QueryState<Terms...> query;
+        if (!PrepareQuery(query)) {
+            return;
+        }
+        if (grainSize == 0 || !m_Jobs || m_Jobs->GetWorkerCount() == 0 || query.count <= grainSize) {
+            detail::CountEntities(RunQuery(query, fn, 0, query.count));
+            return;
         }
+
+        // Chunks on workers act on behalf of the calling system
+        const detail::TickContext ticks = detail::tl_Ticks;
+        detail::AccessScope* scope = detail::tl_AccessScope;
+        detail::SystemCounters* counters = detail::tl_Counters;
+        m_Jobs->ParallelFor(query.count, grainSize, [&](size_t begin, size_t end) {
+            const detail::SystemContextGuard guard(ticks, scope, counters);
+            detail::CountEntities(RunQuery(query, fn, begin, end));
+        });
     }
 
-    // Iterate entities with a required component set
-    template<typename... Components, typename Fn>
-    void ForEach(Fn&& fn) {
-        static_assert(sizeof...(Components) > 0, "ForEach requires at least one component");
+    // Required and excluded signature of a term list
+    template<typename... Terms>
+    static void TermMasks(ComponentMask& required, ComponentMask& excluded) {
+        auto add = [&](uint32_t typeId, detail::TermRole role) {
+            if (role == detail::TermRole::Required) required.Set(typeId);
+            else if (role == detail::TermRole::Excluded) excluded.Set(typeId);
+        };
+        (add(detail::GetComponentTypeID<detail::QueryComponent<Terms>>(), detail::QueryTerm<Terms>::kRole), ...);
+    }
 
-        auto* smallest = GetSmallestPool<Components...>();
-        if (!smallest) {
-            return;
+    // ForEach over matching archetypes. grainSize > 0: chunks are spread over
+    // the job system (ParallelForEach).
+    template<typename... Terms, typename Fn>
+    void ArchetypeForEach(Fn& fn, size_t grainSize) {
+        static_assert(((detail::QueryTerm<Terms>::kRole == detail::TermRole::Required) || ...),
+                      "ForEach requires at least one required component");
+        (detail::CheckAccess(detail::GetComponentTypeID<detail::QueryComponent<Terms>>(), detail::QueryTerm<Terms>::kWrites), ...);
+        ComponentMask required;
+        ComponentMask excluded;
+        TermMasks<Terms...>(required, excluded);
+        const uint32_t tick = CurrentTick();
+        const uint32_t since = LastRunTick();
+
+        struct Work {
+            detail::Archetype* archetype;
+            size_t chunk;
+        };
+        std::vector<Work> work;
+        size_t rows = 0;
+        for (auto& archetype : m_Archetypes) {
+            if (archetype->Size() == 0 || !archetype->Mask().ContainsAll(required)
+                || archetype->Mask().Intersects(excluded)) {
+                continue;
+            }
+            for (size_t chunk = 0; chunk < archetype->ChunkCount(); ++chunk) {
+                work.push_back({archetype.get(), chunk});
+            }
+            rows += archetype->Size();
         }
 
-        const auto& entities = smallest->Entities();
-        for (Entity e : entities) {
-            // Check if entity is still valid (might have been destroyed during iteration if not careful, 
-            // but generally we assume alive in pool implies alive in registry unless deferred)
-            // However, pool might contain stale entities if we don't sync perfectly, 
-            // but our DestroyEntity removes from all pools immediately.
-            
-            if (HasAll<Components...>(e)) {
-                fn(e, *Get<Components>(e)...);
+        auto runChunks = [&](size_t begin, size_t end) {
+            size_t visited = 0;
+            for (size_t i = begin; i < end; ++i) {
+                visited += RunArchetypeChunk<Terms...>(fn, *work[i].archetype, work[i].chunk, tick, since);
             }
+            detail::CountEntities(visited);
+        };
+        if (grainSize == 0 || !m_Jobs || m_Jobs->GetWorkerCount() == 0 || rows <= grainSize) {
+            runChunks(0, work.size());
+            return;
         }
+        // Grain in rows -> grain in chunks
+        const size_t chunksPerJob = std::max<size_t>(1, grainSize * work.size() / rows);
+        const detail::TickContext ticks = detail::tl_Ticks;
+        detail::AccessScope* scope = detail::tl_AccessScope;
+        detail::SystemCounters* counters = detail::tl_Counters;
+        m_Jobs->ParallelFor(work.size(), chunksPerJob, [&](size_t begin, size_t end) {
+            const detail::SystemContextGuard guard(ticks, scope, counters);
+            runChunks(begin, end);
+        });
     }
 
-    // View API for cleaner iteration
-    template<typename... Components>
-    auto View() {
-        return [this](auto func) {
-            this->ForEach<Components...>(func);
-        };
+    // Returns the number of rows passed to fn
+    template<typename... Terms, typename Fn>
+    static size_t RunArchetypeChunk(Fn& fn, detail::Archetype& archetype, size_t chunk, uint32_t tick, uint32_t since) {
+        constexpr size_t kCount = sizeof...(Terms);
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            // Excluded and missing optional components have no column
+            constexpr int32_t kNone = detail::Archetype::kNoColumn;
+            const std::array<int32_t, kCount> column{
+                archetype.ColumnOf(detail::GetComponentTypeID<detail::QueryComponent<Terms>>())...};
+            const std::tuple<detail::QueryComponent<Terms>*...> data{static_cast<detail::QueryComponent<Terms>*>(
+                column[I] != kNone ? archetype.Column(chunk, column[I]) : nullptr)...};
+            const std::array<uint32_t*, kCount> added{
+                (column[I] != kNone ? archetype.AddedTicks(chunk, column[I]) : nullptr)...};
+            const std::array<uint32_t*, kCount> changed{
+                (column[I] != kNone ? archetype.ChangedTicks(chunk, column[I]) : nullptr)...};
+            const Entity* entities = archetype.Entities(chunk);
+            const uint32_t rows = archetype.RowsInChunk(chunk);
+            size_t visited = 0;
+            for (uint32_t i = 0; i < rows; ++i) {
+                if constexpr ((detail::QueryTerm<Terms>::kFilter || ...)) {
+                    if (!(detail::QueryTerm<Terms>::Accept(added[I], changed[I], i, since) && ...)) continue;
+                }
+                (detail::QueryTerm<Terms>::Stamp(changed[I], i, tick), ...);
+                std::apply([&](auto&&... args) { fn(entities[i], std::forward<decltype(args)>(args)...); },
+                           std::tuple_cat(detail::QueryTerm<Terms>::Arg(std::get<I>(data), i)...));
+                ++visited;
+            }
+            return visited;
+        }(std::make_index_sequence<kCount>{});
     }
 
-private:
     template<typename T>
-    ComponentPool<T>* GetPool() {
-        const uint32_t typeId = detail::GetComponentTypeID<T>();
-        if (typeId >= m_Pools.size() || !m_Pools[typeId]) {
-            return nullptr;
+    ComponentPool<T>* GetSortablePool() {
+        RequireSparseSet("Sort");
+        auto* pool = GetPool<T>();
+        if (pool && pool->ownerGroup) {
+            throw std::logic_error("ECS: cannot sort a component pool owned by a group");
         }
-        return static_cast<ComponentPool<T>*>(m_Pools[typeId].get());
+        return pool;
     }
 
-    template<typename T>
-    const ComponentPool<T>* GetPool() const {
+    template<typename T, typename ValueAt>
+    void InsertWith(std::span<const Entity> entities, ValueAt&& valueAt) {
+        detail::CheckStructural(detail::GetComponentTypeID<T>());
+        if (m_Mode == StorageMode::Archetype) {
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if (T* existing = ArchetypeGet<T>(entities[i], true)) {
+                    *existing = valueAt(i);
+                    PublishUpdate<T>(entities[i]);
+                } else {
+                    ArchetypeAdd<T>(entities[i], valueAt(i));
+                }
+            }
+            return;
+        }
+        auto& pool = GetOrCreatePool<T>();
         const uint32_t typeId = detail::GetComponentTypeID<T>();
-        if (typeId >= m_Pools.size() || !m_Pools[typeId]) {
-            return nullptr;
+        const uint32_t tick = CurrentTick();
+
+        uint32_t maxIndex = 0;
+        for (Entity e : entities) {
+            maxIndex = std::max(maxIndex, detail::DecodeIndex(e));
+        }
+        pool.Reserve(entities.size(), maxIndex);
+
+        for (size_t i = 0; i < entities.size(); ++i) {
+            const Entity e = entities[i];
+            if (const uint32_t existing = pool.IndexOf(e); existing != detail::kInvalidSparse) {
+                pool.At(existing) = valueAt(i);
+                if constexpr (!ComponentPool<T>::kIsTag) detail::StoreTick(pool.ChangedTicks()[existing], tick);
+                if (!pool.onUpdate.Empty()) pool.onUpdate.Publish(*this, e);
+                continue;
+            }
+            pool.Emplace(e, valueAt(i));
+            if constexpr (!ComponentPool<T>::kIsTag) {
+                pool.AddedTicks()[pool.Size() - 1] = tick;
+                pool.ChangedTicks()[pool.Size() - 1] = tick;
+            }
+            if (IsAlive(e)) {
+                m_Entities[detail::DecodeIndex(e)].components.Set(typeId);
+            }
+            if (pool.ownerGroup) {
+                pool.ownerGroup->Enter(e);
+            }
+            if (!pool.onConstruct.Empty()) {
+                pool.onConstruct.Publish(*this, e);
+            }
         }
-        return static_cast<const ComponentPool<T>*>(m_Pools[typeId].get());
     }
 
     template<typename T>
-    ComponentPool<T>& GetOrCreatePool() {
-        const uint32_t typeId = detail::GetComponentTypeID<T>();
-        if (typeId >= m_Pools.size()) {
-            m_Pools.resize(typeId + 1);
-        }
-        if (!m_Pools[typeId]) {
-            m_Pools[typeId] = std::make_unique<ComponentPool<T>>();
+    void PublishUpdate(Entity e) {
+        auto* pool = FindPool<T>();
+        if (pool && !pool->onUpdate.Empty()) {
+            pool->onUpdate.Publish(*this, e);
         }
-        return *static_cast<ComponentPool<T>*>(m_Pools[typeId].get());
     }
 
-    template<typename T>
-    bool HasOne(Entity e) const {
-        return Has<T>(e);
+    void RemoveFromPool(IPool& pool, Entity e) {
+        if (!pool.onDestroy.Empty() && pool.Contains(e)) {
+            pool.onDestroy.Publish(*this, e);
+        }
+        pool.Remove(e);
     }
 
-    template<typename T, typename U, typename... Rest>
-    bool HasOne(Entity e) const {
-        return Has<T>(e) && HasOne<U, Rest...>(e);
+    // Resolved pools and driving range of one ForEach/ParallelForEach call.
+    // Pools of excluded and optional terms may be missing (nullptr).
+    template<typename... Terms>
+    struct QueryState {
+        std::tuple<ComponentPool<detail::QueryComponent<Terms>>*...> pools;
+        const Entity* entities = nullptr;
+        const IPool* driver = nullptr; // pool whose dense range is walked
+        size_t count = 0;
+        bool packed = false; // owning group: the same dense index in every pool
+        ComponentMask required;
+        ComponentMask excluded;
+        uint32_t tick = 0;
+        uint32_t since = 0;
+    };
+
+    template<typename... Terms>
+    bool PrepareQuery(QueryState<Terms...>& query) {
+        static_assert(((detail::QueryTerm<Terms>::kRole == detail::TermRole::Required) || ...),
+                      "ForEach requires at least one required component");
+        constexpr size_t kCount = sizeof...(Terms);
+
+        // Resolve pools once instead of per entity
+        (detail::CheckAccess(detail::GetComponentTypeID<detail::QueryComponent<Terms>>(), detail::QueryTerm<Terms>::kWrites), ...);
+        query.pools = {FindPool<detail::QueryComponent<Terms>>()...};
+        const std::array<IPool*, kCount> pools = std::apply([](auto*... pool) {
+            return std::array<IPool*, kCount>{pool...};
+        }, query.pools);
+        constexpr std::array<detail::TermRole, kCount> roles{detail::QueryTerm<Terms>::kRole...};
+
+        // Drive the loop with the smallest required pool; a missing one means no match
+        IPool* smallest = nullptr;
+        for (size_t i = 0; i < kCount; ++i) {
+            if (roles[i] != detail::TermRole::Required) continue;
+            if (!pools[i]) return false;
+            if (!smallest || pools[i]->Size() < smallest->Size()) smallest = pools[i];
+        }
+        query.tick = CurrentTick();
+        query.since = LastRunTick();
+
+        if constexpr (kCount > 1 && (detail::QueryTerm<Terms>::kPlain && ...)) {
+            if (detail::GroupData* group = FindGroup<detail::QueryComponent<Terms>...>()) {
+                query.entities = std::get<0>(query.pools)->Entities().data();
+                query.count = group->size;
+                query.packed = true;
+                return true;
+            }
+        }
+
+        query.entities = smallest->Entities().data();
+        query.driver = smallest;
+        query.count = smallest->Size();
+        TermMasks<Terms...>(query.required, query.excluded);
+        return true;
     }
 
-    template<typename... Cs>
-    bool HasAll(Entity e) const {
-        return HasOne<Cs...>(e);
+    // Added/Changed terms on the driving pool: the slot is the dense index
+    // itself, so the tick is tested before any per-entity lookup
+    template<typename... Terms, size_t... I>
+    static bool AcceptDriver(const QueryState<Terms...>& query, size_t i, std::index_sequence<I...>) {
+        auto accept = [&](auto* pool, auto term) {
+            using Term = decltype(term);
+            if constexpr (Term::kFilter) {
+                return static_cast<const IPool*>(pool) != query.driver
+                    || Term::Accept(pool->AddedTicks(), pool->ChangedTicks(), i, query.since);
+            } else {
+                return true;
+            }
+        };
+        return (accept(std::get<I>(query.pools), detail::QueryTerm<Terms>{}) && ...);
     }
 
-    template<typename T>
-    IPool* Smallest(IPool* current) {
-        IPool* candidate = GetPool<T>();
-        if (!candidate) {
-            return nullptr;
+    // Visit the entities in [begin, end) of the query's driving range;
+    // returns how many were passed to fn
+    template<typename... Terms, typename Fn>
+    size_t RunQuery(const QueryState<Terms...>& query, Fn& fn, size_t begin, size_t end) {
+        constexpr size_t kCount = sizeof...(Terms);
+        using Sequence = std::make_index_sequence<kCount>;
+        const auto& pools = query.pools;
+
+        if constexpr ((detail::QueryTerm<Terms>::kPlain && ...)) {
+            if (query.packed) {
+                [&]<size_t... I>(std::index_sequence<I...>) {
+                    const std::tuple<detail::QueryComponent<Terms>*...> data{std::get<I>(pools)->Data()...};
+                    const std::array<uint32_t*, kCount> ticks{std::get<I>(pools)->ChangedTicks()...};
+                    for (size_t i = begin; i < end; ++i) {
+                        (detail::QueryTerm<Terms>::Stamp(ticks[I], i, query.tick), ...);
+                        fn(query.entities[i], static_cast<Terms&>(detail::DenseAt(std::get<I>(data), i))...);
+                    }
+                }(Sequence{});
+                return end - begin;
+            }
         }
-        if (!current || candidate->Size() < current->Size()) {
-            current = candidate;
+
+        // Types beyond the signature bits need per-pool checks
+        const bool bySignature = !query.required.untracked && !query.excluded.untracked;
+        size_t visited = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if constexpr ((detail::QueryTerm<Terms>::kFilter || ...)) {
+                if (!AcceptDriver(query, i, Sequence{})) continue;
+            }
+            const Entity e = query.entities[i];
+            const bool matches = bySignature ? Matches(e, query.required, query.excluded)
+                                             : MatchesPools<Terms...>(e, pools, Sequence{});
+            if (matches) {
+                const auto index = [&]<size_t... I>(std::index_sequence<I...>) {
+                    // Tags and With/Without terms have no slot to look up; the
+                    // driving pool's slot is i
+                    return std::array<uint32_t, kCount>{
+                        (!detail::QueryTerm<Terms>::kNeedsIndex                                 ? 0u
+                         : static_cast<const IPool*>(std::get<I>(pools)) == query.driver ? static_cast<uint32_t>(i)
+                         : std::get<I>(pools)                                             ? std::get<I>(pools)->IndexOf(e)
+                                                                                          : detail::kInvalidSparse)...};
+                }(Sequence{});
+                visited += VisitQuery<Terms...>(fn, e, pools, index, query.tick, query.since, Sequence{}) ? 1 : 0;
+            }
         }
-        return current;
+        return visited;
     }
 
-    template<typename T, typename U, typename... Rest>
-    IPool* Smallest(IPool* current) {
-        IPool* candidate = GetPool<T>();
-        if (!candidate) {
-            return nullptr;
-        }
-        if (!current || candidate->Size() < current->Size()) {
-            current = candidate;
+    // Apply filters and stamps of one entity, then call fn with the terms'
+    // arguments; false if a filter rejected it
+    template<typename... Terms, typename Fn, typename Pools, size_t... I>
+    static bool VisitQuery(Fn& fn, Entity e, const Pools& pools, const std::array<uint32_t, sizeof...(Terms)>& index,
+                           uint32_t tick, uint32_t since, std::index_sequence<I...>) {
+        // Pools of excluded and optional terms may be missing
+        auto added = [](auto* pool) { return pool ? pool->AddedTicks() : nullptr; };
+        auto changed = [](auto* pool) { return pool ? pool->ChangedTicks() : nullptr; };
+        if constexpr ((detail::QueryTerm<Terms>::kFilter || ...)) {
+            if (!(detail::QueryTerm<Terms>::Accept(added(std::get<I>(pools)), changed(std::get<I>(pools)), index[I], since)
+                  && ...)) {
+                return false;
+            }
         }
-        return Smallest<U, Rest...>(current);
+        (detail::QueryTerm<Terms>::Stamp(changed(std::get<I>(pools)), index[I], tick), ...);
+        std::apply([&](auto&&... args) { fn(e, std::forward<decltype(args)>(args)...); },
+                   std::tuple_cat(detail::QueryTerm<Terms>::Arg(
+                       std::get<I>(pools) && index[I] != detail::kInvalidSparse ? std::get<I>(pools)->Data() : nullptr,
+                       index[I])...));
+        return true;
     }
 
-    template<typename... Cs>
-    IPool* GetSmallestPool() {
-        IPool* pool = nullptr;
-        pool = Smallest<Cs...>(pool);
-        return pool;
+    // Entities of a pool are alive, so the signature can be read directly
+    bool Matches(Entity e, const ComponentMask& required, const ComponentMask& excluded) const {
+        const ComponentMask& owned = m_Entities[detail::DecodeIndex(e)].components;
+        return owned.ContainsAll(required) && !owned.Intersects(excluded);
+    }
+
+    template<typename... Terms, typename Pools, size_t... I>
+    static bool MatchesPools(Entity e, const Pools& pools, std::index_sequence<I...>) {
+        auto check = [e](const IPool* pool, detail::TermRole role) {
+            switch (role) {
+                case detail::TermRole::Required: return pool->Contains(e);
+                case detail::TermRole::Excluded: return !pool || !pool->Contains(e);
+                default: return true;
+            }
+        };
+        return (check(std::get<I>(pools), detail::QueryTerm<Terms>::kRole) && ...);
     }
 
 private:
@@ -410,7 +2841,154 @@ private:
     std::vector<uint32_t> m_FreeList;
     // Optimized: Vector instead of map for O(1) access
     std::vector<std::unique_ptr<IPool>> m_Pools;
+    std::vector<std::unique_ptr<detail::GroupData>> m_Groups;
     size_t m_AliveCount = 0;
+    std::atomic<uint32_t> m_Tick{1};
+    uint32_t m_ExternalLastRun = 0;
+    JobSystem* m_Jobs = nullptr;
+
+    StorageMode m_Mode = StorageMode::SparseSet;
+    uint64_t m_Id = 0;
+    // Archetype storage: [0] is the empty set; entities without components stay there
+    std::vector<std::unique_ptr<detail::Archetype>> m_Archetypes;
+
+    // Type-erased owners indexed by detail::GetContextTypeID
+    std::vector<std::shared_ptr<void>> m_Context;
+
+    struct DeferredBuffers {
+        struct Entry {
+            std::thread::id thread;
+            std::unique_ptr<CommandBuffer> buffer;
+        };
+        mutable std::mutex mutex;
+        std::vector<Entry> buffers;
+    };
+    std::unique_ptr<DeferredBuffers> m_Deferred = std::make_unique<DeferredBuffers>();
+
+    // Distinguishes registries for the thread-local Deferred() cache
+    static uint64_t NextSerial() {
+        static std::atomic<uint64_t> serial{0};
+        return ++serial;
+    }
+    const uint64_t m_Serial = NextSerial();
+};
+
+template<typename... Cs>
+template<typename Fn>
+void OwningGroup<Cs...>::Each(Fn&& fn) {
+    if (Size() > 0) {
+        m_Registry->template ForEach<Cs...>(fn);
+    }
+}
+
+template<typename T>
+void CommandBuffer::ApplyAdd(Registry& registry, Entity e, void* payload) {
+    registry.Add<T>(e, std::move(*static_cast<T*>(payload)));
+}
+
+template<typename T>
+void CommandBuffer::ApplyRemove(Registry& registry, Entity e, void*) {
+    registry.Remove<T>(e);
+}
+
+inline void CommandBuffer::Playback(Registry& registry) {
+    registry.Playback(this, 1);
+}
+
+// =========================================================
+// Collectors
+// =========================================================
+// Records entities through signals: an entity is collected when T is added
+// (and, with Trigger::ConstructOrUpdate, updated) while it has every Required
+// component, or when the last missing Required component is added. Entities
+// that already match are collected on construction. Each() visits the ones
+// that still match and empties the collector, so a system pays only for new
+// entities instead of scanning the whole pool.
+// Must not outlive the registry (keeping it in Registry::Ctx ties the two).
+template<typename T, typename... Required>
+class Collector {
+public:
+    enum class Trigger { Construct, ConstructOrUpdate };
+
+    explicit Collector(Registry& registry, Trigger trigger = Trigger::Construct)
+        : m_Registry(&registry) {
+        registry.OnConstruct<T>().template Connect<&Collector::OnMatch>(this);
+        if (trigger == Trigger::ConstructOrUpdate) {
+            registry.OnUpdate<T>().template Connect<&Collector::OnMatch>(this);
+        }
+        (registry.OnConstruct<Required>().template Connect<&Collector::OnMatch>(this), ...);
+        registry.OnDestroy<T>().template Connect<&Collector::OnLost>(this);
+
+        registry.template ForEach<const T>([this, &registry](Entity e, const T&) { OnMatch(registry, e); });
+    }
+
+    ~Collector() {
+        m_Registry->OnConstruct<T>().Disconnect(this);
+        m_Registry->OnUpdate<T>().Disconnect(this);
+        (m_Registry->OnConstruct<Required>().Disconnect(this), ...);
+        m_Registry->OnDestroy<T>().Disconnect(this);
+    }
+
+    Collector(const Collector&) = delete;
+    Collector& operator=(const Collector&) = delete;
+
+    // fn(Entity) for every collected entity that still matches, then empty
+    template<typename Fn>
+    void Each(Fn&& fn) {
+        std::vector<Entity> pending;
+        pending.swap(m_Entities);
+        for (Entity e : pending) {
+            if (!Take(e)) continue;
+            if (m_Registry->template Has<T>(e) && (m_Registry->template Has<Required>(e) && ...)) {
+                fn(e);
+            }
+        }
+        // Keep the capacity unless fn collected new entities meanwhile
+        if (m_Entities.empty()) {
+            pending.clear();
+            m_Entities.swap(pending);
+        }
+    }
+
+    // Upper bound: entities that lost a component are dropped by Each()
+    size_t Size() const { return m_Entities.size(); }
+    bool Empty() const { return m_Entities.empty(); }
+
+    void Clear() {
+        for (Entity e : m_Entities) Take(e);
+        m_Entities.clear();
+    }
+
+private:
+    void OnMatch(Registry& registry, Entity e) {
+        if (!registry.template Has<T>(e) || !(registry.template Has<Required>(e) && ...)) {
+            return;
+        }
+        const uint32_t index = detail::DecodeIndex(e);
+        if (index >= m_Marked.size()) {
+            m_Marked.resize(index + 1, kInvalidEntity);
+        }
+        if (m_Marked[index] != e) {
+            m_Marked[index] = e;
+            m_Entities.push_back(e);
+        }
+    }
+
+    void OnLost(Registry&, Entity e) { Take(e); }
+
+    // Unmark e; false if it was not (or no longer) collected
+    bool Take(Entity e) {
+        const uint32_t index = detail::DecodeIndex(e);
+        if (index >= m_Marked.size() || m_Marked[index] != e) {
+            return false;
+        }
+        m_Marked[index] = kInvalidEntity;
+        return true;
+    }
+
+    Registry* m_Registry;
+    std::vector<Entity> m_Entities;
+    std::vector<Entity> m_Marked; // by entity index: the collected handle
 };
 
 // =========================================================
@@ -421,8 +2999,95 @@ public:
     virtual ~ISystem() = default;
     virtual void Tick(Registry& registry, float deltaTime) = 0;
     virtual void FixedTick(Registry& /*registry*/, float /*fixedDeltaTime*/) {}
+
+    // Once per registry, on the main thread before the system's first run and
+    // with no system running: create context entries and connect signals here
+    // rather than lazily in Tick, where other systems may run at the same time
+    virtual void Setup(Registry& /*registry*/) {}
+
+    // Components this system touches. Systems that do not override this are
+    // exclusive: they run alone, on the main thread, in registration order.
+    virtual SystemAccess Access() const { return SystemAccess::Exclusive(); }
+
+    // Name in profiles; empty uses the class name
+    virtual std::string_view Name() const { return {}; }
+};
+
+// Rolling statistics of one system phase over the scheduler's profiling ring
+struct SystemProfile {
+    std::string name;
+    bool fixedUpdate = false;
+    size_t samples = 0;
+    double minMs = 0.0;
+    double avgMs = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double avgEntities = 0.0;          // entities passed to ForEach callbacks per run
+    double avgStructuralChanges = 0.0; // creates/destroys/adds/removes, direct or deferred
 };
 
+namespace detail {
+    // Unqualified class name of T from the compiler's function signature
+    template<typename T>
+    std::string ShortTypeName() {
+#if defined(_MSC_VER)
+        std::string_view name = __FUNCSIG__;
+        const size_t begin = name.find("ShortTypeName<") + 14;
+        name = name.substr(begin, name.rfind(">(void)") - begin);
+#else
+        std::string_view name = __PRETTY_FUNCTION__;
+        const size_t begin = name.find("T = ") + 4;
+        name = name.substr(begin, name.find_first_of(";]", begin) - begin);
+#endif
+        // Drop namespaces and enclosing scopes, but not those of template arguments
+        size_t scope = 0;
+        int depth = 0;
+        for (size_t i = 0; i + 1 < name.size(); ++i) {
+            if (name[i] == '<' || name[i] == '(') ++depth;
+            else if (name[i] == '>' || name[i] == ')') --depth;
+            else if (depth == 0 && name[i] == ':' && name[i + 1] == ':') scope = i + 2;
+        }
+        name.remove_prefix(scope);
+        for (std::string_view keyword : {"class ", "struct "}) {
+            if (name.starts_with(keyword)) name.remove_prefix(keyword.size());
+        }
+        return std::string(name);
+    }
+
+    // Last kCapacity runs of one system phase. A system never runs
+    // concurrently with itself, so there is one writer; readers on any thread
+    // copy it without locks (a sample being overwritten may come out mixed).
+    struct SystemSampleRing {
+        static constexpr size_t kCapacity = 128;
+
+        struct Sample {
+            std::atomic<uint64_t> nanoseconds{0};
+            std::atomic<uint64_t> entities{0};
+            std::atomic<uint64_t> structural{0};
+        };
+
+        std::array<Sample, kCapacity> samples;
+        std::atomic<uint64_t> written{0};
+
+        void Push(uint64_t nanoseconds, uint64_t entities, uint64_t structural) {
+            const uint64_t next = written.load(std::memory_order_relaxed);
+            Sample& sample = samples[next % kCapacity];
+            sample.nanoseconds.store(nanoseconds, std::memory_order_relaxed);
+            sample.entities.store(entities, std::memory_order_relaxed);
+            sample.structural.store(structural, std::memory_order_relaxed);
+            written.store(next + 1, std::memory_order_release);
+        }
+
+        void Reset() { written.store(0, std::memory_order_release); }
+    };
+} // namespace detail
+
+// Runs systems as a dependency graph built from their declared access.
+// A system depends on every earlier system it conflicts with; main-thread
+// systems additionally keep their relative registration order. Without a
+// JobSystem everything runs sequentially in registration order.
+// Sync points: deferred commands (Registry::Deferred) are flushed before
+// every exclusive system and after the last system of each update.
 class SystemScheduler {
 public:
     template<typename TSystem, typename... Args>
@@ -430,26 +3095,372 @@ public:
         static_assert(std::is_base_of_v<ISystem, TSystem>, "System must inherit from ISystem");
         auto sys = std::make_unique<TSystem>(std::forward<Args>(args)...);
         auto& ref = *sys;
+        const std::string_view name = ref.Name();
+        m_Names.push_back(name.empty() ? detail::ShortTypeName<TSystem>() : std::string(name));
         m_Systems.push_back(std::move(sys));
+        m_LastRun.push_back({});
+        m_SetUpFor.push_back(0);
+        if (m_Profiling) {
+            m_Samples.push_back(std::make_unique<std::array<detail::SystemSampleRing, 2>>());
+        }
+        m_GraphDirty = true;
         return ref;
     }
 
-    void UpdateAll(Registry& registry, float deltaTime) {
-        for (auto& sys : m_Systems) {
-            sys->Tick(registry, deltaTime);
+    size_t GetSystemCount() const { return m_Systems.size(); }
+    const std::string& GetSystemName(size_t index) const { return m_Names.at(index); }
+
+    // Per-system profiling: wall time, entities visited through ForEach and
+    // structural changes of every Tick/FixedTick, kept for the last
+    // SystemSampleRing::kCapacity runs. Off: one branch per system run and
+    // per ForEach call. While the Profiler is enabled every run is also
+    // reported to it as "ECS/<name>" ("ECS/<name> (fixed)" for FixedTick).
+    // Toggle between updates, not during one.
+    void SetProfiling(bool enabled) {
+        m_Profiling = enabled;
+        while (enabled && m_Samples.size() < m_Systems.size()) {
+            m_Samples.push_back(std::make_unique<std::array<detail::SystemSampleRing, 2>>());
         }
     }
+    bool IsProfiling() const { return m_Profiling; }
+
+    // Statistics of one system; may be read while systems are running
+    SystemProfile GetSystemProfile(size_t index, bool fixedUpdate = false) const {
+        SystemProfile profile;
+        profile.name = m_Names.at(index);
+        profile.fixedUpdate = fixedUpdate;
+        if (index >= m_Samples.size()) {
+            return profile;
+        }
+        const auto& ring = (*m_Samples[index])[fixedUpdate ? kFixedUpdate : kUpdate];
+        const uint64_t written = ring.written.load(std::memory_order_acquire);
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(written, detail::SystemSampleRing::kCapacity));
+        if (count == 0) {
+            return profile;
+        }
 
-    void FixedUpdateAll(Registry& registry, float fixedDeltaTime) {
-        for (auto& sys : m_Systems) {
-            sys->FixedTick(registry, fixedDeltaTime);
+        std::array<uint64_t, detail::SystemSampleRing::kCapacity> times{};
+        uint64_t totalTime = 0;
+        uint64_t totalEntities = 0;
+        uint64_t totalStructural = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const auto& sample = ring.samples[i];
+            times[i] = sample.nanoseconds.load(std::memory_order_relaxed);
+            totalTime += times[i];
+            totalEntities += sample.entities.load(std::memory_order_relaxed);
+            totalStructural += sample.structural.load(std::memory_order_relaxed);
+        }
+        constexpr double kMsPerNs = 1e-6;
+        const auto range = std::minmax_element(times.begin(), times.begin() + count);
+        profile.minMs = static_cast<double>(*range.first) * kMsPerNs;
+        profile.maxMs = static_cast<double>(*range.second) * kMsPerNs;
+        const size_t p99Rank = (count * 99 + 99) / 100 - 1; // nearest rank
+        std::nth_element(times.begin(), times.begin() + p99Rank, times.begin() + count);
+
+        profile.samples = count;
+        profile.p99Ms = static_cast<double>(times[p99Rank]) * kMsPerNs;
+        profile.avgMs = static_cast<double>(totalTime) * kMsPerNs / static_cast<double>(count);
+        profile.avgEntities = static_cast<double>(totalEntities) / static_cast<double>(count);
+        profile.avgStructuralChanges = static_cast<double>(totalStructural) / static_cast<double>(count);
+        return profile;
+    }
+
+    // Every system phase that has samples, in registration order
+    std::vector<SystemProfile> GetSystemProfiles() const {
+        std::vector<SystemProfile> profiles;
+        for (size_t i = 0; i < m_Samples.size(); ++i) {
+            for (bool fixedUpdate : {false, true}) {
+                SystemProfile profile = GetSystemProfile(i, fixedUpdate);
+                if (profile.samples > 0) profiles.push_back(std::move(profile));
+            }
+        }
+        return profiles;
+    }
+
+    void ResetProfiles() {
+        for (auto& rings : m_Samples) {
+            for (auto& ring : *rings) ring.Reset();
         }
     }
 
-    void Clear() { m_Systems.clear(); }
+    void SetJobSystem(JobSystem* jobs) { m_Jobs = jobs; }
+    JobSystem* GetJobSystem() const { return m_Jobs; }
+
+    // Debug mode: record component access that a system did not declare
+    // (requires SAGE_ECS_ACCESS_CHECKS)
+    void SetAccessValidation(bool enabled) { m_ValidateAccess = enabled; }
+    bool IsAccessValidationEnabled() const { return m_ValidateAccess; }
+    const std::vector<AccessViolation>& GetAccessViolations() const { return m_Violations; }
+    void ClearAccessViolations() {
+        std::lock_guard<std::mutex> lock(m_ViolationMutex);
+        m_Violations.clear();
+    }
+
+    void UpdateAll(Registry& registry, float deltaTime) {
+        Run(registry, kUpdate, [deltaTime](ISystem& sys, Registry& reg) { sys.Tick(reg, deltaTime); });
+    }
+
+    void FixedUpdateAll(Registry& registry, float fixedDeltaTime) {
+        Run(registry, kFixedUpdate, [fixedDeltaTime](ISystem& sys, Registry& reg) { sys.FixedTick(reg, fixedDeltaTime); });
+    }
+
+    void Clear() {
+        m_Systems.clear();
+        m_Names.clear();
+        m_LastRun.clear();
+        m_SetUpFor.clear();
+        m_Samples.clear();
+        m_Nodes.clear();
+        m_GraphDirty = true;
+    }
 
 private:
+    // Tick and FixedTick track their last run separately for change detection
+    enum Phase : size_t { kUpdate = 0, kFixedUpdate = 1 };
+
+    struct Node {
+        SystemAccess access;
+        std::vector<size_t> successors;
+        size_t dependencyCount = 0;
+    };
+
+    void BuildGraph() {
+        m_Nodes.clear();
+        m_Nodes.resize(m_Systems.size());
+        m_HasParallelWork = false;
+
+        for (size_t i = 0; i < m_Systems.size(); ++i) {
+            m_Nodes[i].access = m_Systems[i]->Access();
+            m_HasParallelWork = m_HasParallelWork || !m_Nodes[i].access.mainThread;
+        }
+
+        for (size_t j = 0; j < m_Nodes.size(); ++j) {
+            for (size_t i = 0; i < j; ++i) {
+                const bool bothMain = m_Nodes[i].access.mainThread && m_Nodes[j].access.mainThread;
+                if (bothMain || m_Nodes[i].access.ConflictsWith(m_Nodes[j].access)) {
+                    m_Nodes[i].successors.push_back(j);
+                    ++m_Nodes[j].dependencyCount;
+                }
+            }
+        }
+        m_GraphDirty = false;
+    }
+
+    template<typename Fn>
+    void Run(Registry& registry, Phase phase, Fn&& fn) {
+        if (m_GraphDirty) {
+            BuildGraph();
+        }
+        for (size_t i = 0; i < m_Systems.size(); ++i) {
+            if (m_SetUpFor[i] != registry.GetId()) {
+                m_Systems[i]->Setup(registry);
+                m_SetUpFor[i] = registry.GetId();
+            }
+        }
+
+        if (!m_Jobs || m_Jobs->GetWorkerCount() == 0 || !m_HasParallelWork) {
+            for (size_t i = 0; i < m_Systems.size(); ++i) {
+                SyncBefore(i, registry);
+                RunSystem(i, registry, phase, fn);
+            }
+            registry.FlushCommands();
+            ReportToProfiler(phase);
+            return;
+        }
+
+        const size_t count = m_Nodes.size();
+        m_Pending.resize(count);
+        m_MainReady.clear();
+
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        std::vector<size_t> done;
+        std::vector<size_t> completed;
+        std::exception_ptr error;
+        std::atomic<bool> failed{false};
+
+        // Exceptions are kept until every in-flight job has finished
+        auto execute = [&](size_t index) {
+            if (failed.load(std::memory_order_acquire)) return;
+            try {
+                RunSystem(index, registry, phase, fn);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (!error) error = std::current_exception();
+                failed.store(true, std::memory_order_release);
+            }
+        };
+
+        auto dispatch = [&](size_t index) {
+            if (m_Nodes[index].access.mainThread) {
+                m_MainReady.push_back(index);
+                return;
+            }
+            m_Jobs->Submit([&, index]() {
+                execute(index);
+                // Notify under the mutex: otherwise Run could see the index,
+                // return and destroy doneCondition before notify_one runs
+                std::lock_guard<std::mutex> lock(doneMutex);
+                done.push_back(index);
+                doneCondition.notify_one();
+            });
+        };
+
+        // Dependency counters are only touched here, on the main thread
+        auto release = [&](size_t index) {
+            for (size_t next : m_Nodes[index].successors) {
+                if (--m_Pending[next] == 0) dispatch(next);
+            }
+        };
+
+        for (size_t i = 0; i < count; ++i) {
+            m_Pending[i] = m_Nodes[i].dependencyCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (m_Pending[i] == 0) dispatch(i);
+        }
+
+        size_t finished = 0;
+        while (finished < count) {
+            if (!m_MainReady.empty()) {
+                const size_t index = m_MainReady.front();
+                m_MainReady.erase(m_MainReady.begin());
+                SyncBefore(index, registry);
+                execute(index);
+                ++finished;
+                release(index);
+                continue;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                if (done.empty()) {
+                    lock.unlock();
+                    if (m_Jobs->RunPendingJob()) continue;
+                    lock.lock();
+                    doneCondition.wait(lock, [&]() { return !done.empty(); });
+                }
+                completed.swap(done);
+            }
+
+            for (size_t index : completed) {
+                ++finished;
+                release(index);
+            }
+            completed.clear();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        registry.FlushCommands();
+        ReportToProfiler(phase);
+    }
+
+    // Latest run of every system, on the main thread after the update
+    void ReportToProfiler(Phase phase) {
+        if (!m_Profiling || !Profiler::Get().IsEnabled()) {
+            return;
+        }
+        for (size_t i = 0; i < m_Samples.size(); ++i) {
+            const auto& ring = (*m_Samples[i])[phase];
+            const uint64_t written = ring.written.load(std::memory_order_acquire);
+            if (written == 0) continue;
+            const uint64_t nanoseconds =
+                ring.samples[(written - 1) % detail::SystemSampleRing::kCapacity].nanoseconds.load(std::memory_order_relaxed);
+            Profiler::Get().AddSample("ECS/" + m_Names[i] + (phase == kFixedUpdate ? " (fixed)" : ""),
+                                      static_cast<double>(nanoseconds) * 1e-6);
+        }
+    }
+
+    // Exclusive systems run alone, so it is safe to apply recorded changes first
+    void SyncBefore(size_t index, Registry& registry) {
+        if (m_Nodes[index].access.exclusive && registry.HasPendingCommands()) {
+            registry.FlushCommands();
+        }
+    }
+
+    template<typename Fn>
+    void RunSystem(size_t index, Registry& registry, Phase phase, Fn& fn) {
+        // Each run gets its own tick; Added/Changed compare against the previous one
+        uint32_t& lastRun = m_LastRun[index][phase];
+        const uint32_t tick = registry.AdvanceTick();
+        struct TickGuard {
+            detail::TickContext previous;
+            ~TickGuard() { detail::tl_Ticks = previous; }
+        } tickGuard{detail::tl_Ticks};
+        detail::tl_Ticks = {&registry, tick, lastRun};
+        lastRun = tick;
+
+        if (m_Profiling && index < m_Samples.size()) {
+            detail::SystemCounters counters;
+            struct CountersGuard {
+                detail::SystemCounters* previous;
+                ~CountersGuard() { detail::tl_Counters = previous; }
+            } countersGuard{detail::tl_Counters};
+            detail::tl_Counters = &counters;
+
+            const auto start = std::chrono::steady_clock::now();
+            InvokeSystem(index, registry, fn);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            (*m_Samples[index])[phase].Push(
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                counters.entities.load(std::memory_order_relaxed),
+                counters.structural.load(std::memory_order_relaxed));
+            return;
+        }
+        InvokeSystem(index, registry, fn);
+    }
+
+    template<typename Fn>
+    void InvokeSystem(size_t index, Registry& registry, Fn& fn) {
+#if SAGE_ECS_ACCESS_CHECKS
+        if (m_ValidateAccess && index < m_Nodes.size() && !m_Nodes[index].access.exclusive) {
+            detail::AccessScope scope{&m_Nodes[index].access, index, this, &SystemScheduler::ReportViolation};
+            struct ScopeGuard {
+                detail::AccessScope* previous;
+                ~ScopeGuard() { detail::tl_AccessScope = previous; }
+            } guard{detail::tl_AccessScope};
+            detail::tl_AccessScope = &scope;
+            fn(*m_Systems[index], registry);
+            return;
+        }
+#endif
+        fn(*m_Systems[index], registry);
+    }
+
+    static void ReportViolation(void* owner, const AccessViolation& violation) {
+        auto* self = static_cast<SystemScheduler*>(owner);
+        std::lock_guard<std::mutex> lock(self->m_ViolationMutex);
+        for (const auto& existing : self->m_Violations) {
+            if (existing.systemIndex == violation.systemIndex
+                && existing.componentTypeId == violation.componentTypeId
+                && existing.structural == violation.structural
+                && existing.write == violation.write) {
+                return;
+            }
+        }
+        self->m_Violations.push_back(violation);
+    }
+
     std::vector<std::unique_ptr<ISystem>> m_Systems;
+    std::vector<std::string> m_Names;
+    std::vector<std::array<uint32_t, 2>> m_LastRun; // per system and phase
+    std::vector<uint64_t> m_SetUpFor;                // Registry::GetId each system last ran Setup for
+    // Per system and phase; allocated when profiling is first enabled
+    std::vector<std::unique_ptr<std::array<detail::SystemSampleRing, 2>>> m_Samples;
+    bool m_Profiling = false;
+    std::vector<Node> m_Nodes;
+    std::vector<size_t> m_Pending;
+    std::vector<size_t> m_MainReady;
+    bool m_GraphDirty = true;
+    bool m_HasParallelWork = false;
+
+    JobSystem* m_Jobs = nullptr;
+
+    bool m_ValidateAccess = false;
+    std::vector<AccessViolation> m_Violations;
+    std::mutex m_ViolationMutex;
 };
 
 } // namespace SAGE::ECS
@@ -103,12 +103,31 @@ struct TransformComponent {
     }
 };
 
+// Связи иерархии: родитель и список детей (firstChild -> nextSibling).
+// Меняется через SetParent/DestroyWithChildren (ECSSystems.h).
+// Трансформ ребёнка задаётся относительно родителя.
+struct HierarchyComponent {
+    Entity parent = kInvalidEntity;
+    Entity firstChild = kInvalidEntity;
+    Entity nextSibling = kInvalidEntity;
+    Entity prevSibling = kInvalidEntity;
+};
+
+// Мировой трансформ, кэшируется TransformPropagationSystem
+struct WorldTransformComponent {
+    Matrix3 matrix;
+    Vector2 position{0.0f, 0.0f};
+    Vector2 scale{1.0f, 1.0f};
+    float rotation = 0.0f;
+};
+
 // Отображаемый спрайт
 struct SpriteComponent {
     Sprite sprite;
     bool visible = true;
     int layer = 0;
     bool transparent = false; // подсказка для сортировки: прозрачные рендерятся после непрозрачных
+    Rect bounds;              // мировой AABB спрайта, пересчитывает SpriteRenderSystem
 };
 
 struct PlatformBehaviorComponent {
@@ -116,10 +135,13 @@ struct PlatformBehaviorComponent {
     float edgeLookAhead = 20.0f; // How far ahead to check for edge
 };
 
+// Плейхед анимации: клип из общей AnimationLibrary мира, текущий кадр,
+// время в нём и скорость (0 — пауза). Запуск клипа — PlayAnimation (ECSSystems.h).
 struct AnimationComponent {
-    Animator animator;
-    std::string currentClip;
-    bool playing = true;
+    AnimationClipId clip = kInvalidAnimationClip;
+    uint32_t frame = 0;
+    float elapsed = 0.0f;
+    float speed = 1.0f;
 };
 
 // Простейшая физика / движение
@@ -146,6 +168,9 @@ struct StatsComponent {
 // Маркеры
 struct PlayerTag {};
 struct EnemyTag {};
+// Позиция, поворот и скорости хранятся в SoA-потоках MotionStreams
+// (Core/MotionStreams.h) и интегрируются пакетно
+struct SoAMotionTag {};
 
 // Камера следует за сущностью (обычно Player)
 struct CameraFollowComponent {
@@ -157,6 +182,19 @@ struct CameraComponent {
     bool active = true;
 };
 
+// Контекст мира (Registry::Ctx<ActiveCamera>()): какая камера сейчас активна.
+// Поддерживается GetActiveCamera/SetActiveCamera (ECSSystems.h).
+struct ActiveCamera {
+    Entity entity = kInvalidEntity;
+};
+
+// Контекст мира (Registry::Ctx<AnimationLibrary>()): клипы, на которые
+// ссылаются AnimationComponent. Библиотека неизменяемая и может быть общей
+// для нескольких миров.
+struct AnimationLibrary {
+    std::shared_ptr<const AnimationClipLibrary> clips;
+};
+
 // Проигрывание звука
 struct AudioComponent {
     std::string path; // Path to sound file
@@ -169,6 +207,11 @@ struct AudioComponent {
     bool spatial = false;
     float minDistance = 100.0f;
     float maxDistance = 1000.0f;
+
+    // Состояние голоса, ведёт AudioSystem
+    bool playing = false;      // голос запущен: реальный или виртуальный
+    bool virtualVoice = false; // курсор идёт, но звук не микшируется
+    float cursor = 0.0f;       // позиция виртуального голоса, секунды
 };
 
 struct PlayerMovementComponent {
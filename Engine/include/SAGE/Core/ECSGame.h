@@ -42,6 +42,9 @@ protected:
     void SetDebugPhysics(bool enabled) { m_DebugPhysics = enabled; }
 
 private:
+    // Сигнал OnDestroy<RigidBodyComponent>: удаляем тело из PhysicsWorld
+    void OnRigidBodyDestroyed(ECS::Registry& reg, ECS::Entity e);
+
     ECS::Registry m_World;
     ECS::SystemScheduler m_Scheduler;
     Physics::PhysicsWorld m_PhysicsWorld; // Add PhysicsWorld instance
@@ -69,6 +72,7 @@ private:
     ECS::HudRenderSystem* m_HudSystem = nullptr;
     ECS::PhysicsSystem* m_PhysicsSystem = nullptr;
     ECS::DeathSystem* m_DeathSystem = nullptr;
+    ECS::TransformPropagationSystem* m_TransformPropagationSystem = nullptr;
 };
 
 } // namespace SAGE
@@ -5,33 +5,179 @@
 #include "SAGE/Graphics/Renderer.h"
 #include "SAGE/Graphics/Animation.h"
 #include "SAGE/Input/Input.h"
+#include "SAGE/Math/RadixSort.h"
 #include "SAGE/Physics/PhysicsWorld.h"
 
 #include <functional>
+#include <span>
 #include <unordered_map>
 
 namespace SAGE::ECS {
 
-// Обновление анимаций
+// Активная камера из Ctx<ActiveCamera>: O(1) без копирования Camera2D.
+// Поиск по всем камерам нужен, только если запомненная выключена или удалена.
+// Позиция камеры с TransformComponent синхронизируется с трансформом.
+CameraComponent* GetActiveCamera(Registry& reg);
+// Делает камеру активной, остальные выключает
+void SetActiveCamera(Registry& reg, Entity camera);
+
+// Запускает клип из Ctx<AnimationLibrary> с первого кадра и сразу ставит
+// кадр в SpriteComponent. Повторный запуск того же клипа без restart
+// продолжает его с текущего места.
+void PlayAnimation(Registry& reg, Entity e, AnimationClipId clip, bool restart = false);
+
+// Обновление анимаций: один проход по плейхедам. SpriteComponent
+// переписывается (и помечается изменённым) только при смене кадра.
 class AnimationSystem : public ISystem {
 public:
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess().Write<AnimationComponent, SpriteComponent>().ReadCtx<AnimationLibrary>();
+    }
 };
 
-// Рендер спрайтов
+// Решётка спрайтов для отсечения по камере. Спрайт не крупнее ячейки лежит
+// в ячейке центра своего SpriteComponent::bounds, крупные — отдельным
+// списком; в решётке только видимые спрайты с текстурой и трансформом.
+// Изменения вносит SpriteRenderSystem, удаление спрайта или трансформа
+// ловится сигналами. Хранится в Registry::Ctx (UseSpriteSpatialIndex);
+// после Registry::Restore — Rebuild().
+class SpriteSpatialIndex {
+public:
+    explicit SpriteSpatialIndex(Registry& registry);
+    ~SpriteSpatialIndex();
+
+    SpriteSpatialIndex(const SpriteSpatialIndex&) = delete;
+    SpriteSpatialIndex& operator=(const SpriteSpatialIndex&) = delete;
+
+    bool IsBuilt() const { return m_Built; }
+    float CellSize() const { return m_CellSize; }
+    size_t Size() const { return m_Size; }
+
+    // Заново разложить все спрайты; до Rebuild решётка пуста
+    void Rebuild(float cellSize);
+    void Clear();
+    // Положить/переложить спрайт после изменения bounds или видимости
+    void Update(Entity e, const SpriteComponent& sprite);
+    // Спрайты, чей bounds пересекает view, в произвольном порядке
+    void Query(const Rect& view, std::vector<Entity>& out) const;
+
+private:
+    struct Entry {
+        Entity entity = kInvalidEntity;
+        bool large = false; // в m_Large, а не в ячейке
+        uint64_t cell = 0;
+        uint32_t slot = 0;
+    };
+
+    uint64_t CellOf(const Rect& bounds) const;
+    void Remove(Entry& entry);
+    void OnRemove(Registry& registry, Entity e);
+
+    Registry* m_Registry;
+    std::unordered_map<uint64_t, std::vector<Entity>> m_Cells;
+    std::vector<Entity> m_Large;
+    std::vector<Entry> m_Entries; // по индексу сущности
+    size_t m_Size = 0;
+    float m_CellSize = 256.0f;
+    bool m_Built = false;
+};
+
+// Индекс реестра, создаётся при первом обращении (под планировщиком — в
+// SpriteRenderSystem::Setup)
+SpriteSpatialIndex& UseSpriteSpatialIndex(Registry& reg);
+
+// Порядок создания спрайтов: каждому новому SpriteComponent (сигнал
+// OnConstruct) достаётся следующая 64-битная отметка, так что переиспользованный
+// индекс сущности не поднимает спрайт выше старых. Спрайты, созданные до
+// появления записи, получают отметки в порядке пула. Хранится в Registry::Ctx
+// (UseSpriteSequence); после Registry::Restore — Reset().
+class SpriteSequence {
+public:
+    explicit SpriteSequence(Registry& registry);
+    ~SpriteSequence();
+
+    SpriteSequence(const SpriteSequence&) = delete;
+    SpriteSequence& operator=(const SpriteSequence&) = delete;
+
+    // Заново пронумеровать все спрайты в порядке пула
+    void Reset();
+    uint64_t Of(Entity e) const;
+
+private:
+    void OnConstruct(Registry& registry, Entity e);
+
+    Registry* m_Registry;
+    std::vector<uint64_t> m_Stamps; // по индексу сущности
+    uint64_t m_Next = 0;
+};
+
+// Создаётся при первом обращении (под планировщиком — в SpriteRenderSystem::Setup)
+SpriteSequence& UseSpriteSequence(Registry& reg);
+
+// Рендер спрайтов. С активной камерой спрайты, чей AABB (SpriteComponent::bounds,
+// пересчитывается только у изменившихся) не пересекает её мировой прямоугольник
+// (Camera2D::GetWorldBounds), в батч не попадают. От spatialIndexThreshold
+// спрайтов видимые ищутся по SpriteSpatialIndex с ячейкой cellSize, а не
+// обходом пула. Прозрачные спрайты одного слоя и глубины рисуются в порядке
+// создания (SpriteSequence). Счётчики последнего тика — здесь и в
+// RenderStats::spritesSubmitted/spritesCulled.
 class SpriteRenderSystem : public ISystem {
 public:
-    using DrawCallback = std::function<void(Sprite&)>;
+    using DrawCallback = std::function<void(const Sprite&)>;
+
+    // Порядок внутри слоя по Y позиции спрайта (глубина в SpriteSortKey)
+    enum class YSort : uint8_t { None, Ascending, Descending };
+
+    bool culling = true;
+    YSort ySort = YSort::None;
+    size_t spatialIndexThreshold = 4096;
+    float cellSize = 256.0f; // сторона ячейки индекса, в мировых единицах
+
     void SetDrawCallback(DrawCallback cb) { m_DrawCallback = std::move(cb); }
+    void Setup(Registry& reg) override;
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Read<TransformComponent, WorldTransformComponent>()
+            .Write<SpriteComponent, CameraComponent>()
+            .WriteCtx<ActiveCamera, SpriteSpatialIndex, SpriteSequence>()
+            .MainThread();
+    }
+
+    uint32_t GetSubmittedCount() const { return m_Submitted; }
+    uint32_t GetCulledCount() const { return m_Culled; }
+
 private:
+    void SubmitSorted(const SpriteSequence& sequence);
+
     DrawCallback m_DrawCallback;
+    std::vector<Entity> m_Visible;
+    std::vector<Entity> m_Changed; // спрайты к пересчёту трансформа и AABB
+    // Кадровые буферы, ёмкость переживает кадры: видимые спрайты,
+    // их сущности и ключи отрисовки
+    std::vector<const SpriteComponent*> m_Draws;
+    std::vector<Entity> m_DrawEntities;
+    std::vector<SortEntry> m_Keys;
+    std::vector<SortEntry> m_SortScratch;
+    std::vector<SortEntry> m_Translucent; // прозрачные по отметкам создания
+    std::vector<uint32_t> m_Ranks;        // их ранги, по индексу в m_Draws
+    uint32_t m_Submitted = 0;
+    uint32_t m_Culled = 0;
 };
 
 // Render Tilemaps
 class TilemapRenderSystem : public ISystem {
 public:
+    void Setup(Registry& reg) override { reg.Ctx<ActiveCamera>(); }
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Read<TransformComponent, TilemapComponent>()
+            .Write<CameraComponent>()
+            .WriteCtx<ActiveCamera>()
+            .MainThread();
+    }
 };
 
 class NativeScriptSystem : public ISystem {
@@ -42,21 +188,137 @@ private:
     Scene* m_Scene;
 };
 
-// Движение по Velocity
+// Движение по Velocity. Сущности с SoAMotionTag двигаются пакетно через
+// MotionStreams реестра (UseMotionStreams), остальные — по компонентам.
 class MovementSystem : public ISystem {
 public:
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess().Write<TransformComponent>().Read<VelocityComponent, RigidBodyComponent, SoAMotionTag>();
+    }
+};
+
+// Иерархия трансформов. parent == kInvalidEntity отвязывает ребёнка.
+// Обоим участникам добавляются HierarchyComponent и WorldTransformComponent.
+// Уничтоженный узел (в том числе через DestroyEntity) выходит из списка
+// родителя, его дети становятся корнями.
+void SetParent(Registry& reg, Entity child, Entity parent);
+// Уничтожает сущность вместе со всеми потомками
+void DestroyWithChildren(Registry& reg, Entity e);
+
+// Пересчёт WorldTransformComponent: только изменившиеся сущности и их
+// поддеревья. Иерархия обходится в ширину по плоскому массиву, который
+// перестраивается лишь при изменении связей.
+class TransformPropagationSystem : public ISystem {
+public:
+    void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess().Write<WorldTransformComponent>().Read<TransformComponent, HierarchyComponent>();
+    }
+private:
+    static constexpr uint32_t kRoot = ~0u;
+    struct Node {
+        Entity entity;
+        uint32_t parent; // индекс в m_Order или kRoot
+    };
+
+    void RebuildOrder(Registry& reg);
+
+    std::vector<Node> m_Order;
+    std::vector<std::pair<Entity, Entity>> m_Links; // (родитель, ребёнок), для RebuildOrder
+    std::vector<const WorldTransformComponent*> m_Worlds;
+    std::vector<uint8_t> m_Dirty;
+    size_t m_HierarchyCount = 0;
+};
+
+// Пространственная упорядоченность: пул TransformComponent сортируется по
+// коду Мортона позиции (Math/Morton.h), пулы мировых трансформов, скоростей,
+// коллайдеров и тел получают тот же порядок. Соседи в мире становятся
+// соседями в памяти, что удешевляет отсечение, broadphase и синхронизацию
+// физики. Работа размазана по кадрам: за тик пересортировывается окно из
+// fractionPerFrame пула, соседние окна перекрываются наполовину; связанные
+// пулы выравниваются раз за проход по пулу. Подключается вручную.
+class SpatialReorderSystem : public ISystem {
+public:
+    float cellSize = 64.0f;         // сторона ячейки решётки Мортона, в мировых единицах
+    float fractionPerFrame = 0.125f;
+
+    void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Write<TransformComponent, WorldTransformComponent, VelocityComponent>()
+            .Write<ColliderComponent, RigidBodyComponent, PhysicsColliderComponent>();
+    }
+private:
+    static constexpr size_t kMinWindow = 256;
+
+    void SyncRelatedPools(Registry& reg);
+
+    size_t m_Cursor = 0;
+    size_t m_SortedCount = 0; // размер пула при последней полной сортировке
 };
 
 // Следование по пути
 class PathFollowSystem : public ISystem {
 public:
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().Write<TransformComponent, PathFollowerComponent>(); }
 };
 
+// Пересечения AABB коллайдеров (size/offset вокруг позиции трансформа).
+// Broadphase — пространственный хеш: ячейка в два среднего размера
+// коллайдера, прямоугольник лежит в ячейке своего нижнего угла, кандидаты —
+// соседние 3x3. Коллайдеры крупнее ячейки проверяются против всех.
+// Пары хранятся между тиками, события Enter/Stay/Exit — разница с прошлым
+// тиком (Exit приходит и для уничтоженных сущностей). colliding — есть хотя
+// бы одна пара. Буферы переиспользуются, устоявшийся кадр не аллоцирует.
 class CollisionSystem : public ISystem {
 public:
+    struct Pair {
+        Entity a; // a < b
+        Entity b;
+        uint64_t Key() const { return (static_cast<uint64_t>(a) << 32) | b; }
+    };
+
+    struct Event {
+        enum class Type : uint8_t { Enter, Stay, Exit };
+        Type type;
+        Entity a;
+        Entity b;
+    };
+
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().Write<ColliderComponent>().Read<TransformComponent>(); }
+
+    // Текущие пары, упорядочены по Key()
+    std::span<const Pair> GetPairs() const { return m_Pairs; }
+    // События последнего тика в порядке ключей пар
+    std::span<const Event> GetEvents() const { return m_Events; }
+
+private:
+    static constexpr uint32_t kNoBucket = ~0u;
+
+    struct Box {
+        float minX, minY, maxX, maxY;
+        int32_t cellX, cellY;
+        Entity entity;
+        ColliderComponent* collider;
+    };
+
+    void BuildGrid();
+    void FindPairs();
+    void AddPair(Box& first, Box& second);
+    void EmitEvents();
+
+    std::vector<Box> m_Boxes;
+    std::vector<Box> m_Grid;             // не крупнее ячейки, по корзинам хеша
+    std::vector<Box> m_Large;            // крупнее ячейки
+    std::vector<uint32_t> m_BucketStart; // начало корзины в m_Grid, +1 в конце
+    std::vector<uint32_t> m_BucketOf;
+    uint32_t m_BucketMask = 0;
+    std::vector<Pair> m_Pairs;
+    std::vector<Pair> m_PrevPairs;
+    std::vector<Event> m_Events;
 };
 
 // Проверка "на земле" для прыжков
@@ -64,6 +326,9 @@ class GroundCheckSystem : public ISystem {
 public:
     explicit GroundCheckSystem(Physics::PhysicsWorld& physicsWorld) : m_PhysicsWorld(physicsWorld) {}
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess().Write<PlayerMovementComponent>().Read<TransformComponent, PhysicsColliderComponent>().MainThread();
+    }
 private:
     Physics::PhysicsWorld& m_PhysicsWorld;
 };
@@ -72,6 +337,11 @@ class PlatformBehaviorSystem : public ISystem {
 public:
     explicit PlatformBehaviorSystem(Physics::PhysicsWorld& physicsWorld) : m_PhysicsWorld(physicsWorld) {}
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Read<PlatformBehaviorComponent, TransformComponent, RigidBodyComponent, PhysicsColliderComponent>()
+            .MainThread();
+    }
 private:
     Physics::PhysicsWorld& m_PhysicsWorld;
 };
@@ -90,6 +360,9 @@ public:
     using InputProvider = std::function<InputState()>;
 
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess().Read<PlayerTag, PlayerMovementComponent, InputComponent>().Write<VelocityComponent>();
+    }
     float moveSpeed = 250.0f;
     void SetInputProvider(InputProvider provider) { m_Provider = std::move(provider); }
 private:
@@ -99,20 +372,68 @@ private:
 // Камера следует за сущностью с компонентом CameraFollowComponent
 class CameraFollowSystem : public ISystem {
 public:
+    void Setup(Registry& reg) override { reg.Ctx<ActiveCamera>(); }
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Write<CameraComponent>()
+            .WriteCtx<ActiveCamera>()
+            .Read<CameraFollowComponent, TransformComponent>();
+    }
 };
 
 // Проигрывание звуков из AudioComponent
+// Звук: свойства AudioComponent передаются в Sound только при изменении
+// (Changed), позиция - при изменении TransformComponent. Голоса дальше
+// maxDistance от слушателя и сверх maxRealVoices (приоритет у ближних и
+// не пространственных) становятся виртуальными: Sound остановлен, курсор
+// идёт по времени кадра, а при возвращении в слышимость звук продолжается
+// с него. Незагруженный Sound голоса не занимает: запрос снимается, голос
+// считается доигравшим.
 class AudioSystem : public ISystem {
 public:
+    size_t maxRealVoices = 32;
+
+    void Setup(Registry& reg) override { reg.Ctx<ActiveCamera>(); }
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Read<TransformComponent>()
+            .Write<AudioComponent, CameraComponent>()
+            .WriteCtx<ActiveCamera>()
+            .MainThread();
+    }
+
+    uint32_t GetRealVoiceCount() const { return m_RealVoices; }
+    uint32_t GetVirtualVoiceCount() const { return m_VirtualVoices; }
+
+    struct Voice {
+        Entity entity;
+        const AudioComponent* audio;
+        float priority; // квадрат расстояния до слушателя, -1 для не пространственных, inf вне слышимости
+    };
+
+    // Переставляет голоса так, что реальные идут первыми; возвращает их число
+    static size_t SelectRealVoices(std::span<Voice> voices, size_t maxReal);
+
+private:
+    std::vector<Voice> m_Audible; // кадровый буфер
+    uint32_t m_RealVoices = 0;
+    uint32_t m_VirtualVoices = 0;
 };
 
 class PhysicsSystem : public ISystem {
 public:
     explicit PhysicsSystem(Physics::PhysicsWorld& world);
+    void Setup(Registry& reg) override;
     void Tick(Registry& reg, float deltaTime) override;
     void FixedTick(Registry& reg, float fixedDeltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess()
+            .Write<RigidBodyComponent, TransformComponent, VelocityComponent>()
+            .Write<PhysicsColliderComponent>() // списки контактов
+            .MainThread();
+    }
     
     // Debug draw
     void DrawDebug(Registry& reg);
@@ -121,9 +442,10 @@ private:
     Physics::PhysicsWorld& m_World;
     Registry* m_CurrentRegistry = nullptr;
     
-    void InitBody(Entity e, RigidBodyComponent& rb, TransformComponent& trans, PhysicsColliderComponent* collider);
-    void SyncTransformToBody(Entity e, RigidBodyComponent& rb, TransformComponent& trans);
-    void SyncBodyToTransform(Entity e, RigidBodyComponent& rb, TransformComponent& trans);
+    void InitNewBodies(Registry& reg);
+    void InitBody(Entity e, RigidBodyComponent& rb, const TransformComponent& trans, const PhysicsColliderComponent* collider);
+    void SyncTransformToBody(Entity e, RigidBodyComponent& rb, const TransformComponent& trans);
+    void SyncBodyToTransform(Registry& reg, Entity e, RigidBodyComponent& rb);
     
     void OnContact(const Physics::ContactEvent& event);
 };
@@ -133,24 +455,33 @@ public:
     float regenHealthPerSec = 0.0f;
     float regenEnergyPerSec = 0.0f;
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().Write<StatsComponent>(); }
 };
 
 // Обновление InputComponent состояниями ввода
 class InputStateSystem : public ISystem {
 public:
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().Write<InputComponent>(); }
 };
 
-// Обновление/рендер частиц через ParticleSystem
+// Эмиссия и обновление частиц ParticleSystem; каждый эмиттер рисуется одним пакетом
+// (Renderer::DrawParticles) с текстурой ParticleSystem::GetTexture()
 class ParticleSystemSystem : public ISystem {
 public:
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override {
+        return SystemAccess().Write<ParticleEmitterComponent>().Read<TransformComponent>().MainThread();
+    }
+private:
+    std::vector<ParticleInstance> m_Instances; // буфер пакета, ёмкость переживает кадры
 };
 
 // Удаление сущностей с нулевым здоровьем
 class DeathSystem : public ISystem {
 public:
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().Read<HealthComponent>(); }
 };
 
 // Отрисовка простого HUD (HP/энергия, пауза)
@@ -158,6 +489,7 @@ class HudRenderSystem : public ISystem {
 public:
     explicit HudRenderSystem(bool* pauseFlag) : m_PauseFlag(pauseFlag) {}
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().MainThread(); }
 private:
     bool* m_PauseFlag = nullptr;
 };
@@ -179,6 +511,7 @@ class RaycastSystem : public ISystem {
 public:
     explicit RaycastSystem(Physics::PhysicsWorld& physicsWorld) : m_PhysicsWorld(physicsWorld) {}
     void Tick(Registry& reg, float deltaTime) override;
+    SystemAccess Access() const override { return SystemAccess().MainThread(); }
     
     // Helper to perform a raycast from screen coordinates
     // Returns the first entity hit
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SAGE {
+
+// Work-stealing worker pool used by the engine to run jobs off the main thread.
+// Every worker owns a queue: it pops its own newest job first and steals the
+// oldest job of another worker when it runs dry.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+    // workerCount == 0 runs every job inline on the submitting thread
+    explicit JobSystem(uint32_t workerCount = DefaultWorkerCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // hardware_concurrency - 1: the main thread does work too
+    static uint32_t DefaultWorkerCount();
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    void Submit(Job job);
+
+    // Run one queued job on the calling thread (lets a waiting thread help out).
+    // Returns false if every queue was empty.
+    bool RunPendingJob();
+
+    // Split [0, count) into chunks of grainSize and run fn(begin, end) for each
+    // on the workers and the calling thread. Returns when every chunk is done;
+    // the first exception thrown by fn is rethrown here.
+    void ParallelFor(size_t count, size_t grainSize, const RangeJob& fn);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    bool PopOwn(uint32_t index, Job& job);
+    bool Steal(uint32_t start, Job& job);
+    void WorkerLoop(uint32_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+    std::atomic<size_t> m_Pending{0};
+    std::atomic<uint32_t> m_NextQueue{0};
+
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeCondition;
+    bool m_Stopping = false;
+};
+
+} // namespace SAGE
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "SAGE/Core/ECS.h"
+#include "SAGE/Core/ECSComponents.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace SAGE::ECS {
+
+// value[i] += rate[i] * deltaTime для x/y/rotation по их скоростям.
+// С AVX2 (SAGE_ENABLE_AVX2) — 8 float за инструкцию и 16 сущностей за
+// итерацию, с SSE2 — 4 и 8, остаток и прочие платформы — скалярно.
+void IntegrateMotion(float* x, float* y, float* rotation,
+                     const float* velocityX, const float* velocityY, const float* angularVelocity,
+                     size_t count, float deltaTime);
+
+// Набор инструкций, выбранный при сборке: "AVX2", "SSE2" или "scalar"
+const char* MotionSimdPath();
+
+// float в SoA-потоке с зеркалом в компоненте: чтение из потока,
+// запись в оба места
+class HotFloat {
+public:
+    HotFloat(float& value, float& mirror) : m_Value(value), m_Mirror(mirror) {}
+
+    operator float() const { return m_Value; }
+    HotFloat& operator=(float value) {
+        m_Value = value;
+        m_Mirror = value;
+        return *this;
+    }
+    HotFloat& operator=(const HotFloat& other) { return *this = static_cast<float>(other); }
+    HotFloat& operator+=(float value) { return *this = m_Value + value; }
+    HotFloat& operator-=(float value) { return *this = m_Value - value; }
+
+private:
+    float& m_Value;
+    float& m_Mirror;
+};
+
+class HotVector2 {
+public:
+    HotFloat x;
+    HotFloat y;
+
+    HotVector2(float& valueX, float& valueY, Vector2& mirror) : x(valueX, mirror.x), y(valueY, mirror.y) {}
+
+    operator Vector2() const { return {x, y}; }
+    HotVector2& operator=(const Vector2& value) {
+        x = value.x;
+        y = value.y;
+        return *this;
+    }
+    HotVector2& operator=(const HotVector2& other) { return *this = static_cast<Vector2>(other); }
+    HotVector2& operator+=(const Vector2& value) { return *this = static_cast<Vector2>(*this) + value; }
+    HotVector2& operator-=(const Vector2& value) { return *this = static_cast<Vector2>(*this) - value; }
+};
+
+// Заменитель TransformComponent& для сущности из MotionStreams: position и
+// rotation читаются из потоков, scale/origin — поля самого компонента.
+// Живёт в пределах кадра, как указатель из Registry::Get.
+class TransformProxy {
+public:
+    HotVector2 position;
+    Vector2& scale;
+    HotFloat rotation;
+    Vector2& origin;
+
+    TransformProxy(float& x, float& y, float& angle, TransformComponent& component)
+        : position(x, y, component.position), scale(component.scale),
+          rotation(angle, component.rotation), origin(component.origin), m_Component(component) {}
+
+    void SetPivot(TransformComponent::Pivot pivot) { m_Component.SetPivot(pivot); }
+
+    operator TransformComponent() const {
+        TransformComponent copy = m_Component;
+        copy.position = position;
+        copy.rotation = rotation;
+        return copy;
+    }
+    TransformProxy& operator=(const TransformComponent& value) {
+        m_Component = value;
+        position = value.position;
+        rotation = value.rotation;
+        return *this;
+    }
+
+private:
+    TransformComponent& m_Component;
+};
+
+// SoA-раскладка горячих полей движения: x, y, rotation и скорости лежат в
+// отдельных массивах float, MovementSystem интегрирует их IntegrateMotion.
+// Состав задаёт SoAMotionTag (добавление/удаление ловится сигналами).
+// Источник правды — потоки; скорости подхватываются из изменённых
+// VelocityComponent. При writeBack позиция и поворот после шага копируются
+// в TransformComponent, а его внешние изменения (Changed) забираются в потоки,
+// так что обычный код с TransformComponent& продолжает работать. Без
+// writeBack компонент устаревает и читать/писать нужно через Transform().
+// Тела с RigidBodyComponent двигает PhysicsSystem: их скорости в потоках
+// нулевые, в компонент они не пишутся, позиция только забирается из него.
+// Хранится в Registry::Ctx (UseMotionStreams); после Registry::Restore — Rebuild().
+class MotionStreams {
+public:
+    explicit MotionStreams(Registry& registry);
+    ~MotionStreams();
+
+    MotionStreams(const MotionStreams&) = delete;
+    MotionStreams& operator=(const MotionStreams&) = delete;
+
+    bool writeBack = true;
+
+    size_t Size() const { return m_Entities.size(); }
+    bool Contains(Entity e) const { return SlotOf(e) != kNoSlot; }
+    std::span<const Entity> Entities() const { return m_Entities; }
+
+    const float* X() const { return m_X.data(); }
+    const float* Y() const { return m_Y.data(); }
+    const float* Rotation() const { return m_Rotation.data(); }
+    const float* VelocityX() const { return m_VelocityX.data(); }
+    const float* VelocityY() const { return m_VelocityY.data(); }
+    const float* AngularVelocity() const { return m_AngularVelocity.data(); }
+
+    // Нужен TransformComponent; запись помечает его изменённым
+    TransformProxy Transform(Entity e);
+
+    // Забрать изменения компонентов, проинтегрировать, записать обратно
+    void Step(float deltaTime);
+
+    // Заново собрать потоки из сущностей с SoAMotionTag
+    void Rebuild();
+
+private:
+    static constexpr uint32_t kNoSlot = ~0u;
+
+    uint32_t SlotOf(Entity e) const;
+    void OnAttach(Registry& registry, Entity e);
+    void OnDetach(Registry& registry, Entity e);
+    void OnBodyAttach(Registry& registry, Entity e);
+    void OnBodyDetach(Registry& registry, Entity e);
+    void LoadVelocity(const Registry& registry, Entity e, uint32_t slot, bool body);
+    void Pull();
+    void Integrate(float deltaTime);
+    void WriteBack();
+
+    Registry* m_Registry;
+    std::vector<Entity> m_Entities;
+    std::vector<uint32_t> m_Slots; // индекс сущности -> слот потоков
+    std::vector<float> m_X;
+    std::vector<float> m_Y;
+    std::vector<float> m_Rotation;
+    std::vector<float> m_VelocityX;
+    std::vector<float> m_VelocityY;
+    std::vector<float> m_AngularVelocity;
+};
+
+// Потоки реестра, создаются при первом обращении
+MotionStreams& UseMotionStreams(Registry& reg);
+
+} // namespace SAGE::ECS
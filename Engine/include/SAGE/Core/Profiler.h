@@ -2,6 +2,7 @@
 
 #include <string>
 #include <chrono>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 
@@ -15,6 +16,7 @@ public:
         double averageMs = 0.0;
         double minMs = 0.0;
         double maxMs = 0.0;
+        double p99Ms = 0.0; // over the kept samples
         size_t callCount = 0;
         double totalMs = 0.0;
     };
@@ -26,6 +28,9 @@ public:
     
     /// End the current profile scope
     void EndScope(const std::string& name);
+
+    /// Record a duration measured elsewhere (e.g. SystemScheduler profiling)
+    void AddSample(const std::string& name, double durationMs);
     
     /// Get all profile results
     std::vector<ProfileResult> GetResults() const;
@@ -3,9 +3,12 @@
 #include "SAGE/Math/Vector2.h"
 #include "SAGE/Math/Rect.h"
 #include "SAGE/Graphics/Texture.h"
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <functional>
 
@@ -102,6 +105,53 @@ private:
     OnAnimationEndCallback m_OnAnimationEnd;
 };
 
+using AnimationClipId = uint32_t;
+constexpr AnimationClipId kInvalidAnimationClip = ~0u;
+
+// Clips shared by many playheads (e.g. every entity of one kind).
+// Names are interned to dense ids and all frames live in one contiguous
+// array, so a playhead is just (clip id, frame index, elapsed time).
+// Fill it once, then share it as std::shared_ptr<const AnimationClipLibrary>.
+class AnimationClipLibrary {
+public:
+    struct ClipInfo {
+        uint32_t firstFrame = 0; // offset into the shared frame array
+        uint32_t frameCount = 0;
+        float totalDuration = 0.0f;
+        bool looping = true;
+    };
+
+    // Returns the clip's id; a clip with the same name is replaced in place and
+    // keeps its id. Empty clips are rejected (kInvalidAnimationClip).
+    AnimationClipId Add(const AnimationClip& clip);
+
+    AnimationClipId Find(std::string_view name) const;
+    bool IsValid(AnimationClipId id) const { return id < m_Clips.size(); }
+
+    const ClipInfo& GetClip(AnimationClipId id) const { return m_Clips[id]; }
+    const std::string& GetName(AnimationClipId id) const { return m_Names[id]; }
+    std::span<const AnimationFrame> GetFrames(AnimationClipId id) const {
+        const ClipInfo& info = m_Clips[id];
+        return {m_Frames.data() + info.firstFrame, info.frameCount};
+    }
+
+    size_t GetClipCount() const { return m_Clips.size(); }
+    size_t GetFrameCount() const { return m_Frames.size(); }
+    // Approximate heap footprint in bytes
+    size_t GetMemoryUsage() const;
+
+    // Moves a playhead forward by deltaTime seconds (<= 0 does nothing).
+    // Looping clips wrap, others hold the last frame. Returns true if the
+    // frame index changed.
+    bool Advance(AnimationClipId id, uint32_t& frame, float& elapsed, float deltaTime) const;
+
+private:
+    std::vector<ClipInfo> m_Clips;
+    std::vector<std::string> m_Names;
+    std::vector<AnimationFrame> m_Frames;
+    std::unordered_map<std::string, AnimationClipId> m_Ids;
+};
+
 // Helper: Create animation from sprite sheet grid
 class SpriteSheetAnimationBuilder {
 public:
@@ -2,6 +2,7 @@
 
 #include "SAGE/Math/Vector2.h"
 #include "SAGE/Math/Matrix3.h"
+#include "SAGE/Math/Rect.h"
 
 namespace SAGE {
 
@@ -30,6 +31,8 @@ public:
     Vector2 ScreenToWorld(const Vector2& screenPos) const;
     // Convert world space to screen space
     Vector2 WorldToScreen(const Vector2& worldPos) const;
+    // World-space AABB of the visible area (rotation, zoom, origin and shake included)
+    Rect GetWorldBounds() const;
 
     // Camera effects
     void Shake(float intensity, float duration);
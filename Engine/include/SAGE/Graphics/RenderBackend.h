@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <span>
 #include <string>
 
 namespace SAGE {
@@ -19,14 +20,26 @@ struct RenderStats {
     uint32_t drawCalls = 0;
     uint32_t vertices = 0;
     uint32_t triangles = 0;
+    uint32_t spritesSubmitted = 0; // SubmitSprite calls
+    uint32_t spritesCulled = 0;    // sprites rejected by view culling before submission
 
     void Reset() {
         drawCalls = 0;
         vertices = 0;
         triangles = 0;
+        spritesSubmitted = 0;
+        spritesCulled = 0;
     }
 };
 
+// One particle quad for DrawParticles: size x size, centred on position
+struct ParticleInstance {
+    Vector2 position;
+    float size = 1.0f;
+    float rotation = 0.0f;
+    Color color = Color::White();
+};
+
 enum class RenderMode {
     Solid = 0,
     Wireframe = 1
@@ -85,9 +98,14 @@ public:
 
     virtual void BeginSpriteBatch(const Camera2D* camera) = 0;
     virtual void SubmitSprite(const Sprite& sprite) = 0;
+    // sortKey is a SpriteSortKey; keys submitted in ascending order are not re-sorted
+    virtual void SubmitSprite(const Sprite& sprite, uint64_t sortKey) = 0;
     virtual void FlushSpriteBatch() = 0;
+    virtual void RecordCulledSprites(uint32_t count) = 0;
 
     virtual void DrawParticle(const Vector2& position, float size, const Color& color, float rotation) = 0;
+    // All particles in one batch (texture == nullptr: untextured quads)
+    virtual void DrawParticles(std::span<const ParticleInstance> particles, Texture* texture) = 0;
 
     virtual void SetProjectionMatrix(const Matrix3& projection) = 0;
     virtual void SetViewMatrix(const Matrix3& view) = 0;
@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 
 namespace SAGE {
@@ -74,10 +75,16 @@ public:
     // Batched sprite rendering
     static void BeginSpriteBatch(const Camera2D* camera = nullptr);
     static void SubmitSprite(const Sprite& sprite);
+    // Explicit draw order (SpriteSortKey); presorted submissions skip the batch sort
+    static void SubmitSprite(const Sprite& sprite, uint64_t sortKey);
     static void FlushSpriteBatch();
+    // Sprites skipped by view culling, reported in RenderStats::spritesCulled
+    static void RecordCulledSprites(uint32_t count);
     
     // Particle rendering
     static void DrawParticle(const Vector2& position, float size, const Color& color, float rotation = 0.0f);
+    // One draw call per call (per texture); prefer it to DrawParticle for emitters
+    static void DrawParticles(std::span<const ParticleInstance> particles, Texture* texture = nullptr);
     
     // Text rendering
     static void DrawText(const std::string& text, const Vector2& position, const Color& color = Color::White(), std::shared_ptr<Font> font = nullptr);
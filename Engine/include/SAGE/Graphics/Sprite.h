@@ -19,10 +19,7 @@ struct Transform2D {
     Transform2D() = default;
     
     inline Matrix3 GetMatrix() const {
-        Matrix3 trans = Matrix3::Translation(position);
-        Matrix3 rot = Matrix3::Rotation(rotation);
-        Matrix3 scl = Matrix3::Scale(scale);
-        return trans * rot * scl;
+        return Matrix3::TRS(position, rotation, scale);
     }
 };
 
@@ -44,6 +41,8 @@ public:
 
     Vector2 GetSize() const;
     Rect GetBounds() const;
+    // World-space AABB of the quad SpriteRenderer emits (textureRect, pivot and rotation included)
+    Rect GetWorldBounds() const;
 
 private:
     std::shared_ptr<Texture> m_Texture;
@@ -7,9 +7,12 @@
 #include "SAGE/Graphics/Sprite.h"
 #include "SAGE/Graphics/Texture.h"
 #include "SAGE/Graphics/Shader.h"
+#include "SAGE/Graphics/RenderBackend.h"
+#include "SAGE/Math/RadixSort.h"
 
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace SAGE {
@@ -26,8 +29,15 @@ public:
     };
 
     void Begin(const Matrix3& projection);
+    // Key derived from sprite.layer and the texture
     void Submit(const Sprite& sprite);
+    // Draw order given by a SpriteSortKey. Flush draws in ascending key order and only
+    // sorts when keys were not already submitted in that order.
+    void Submit(const Sprite& sprite, uint64_t sortKey);
     BatchStats Flush();
+    // Draws the particles right away, one draw call per MaxSprites quads.
+    // Pending Submit()ed sprites are not affected.
+    BatchStats DrawParticles(const Matrix3& projection, std::span<const ParticleInstance> particles, Texture* texture);
     bool HasPendingSprites() const { return !m_Commands.empty(); }
 
 private:
@@ -38,7 +48,6 @@ private:
         Vector2 size;
         Vector2 origin;
         std::shared_ptr<Texture> texture;
-        int layer = 0;
         bool flipX = false;
         bool flipY = false;
     };
@@ -50,8 +59,14 @@ private:
     };
 
     void EnsureGPUResources();
+    // Uploads m_VertexBuffer into the ring buffer and draws it with the bound texture
+    void DrawVertexBuffer(BatchStats& totals);
 
     std::vector<SpriteCommand> m_Commands;
+    std::vector<SortEntry> m_Order;       // Keys of m_Commands, in draw order after Flush sorts
+    std::vector<SortEntry> m_SortScratch; // Radix sort buffer reused between frames
+    uint64_t m_LastKey = 0;
+    bool m_Presorted = true;
     std::vector<SpriteVertex> m_VertexBuffer;
     std::vector<uint32_t> m_IndexBuffer;
 
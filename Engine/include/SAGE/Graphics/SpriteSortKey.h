@@ -0,0 +1,48 @@
+#pragma once
+
+#include "SAGE/Graphics/Texture.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace SAGE {
+
+// 64-bit draw order key, compared as an unsigned integer (high bits first):
+//   [63]      translucent - translucent draws follow opaque ones
+//   [62..47]  layer, biased so negative layers come first
+//   [46..31]  depth inside the layer (quantised Y for Y-sorting), 0 if unused
+//   [30..11]  sequence - submission order; 0 lets equal draws group by texture
+//   [10..0]   texture id - keeps draws with the same texture adjacent
+// Sorting keys once (RadixSort) gives the order SpriteRenderer batches in.
+namespace SpriteSortKey {
+
+constexpr int kTextureBits = 11;
+constexpr int kSequenceBits = 20;
+constexpr int kDepthBits = 16;
+constexpr int kLayerBits = 16;
+
+constexpr int kSequenceShift = kTextureBits;
+constexpr int kDepthShift = kSequenceShift + kSequenceBits;
+constexpr int kLayerShift = kDepthShift + kDepthBits;
+constexpr int kTranslucentShift = kLayerShift + kLayerBits;
+
+constexpr uint32_t kMaxDepth = (1u << kDepthBits) - 1;
+
+// Texture bits derived from the address: a collision only costs a batch split
+inline uint32_t TextureId(const Texture* texture) {
+    const auto address = reinterpret_cast<uintptr_t>(texture);
+    return static_cast<uint32_t>((address >> 4) ^ (address >> (4 + kTextureBits))) & ((1u << kTextureBits) - 1);
+}
+
+constexpr uint64_t Make(bool translucent, int layer, uint32_t depth, uint32_t sequence, uint32_t textureId) {
+    const auto biasedLayer = static_cast<uint64_t>(std::clamp(layer, -32768, 32767) + 32768);
+    return (static_cast<uint64_t>(translucent) << kTranslucentShift) |
+           (biasedLayer << kLayerShift) |
+           (static_cast<uint64_t>(std::min(depth, kMaxDepth)) << kDepthShift) |
+           (static_cast<uint64_t>(sequence & ((1u << kSequenceBits) - 1)) << kSequenceShift) |
+           (textureId & ((1u << kTextureBits) - 1));
+}
+
+} // namespace SpriteSortKey
+
+} // namespace SAGE
@@ -42,6 +42,19 @@ public:
         return result;
     }
 
+    // Product of two affine matrices (bottom row 0 0 1): 12 multiplies
+    // instead of the 27 of the general product
+    Matrix3 MultiplyAffine(const Matrix3& other) const {
+        Matrix3 result;
+        result.m[0] = m[0] * other.m[0] + m[1] * other.m[3];
+        result.m[1] = m[0] * other.m[1] + m[1] * other.m[4];
+        result.m[2] = m[0] * other.m[2] + m[1] * other.m[5] + m[2];
+        result.m[3] = m[3] * other.m[0] + m[4] * other.m[3];
+        result.m[4] = m[3] * other.m[1] + m[4] * other.m[4];
+        result.m[5] = m[3] * other.m[2] + m[4] * other.m[5] + m[5];
+        return result;
+    }
+
     // Transform a point (uses translation component)
     // Point is treated as homogeneous coordinate (x, y, 1)
     Vector2 TransformPoint(const Vector2& point) const {
@@ -93,6 +106,16 @@ public:
         return mat;
     }
 
+    // Translation * Rotation * Scale written out directly
+    static Matrix3 TRS(const Vector2& translation, float angleRadians, const Vector2& scale) {
+        const float c = std::cos(angleRadians);
+        const float s = std::sin(angleRadians);
+        Matrix3 mat;
+        mat.m[0] = c * scale.x;  mat.m[1] = -s * scale.y;  mat.m[2] = translation.x;
+        mat.m[3] = s * scale.x;  mat.m[4] = c * scale.y;   mat.m[5] = translation.y;
+        return mat;
+    }
+
     static Matrix3 Scale(float uniformScale) {
         return Scale({uniformScale, uniformScale});
     }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SAGE/Math/Vector2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace SAGE {
+
+// Z-order (Morton) codes: interleaving the bits of x and y keeps points that
+// are close in 2D mostly close in the 1D order, so sorting by the code gives
+// spatially coherent arrays.
+namespace Morton {
+
+// Spread the bits of v over the even bits of a 64-bit value
+constexpr uint64_t SpreadBits(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+constexpr uint64_t Encode(uint32_t x, uint32_t y) {
+    return SpreadBits(x) | (SpreadBits(y) << 1);
+}
+
+// Code of the grid cell (cellSize world units wide) that holds position.
+// Cell coordinates are biased so negative positions sort before positive ones.
+inline uint64_t FromPosition(const Vector2& position, float cellSize) {
+    auto cell = [cellSize](float value) {
+        const float index = std::clamp(std::floor(value / cellSize), -2147483648.0f, 2147483520.0f);
+        return static_cast<uint32_t>(static_cast<int32_t>(index)) ^ 0x80000000u;
+    };
+    return Encode(cell(position.x), cell(position.y));
+}
+
+} // namespace Morton
+
+} // namespace SAGE
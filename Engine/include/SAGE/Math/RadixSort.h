@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SAGE {
+
+// Sort key plus the index of the element it was computed for
+struct SortEntry {
+    uint64_t key = 0;
+    uint32_t index = 0;
+};
+
+// Stable LSD radix sort of entries by key, 8 bits per pass. One sweep builds
+// all eight histograms; passes whose byte is the same for every key are
+// skipped, so keys that only use a few fields cost a few passes. scratch is
+// resized to entries.size() and keeps its capacity for the next call.
+inline void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+    const size_t count = entries.size();
+    if (count < 2) {
+        return;
+    }
+    if (count <= 32) {
+        // Insertion sort beats eight histogram passes on tiny inputs
+        for (size_t i = 1; i < count; ++i) {
+            const SortEntry entry = entries[i];
+            size_t j = i;
+            for (; j > 0 && entries[j - 1].key > entry.key; --j) {
+                entries[j] = entries[j - 1];
+            }
+            entries[j] = entry;
+        }
+        return;
+    }
+
+    std::array<std::array<uint32_t, 256>, 8> histograms{};
+    for (const SortEntry& entry : entries) {
+        for (size_t pass = 0; pass < 8; ++pass) {
+            ++histograms[pass][(entry.key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    scratch.resize(count);
+    SortEntry* source = entries.data();
+    SortEntry* target = scratch.data();
+    for (size_t pass = 0; pass < 8; ++pass) {
+        auto& histogram = histograms[pass];
+        const size_t shift = pass * 8;
+        if (histogram[(source[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (uint32_t& bucket : histogram) {
+            const uint32_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, target);
+    }
+    if (source != entries.data()) {
+        std::copy(source, source + count, entries.data());
+    }
+}
+
+} // namespace SAGE
@@ -1,6 +1,7 @@
 #include "SAGE/Graphics/Animation.h"
 #include "SAGE/Log.h"
 #include <algorithm>
+#include <cmath>
 
 namespace SAGE {
 
@@ -63,6 +64,105 @@ const AnimationFrame& AnimationClip::GetFrame(size_t index) const {
     return m_Frames[index];
 }
 
+// ============================================
+// AnimationClipLibrary Implementation
+// ============================================
+
+AnimationClipId AnimationClipLibrary::Add(const AnimationClip& clip) {
+    if (clip.GetName().empty() || clip.GetFrameCount() == 0) {
+        SAGE_WARN("AnimationClipLibrary::Add - clip '{}' has no name or frames", clip.GetName());
+        return kInvalidAnimationClip;
+    }
+
+    ClipInfo info;
+    info.frameCount = static_cast<uint32_t>(clip.GetFrameCount());
+    info.looping = clip.IsLooping();
+
+    auto it = m_Ids.find(clip.GetName());
+    if (it != m_Ids.end()) {
+        // Replacing: drop the old frames and shift the clips stored after them
+        const ClipInfo old = m_Clips[it->second];
+        m_Frames.erase(m_Frames.begin() + old.firstFrame, m_Frames.begin() + old.firstFrame + old.frameCount);
+        for (ClipInfo& other : m_Clips) {
+            if (other.firstFrame > old.firstFrame) {
+                other.firstFrame -= old.frameCount;
+            }
+        }
+    }
+
+    info.firstFrame = static_cast<uint32_t>(m_Frames.size());
+    for (size_t i = 0; i < clip.GetFrameCount(); ++i) {
+        m_Frames.push_back(clip.GetFrame(i));
+        // Same lower bound Advance uses, so a cycle always has positive length
+        info.totalDuration += std::max(m_Frames.back().duration, 1e-6f);
+    }
+
+    if (it != m_Ids.end()) {
+        m_Clips[it->second] = info;
+        return it->second;
+    }
+    const auto id = static_cast<AnimationClipId>(m_Clips.size());
+    m_Clips.push_back(info);
+    m_Names.push_back(clip.GetName());
+    m_Ids.emplace(clip.GetName(), id);
+    return id;
+}
+
+AnimationClipId AnimationClipLibrary::Find(std::string_view name) const {
+    auto it = m_Ids.find(std::string(name));
+    return it != m_Ids.end() ? it->second : kInvalidAnimationClip;
+}
+
+size_t AnimationClipLibrary::GetMemoryUsage() const {
+    size_t bytes = m_Clips.capacity() * sizeof(ClipInfo) +
+                   m_Names.capacity() * sizeof(std::string) +
+                   m_Frames.capacity() * sizeof(AnimationFrame) +
+                   m_Ids.bucket_count() * sizeof(void*);
+    for (const auto& name : m_Names) {
+        // Node of m_Ids plus heap storage of both copies of the name
+        bytes += sizeof(std::pair<const std::string, AnimationClipId>) + sizeof(void*);
+        if (name.capacity() >= sizeof(std::string)) {
+            bytes += 2 * (name.capacity() + 1);
+        }
+    }
+    return bytes;
+}
+
+bool AnimationClipLibrary::Advance(AnimationClipId id, uint32_t& frame, float& elapsed, float deltaTime) const {
+    if (id >= m_Clips.size() || deltaTime <= 0.0f) {
+        return false;
+    }
+
+    const ClipInfo& info = m_Clips[id];
+    const AnimationFrame* frames = m_Frames.data() + info.firstFrame;
+    const uint32_t startFrame = frame = std::min(frame, info.frameCount - 1);
+
+    elapsed += deltaTime;
+    float duration = std::max(frames[frame].duration, 1e-6f);
+    if (elapsed < duration) {
+        return false;
+    }
+
+    // A whole loop lands on the same frame: drop full cycles before stepping
+    if (info.looping && elapsed >= info.totalDuration) {
+        elapsed = std::fmod(elapsed, info.totalDuration);
+    }
+
+    while (elapsed >= duration) {
+        if (frame + 1 < info.frameCount) {
+            ++frame;
+        } else if (info.looping) {
+            frame = 0;
+        } else {
+            elapsed = duration;
+            break;
+        }
+        elapsed -= duration;
+        duration = std::max(frames[frame].duration, 1e-6f);
+    }
+    return frame != startFrame;
+}
+
 // ============================================
 // SpriteSheetAnimationBuilder Implementation
 // ============================================
@@ -7,6 +7,7 @@
 #include "SAGE/Core/CommandLine.h"
 #include "SAGE/Audio/Audio.h"
 #include "SAGE/Core/SceneManager.h"
+#include "SAGE/Core/JobSystem.h"
 
 #include <memory>
 
@@ -23,6 +24,12 @@ Application::Application(const ApplicationConfig& config) {
     CommandLine::Initialize();
     InitialiseLogger(config);
 
+    const uint32_t workers = config.workerThreads < 0
+        ? JobSystem::DefaultWorkerCount()
+        : static_cast<uint32_t>(config.workerThreads);
+    m_JobSystem = std::make_unique<JobSystem>(workers);
+    SAGE_INFO("Job system: {} worker thread(s)", workers);
+
     m_Window = Window::Create(config.window);
     Input::Init(m_Window->GetNativeHandle());
     Renderer::Init(config.renderer);
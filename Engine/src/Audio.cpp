@@ -146,6 +146,32 @@ bool Sound::IsPlaying() const {
     return false;
 }
 
+bool Sound::IsLoaded() const {
+    return m_Impl && m_Impl->initialized;
+}
+
+float Sound::GetCursor() const {
+    float cursor = 0.0f;
+    if (m_Impl && m_Impl->initialized) {
+        ma_sound_get_cursor_in_seconds(&m_Impl->sound, &cursor);
+    }
+    return cursor;
+}
+
+float Sound::GetLength() const {
+    float length = 0.0f;
+    if (m_Impl && m_Impl->initialized) {
+        ma_sound_get_length_in_seconds(&m_Impl->sound, &length);
+    }
+    return length;
+}
+
+void Sound::Seek(float seconds) {
+    if (m_Impl && m_Impl->initialized) {
+        ma_sound_seek_to_second(&m_Impl->sound, seconds);
+    }
+}
+
 std::shared_ptr<Sound> Sound::Create(const std::string& path, SoundType type) {
     return std::make_shared<Sound>(path, type);
 }
@@ -1,5 +1,6 @@
 #include "SAGE/Graphics/Camera2D.h"
 #include "SAGE/Log.h"
+#include <algorithm>
 #include <cmath>
 #include <random>
 
@@ -104,6 +105,28 @@ Vector2 Camera2D::WorldToScreen(const Vector2& worldPos) const {
     };
 }
 
+Rect Camera2D::GetWorldBounds() const {
+    if (m_MatricesDirty) {
+        const_cast<Camera2D*>(this)->UpdateMatrices();
+    }
+
+    if (m_ViewportWidth <= 0.0f || m_ViewportHeight <= 0.0f) {
+        return Rect::Zero();
+    }
+
+    // NDC corners back to world space; with rotation the AABB covers the rotated view
+    const Matrix3 invViewProj = m_ViewProjectionMatrix.Inverse();
+    const Vector2 corners[4] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+    Vector2 min = invViewProj.TransformPoint(corners[0]);
+    Vector2 max = min;
+    for (int i = 1; i < 4; ++i) {
+        const Vector2 p = invViewProj.TransformPoint(corners[i]);
+        min = {std::min(min.x, p.x), std::min(min.y, p.y)};
+        max = {std::max(max.x, p.x), std::max(max.y, p.y)};
+    }
+    return {min.x, min.y, max.x - min.x, max.y - min.y};
+}
+
 void Camera2D::SetOrigin(Origin origin) {
     m_Origin = origin;
     m_MatricesDirty = true;
@@ -19,7 +19,12 @@ void ECSGame::OnInit() {
     m_CameraEntity = m_World.CreateEntity();
     auto& camComp = m_World.Add<ECS::CameraComponent>(m_CameraEntity);
     camComp.camera = *m_Camera;
-    camComp.active = true;
+    ECS::SetActiveCamera(m_World, m_CameraEntity);
+
+    // Системы без конфликтов по компонентам и ParallelForEach внутри систем
+    // выполняются на общем пуле воркеров приложения
+    m_Scheduler.SetJobSystem(&GetJobSystem());
+    m_World.SetJobSystem(&GetJobSystem());
 
     // Регистрируем встроенные системы в порядке обновления и сохраняем ссылки
     m_InputStateSystem = &m_Scheduler.AddSystem<ECS::InputStateSystem>();
@@ -35,20 +40,24 @@ void ECSGame::OnInit() {
     m_AudioSystem = &m_Scheduler.AddSystem<ECS::AudioSystem>();
     m_PhysicsSystem = &m_Scheduler.AddSystem<ECS::PhysicsSystem>(m_PhysicsWorld);
     m_DeathSystem = &m_Scheduler.AddSystem<ECS::DeathSystem>();
+    m_TransformPropagationSystem = &m_Scheduler.AddSystem<ECS::TransformPropagationSystem>();
     m_CameraFollowSystem = &m_Scheduler.AddSystem<ECS::CameraFollowSystem>();
     m_SpriteRenderSystem = &m_Scheduler.AddSystem<ECS::SpriteRenderSystem>();
     m_HudSystem = &m_Scheduler.AddSystem<ECS::HudRenderSystem>(&m_Paused);
 
     // Register Physics Cleanup
-    m_World.SetOnComponentRemoved<ECS::RigidBodyComponent>([this](ECS::Entity, ECS::RigidBodyComponent& rb) {
-        if (rb.IsValid()) {
-            m_PhysicsWorld.DestroyBody(rb.bodyHandle);
-        }
-    });
+    m_World.OnDestroy<ECS::RigidBodyComponent>().Connect<&ECSGame::OnRigidBodyDestroyed>(this);
 
     OnECSCreate();
 }
 
+void ECSGame::OnRigidBodyDestroyed(ECS::Registry& reg, ECS::Entity e) {
+    const auto* rb = std::as_const(reg).Get<ECS::RigidBodyComponent>(e);
+    if (rb && rb->IsValid()) {
+        m_PhysicsWorld.DestroyBody(rb->bodyHandle);
+    }
+}
+
 void ECSGame::ReloadScene() {
     m_World.Clear();
     
@@ -58,7 +67,7 @@ void ECSGame::ReloadScene() {
     if (m_Camera) {
         camComp.camera = *m_Camera;
     }
-    camComp.active = true;
+    ECS::SetActiveCamera(m_World, m_CameraEntity);
 
     OnECSCreate();
 }
@@ -1,14 +1,23 @@
 #include "SAGE/Core/ECSSystems.h"
 #include "SAGE/Core/ECSGame.h"
+#include "SAGE/Core/MotionStreams.h"
 #include "SAGE/Graphics/Renderer.h"
 #include "SAGE/Graphics/Camera2D.h"
+#include "SAGE/Graphics/SpriteSortKey.h"
 #include "SAGE/Graphics/Tilemap.h"
 #include "SAGE/Input/Input.h"
 #include "SAGE/Log.h"
+#include "SAGE/Math/Morton.h"
 #include "SAGE/Physics/PhysicsCommon.h"
 #include "SAGE/Core/Scene.h"
 #include "SAGE/Scripting/ScriptableEntity.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string_view>
+#include <utility>
+
 namespace SAGE::ECS {
 
 PhysicsSystem::PhysicsSystem(Physics::PhysicsWorld& world) : m_World(world) {
@@ -23,38 +32,21 @@ PhysicsSystem::PhysicsSystem(Physics::PhysicsWorld& world) : m_World(world) {
 void PhysicsSystem::Tick(Registry& reg, float deltaTime) {
     m_CurrentRegistry = &reg;
 
-    // 1. Initialize new bodies and sync Transform -> Body for Kinematic/Static
-    reg.ForEach<RigidBodyComponent, TransformComponent>([this, &reg](Entity e, RigidBodyComponent& rb, TransformComponent& trans) {
-        PhysicsColliderComponent* collider = reg.Get<PhysicsColliderComponent>(e);
-        
-        if (!rb.IsValid()) {
-            InitBody(e, rb, trans, collider);
-        } else {
-            // Sync Transform -> Body
-            // For Static/Kinematic: Always sync
-            // For Dynamic: Sync ONLY if transform changed significantly (teleport)
-            bool isDynamic = (rb.type == BodyType::Dynamic);
-            
-            // Use epsilon for comparison to prevent jitter
-            const float kEpsilon = 0.0001f;
-            bool posChanged = std::abs(trans.position.x - rb.lastSyncedPosition.x) > kEpsilon || 
-                              std::abs(trans.position.y - rb.lastSyncedPosition.y) > kEpsilon;
-            bool rotChanged = std::abs(trans.rotation - rb.lastSyncedRotation) > kEpsilon;
-            bool transformChanged = posChanged || rotChanged;
-            
-            if (!isDynamic || transformChanged) {
-                SyncTransformToBody(e, rb, trans);
-            }
-        }
-    });
+    // 1. Initialize new bodies and sync Transform -> Body
+    // Только трансформы, изменённые с прошлого запуска системы (телепорт, скрипты)
+    InitNewBodies(reg);
+    reg.ForEach<RigidBodyComponent, const TransformComponent, Changed<TransformComponent>>(
+        [this](Entity e, RigidBodyComponent& rb, const TransformComponent& trans) {
+            SyncTransformToBody(e, rb, trans);
+        });
 
     // 2. Step Physics - Handled in Scene::OnFixedUpdate
     // m_World.Step(deltaTime);
 
     // 3. Sync Body -> Transform for Dynamic
-    reg.ForEach<RigidBodyComponent, TransformComponent>([this, &reg](Entity e, RigidBodyComponent& rb, TransformComponent& trans) {
+    reg.ForEach<RigidBodyComponent, const TransformComponent>([this, &reg](Entity e, RigidBodyComponent& rb, const TransformComponent&) {
         if (rb.IsValid() && rb.type == BodyType::Dynamic) {
-            SyncBodyToTransform(e, rb, trans);
+            SyncBodyToTransform(reg, e, rb);
 
             // Sync Velocity Body -> Component
             if (auto* vel = reg.Get<VelocityComponent>(e)) {
@@ -71,26 +63,11 @@ void PhysicsSystem::FixedTick(Registry& reg, float fixedDeltaTime) {
     m_CurrentRegistry = &reg;
 
     // 1. Sync Transform -> Body (Ensure body is up to date before step)
-    reg.ForEach<RigidBodyComponent, TransformComponent>([this, &reg](Entity e, RigidBodyComponent& rb, TransformComponent& trans) {
-        PhysicsColliderComponent* collider = reg.Get<PhysicsColliderComponent>(e);
-        
-        if (!rb.IsValid()) {
-            InitBody(e, rb, trans, collider);
-        } else {
-            // Sync Transform -> Body
-            bool isDynamic = (rb.type == BodyType::Dynamic);
-            
-            const float kEpsilon = 0.0001f;
-            bool posChanged = std::abs(trans.position.x - rb.lastSyncedPosition.x) > kEpsilon || 
-                              std::abs(trans.position.y - rb.lastSyncedPosition.y) > kEpsilon;
-            bool rotChanged = std::abs(trans.rotation - rb.lastSyncedRotation) > kEpsilon;
-            bool transformChanged = posChanged || rotChanged;
-            
-            if (!isDynamic || transformChanged) {
-                SyncTransformToBody(e, rb, trans);
-            }
-        }
-    });
+    InitNewBodies(reg);
+    reg.ForEach<RigidBodyComponent, const TransformComponent, Changed<TransformComponent>>(
+        [this](Entity e, RigidBodyComponent& rb, const TransformComponent& trans) {
+            SyncTransformToBody(e, rb, trans);
+        });
 
     // 2. Apply VelocityComponent -> Body Velocity
     reg.ForEach<RigidBodyComponent, VelocityComponent>([this](Entity, RigidBodyComponent& rb, VelocityComponent& vel) {
@@ -101,7 +78,39 @@ void PhysicsSystem::FixedTick(Registry& reg, float fixedDeltaTime) {
     });
 }
 
-void PhysicsSystem::InitBody(Entity e, RigidBodyComponent& rb, TransformComponent& trans, PhysicsColliderComponent* collider) {
+namespace {
+// Коллектор хранится в контексте реестра (и отключается вместе с ним):
+// за кадр обходим только новые/изменённые тела, а не весь пул
+using NewBodies = Collector<RigidBodyComponent, TransformComponent>;
+
+NewBodies& UseNewBodies(Registry& reg) {
+    if (auto* collector = reg.FindCtx<NewBodies>()) {
+        return *collector;
+    }
+    return reg.EmplaceCtx<NewBodies>(reg, NewBodies::Trigger::ConstructOrUpdate);
+}
+} // namespace
+
+void PhysicsSystem::Setup(Registry& reg) {
+    // Подписка на сигналы пулов — до кадра, а не посреди работы планировщика
+    UseNewBodies(reg);
+}
+
+void PhysicsSystem::InitNewBodies(Registry& reg) {
+    // Под планировщиком коллектор уже создан в Setup; прямой вызов Tick
+    // (тесты, ручной цикл) создаёт его здесь
+    NewBodies& collector = UseNewBodies(reg);
+
+    const Registry& view = reg;
+    collector.Each([&](Entity e) {
+        auto* rb = reg.Get<RigidBodyComponent>(e);
+        if (!rb->IsValid()) {
+            InitBody(e, *rb, *view.Get<TransformComponent>(e), view.Get<PhysicsColliderComponent>(e));
+        }
+    });
+}
+
+void PhysicsSystem::InitBody(Entity e, RigidBodyComponent& rb, const TransformComponent& trans, const PhysicsColliderComponent* collider) {
     b2BodyDef bodyDef = b2DefaultBodyDef();
     bodyDef.position = Physics::ToB2Vec2(trans.position);
     bodyDef.rotation = b2MakeRot(trans.rotation * 0.0174533f); // Rotation in radians
@@ -148,7 +157,7 @@ void PhysicsSystem::InitBody(Entity e, RigidBodyComponent& rb, TransformComponen
     }
 }
 
-void PhysicsSystem::SyncTransformToBody(Entity, RigidBodyComponent& rb, TransformComponent& trans) {
+void PhysicsSystem::SyncTransformToBody(Entity, RigidBodyComponent& rb, const TransformComponent& trans) {
     if (!rb.IsValid()) return;
 
     // Optimization: Check if transform actually changed
@@ -172,24 +181,29 @@ void PhysicsSystem::SyncTransformToBody(Entity, RigidBodyComponent& rb, Transfor
     // b2Body_SetTransform usually handles this, but explicit wake might be needed if we want immediate response
 }
 
-void PhysicsSystem::SyncBodyToTransform(Entity, RigidBodyComponent& rb, TransformComponent& trans) {
+void PhysicsSystem::SyncBodyToTransform(Registry& reg, Entity e, RigidBodyComponent& rb) {
     if (!rb.IsValid()) return;
     b2BodyId bodyId = Physics::ToB2BodyId(rb.bodyHandle);
     
-    // Optimization: Only sync if body is awake
+    // Optimization: Only sync if body is awake (спящие тела не помечают Transform изменённым)
     if (!b2Body_IsAwake(bodyId)) return;
 
     b2Vec2 pos = b2Body_GetPosition(bodyId);
     b2Rot rot = b2Body_GetRotation(bodyId);
     
-    trans.position = Physics::ToVector2(pos);
-    trans.rotation = b2Rot_GetAngle(rot) * 57.2958f;
+    reg.Patch<TransformComponent>(e, [&](TransformComponent& trans) {
+        trans.position = Physics::ToVector2(pos);
+        trans.rotation = b2Rot_GetAngle(rot) * 57.2958f;
+        // Тело и трансформ совпадают: следующая синхронизация Transform -> Body ничего не сделает
+        rb.lastSyncedPosition = trans.position;
+        rb.lastSyncedRotation = trans.rotation;
+    });
 }
 
 void PhysicsSystem::DrawDebug(Registry& reg) {
     // Simple debug draw for colliders
-    reg.ForEach<RigidBodyComponent, PhysicsColliderComponent, TransformComponent>(
-        [](Entity, RigidBodyComponent&, PhysicsColliderComponent& col, TransformComponent& trans) {
+    reg.ForEach<const RigidBodyComponent, const PhysicsColliderComponent, const TransformComponent>(
+        [](Entity, const RigidBodyComponent&, const PhysicsColliderComponent& col, const TransformComponent& trans) {
             float rotRad = trans.rotation * 0.0174533f;
             Vector2 center = trans.position + col.offset.Rotate(rotRad);
             if (col.shape == ColliderShape::Box) {
@@ -278,117 +292,412 @@ void PhysicsSystem::OnContact(const Physics::ContactEvent& event) {
     UpdateContact(entityB, entityA, event.isBegin);
 }
 
+namespace {
+    void ApplyAnimationFrame(SpriteComponent& sprite, const AnimationFrame& frame) {
+        sprite.sprite.textureRect = frame.uvRect;
+        sprite.sprite.transform.origin = frame.pivot;
+    }
+}
+
+void PlayAnimation(Registry& reg, Entity e, AnimationClipId clip, bool restart) {
+    const auto* library = reg.FindCtx<AnimationLibrary>();
+    if (!library || !library->clips || !library->clips->IsValid(clip)) {
+        SAGE_WARN("PlayAnimation: клип {} не найден", clip);
+        return;
+    }
+    auto& anim = reg.Has<AnimationComponent>(e) ? *reg.Get<AnimationComponent>(e) : reg.Add<AnimationComponent>(e);
+    if (restart || anim.clip != clip) {
+        anim.clip = clip;
+        anim.frame = 0;
+        anim.elapsed = 0.0f;
+    }
+    if (auto* sprite = reg.Get<SpriteComponent>(e)) {
+        ApplyAnimationFrame(*sprite, library->clips->GetFrames(clip)[anim.frame]);
+    }
+}
+
 void AnimationSystem::Tick(Registry& reg, float deltaTime) {
-    reg.ForEach<AnimationComponent, SpriteComponent>([deltaTime](Entity, AnimationComponent& anim, SpriteComponent& sprite) {
-        if (!anim.playing) {
-            return;
-        }
+    const auto* library = reg.FindCtx<AnimationLibrary>();
+    if (!library || !library->clips) {
+        return;
+    }
+    const AnimationClipLibrary& clips = *library->clips;
+    // Спрайт только читается в запросе: Get (с отметкой изменения) - при смене кадра
+    reg.ParallelForEach<AnimationComponent, const SpriteComponent>(
+        [&reg, &clips, deltaTime](Entity e, AnimationComponent& anim, const SpriteComponent&) {
+            if (clips.Advance(anim.clip, anim.frame, anim.elapsed, deltaTime * anim.speed)) {
+                ApplyAnimationFrame(*reg.Get<SpriteComponent>(e), clips.GetFrames(anim.clip)[anim.frame]);
+            }
+        });
+}
 
-        anim.animator.Update(deltaTime);
-        if (auto* frame = anim.animator.GetCurrentFrameData()) {
-            sprite.sprite.textureRect = frame->uvRect;
-            sprite.sprite.transform.origin = frame->pivot;
+CameraComponent* GetActiveCamera(Registry& reg) {
+    auto& active = reg.Ctx<ActiveCamera>();
+    CameraComponent* camera = nullptr;
+    if (active.entity != kInvalidEntity) {
+        camera = reg.Get<CameraComponent>(active.entity);
+    }
+    if (!camera || !camera->active) {
+        // Запомненная камера выключена или удалена: берём первую активную
+        active.entity = kInvalidEntity;
+        camera = nullptr;
+        reg.ForEach<CameraComponent>([&](Entity e, CameraComponent& cam) {
+            if (cam.active && !camera) {
+                camera = &cam;
+                active.entity = e;
+            }
+        });
+        if (!camera) {
+            return nullptr;
+        }
+    }
+    // Камера с трансформом стоит там же, где её сущность
+    if (const auto* trans = std::as_const(reg).Get<TransformComponent>(active.entity)) {
+        if (camera->camera.GetPosition() != trans->position) {
+            camera->camera.SetPosition(trans->position);
         }
+    }
+    return camera;
+}
+
+void SetActiveCamera(Registry& reg, Entity camera) {
+    reg.ForEach<CameraComponent>([camera](Entity e, CameraComponent& cam) {
+        cam.active = e == camera;
     });
+    reg.Ctx<ActiveCamera>().entity = reg.Has<CameraComponent>(camera) ? camera : kInvalidEntity;
+}
+
+void SpriteRenderSystem::Setup(Registry& reg) {
+    // Записи контекста создаются до кадра: в Tick рядом идут другие системы
+    reg.Ctx<ActiveCamera>();
+    UseSpriteSpatialIndex(reg);
+    UseSpriteSequence(reg);
 }
 
 void SpriteRenderSystem::Tick(Registry& reg, float /*deltaTime*/) {
-    // Find active camera
-    Camera2D camera;
-    bool foundCamera = false;
-    reg.ForEach<CameraComponent, TransformComponent>([&](Entity, CameraComponent& cam, TransformComponent& trans) {
-        if (cam.active && !foundCamera) {
-            camera = cam.camera;
-            camera.SetPosition(trans.position);
-            foundCamera = true;
+    Rect view;
+    bool cull = false;
+    if (const auto* active = GetActiveCamera(reg)) {
+        Renderer::SetCamera(active->camera);
+        Renderer::BeginSpriteBatch(&active->camera);
+        if (culling && active->camera.GetViewportWidth() > 0.0f && active->camera.GetViewportHeight() > 0.0f) {
+            view = active->camera.GetWorldBounds();
+            cull = true;
         }
-    });
-
-    if (foundCamera) {
-        Renderer::SetCamera(camera);
-        Renderer::BeginSpriteBatch(&camera);
     } else {
         // Reset to auto projection if no camera found
         Renderer::ConfigureAutoProjection(true);
         Renderer::BeginSpriteBatch(nullptr);
     }
 
-    struct DrawItem {
-        int layer;
-        Sprite* sprite;
-        TransformComponent* transform;
-        Texture* texture;
-        bool transparent;
+    // Переносим в спрайт только трансформы, изменённые с прошлого кадра
+    // (или спрайты, которые заменили/изменили извне), и пересчитываем их AABB
+    // Сущности с WorldTransformComponent (дети в иерархии) берут мировой трансформ
+    SpriteSpatialIndex* index = reg.FindCtx<SpriteSpatialIndex>();
+    auto copyTransform = [&reg, index](Entity e, SpriteComponent& sprite, const TransformComponent& transform) {
+        auto& target = sprite.sprite.transform;
+        target.origin = transform.origin;
+        if (const auto* world = std::as_const(reg).Get<WorldTransformComponent>(e)) {
+            target.position = world->position;
+            target.scale = world->scale;
+            target.rotation = world->rotation;
+        } else {
+            target.position = transform.position;
+            target.scale = transform.scale;
+            target.rotation = transform.rotation;
+        }
+        sprite.bounds = sprite.sprite.GetWorldBounds();
+        if (index) {
+            index->Update(e, sprite);
+        }
     };
+    // Проходы только собирают сущности: запись в спрайт его штампует, и
+    // Changed<SpriteComponent> иначе повторил бы работу первых двух
+    m_Changed.clear();
+    auto collect = [this](Entity e, const SpriteComponent&, const TransformComponent&) { m_Changed.push_back(e); };
+    reg.ForEach<const SpriteComponent, const TransformComponent, Changed<TransformComponent>>(collect);
+    reg.ForEach<const SpriteComponent, const TransformComponent, Changed<WorldTransformComponent>>(collect);
+    reg.ForEach<const SpriteComponent, const TransformComponent, Changed<SpriteComponent>>(collect);
+    std::sort(m_Changed.begin(), m_Changed.end());
+    m_Changed.erase(std::unique(m_Changed.begin(), m_Changed.end()), m_Changed.end());
+    for (Entity e : m_Changed) {
+        copyTransform(e, *reg.Get<SpriteComponent>(e), *std::as_const(reg).Get<TransformComponent>(e));
+    }
 
-    std::vector<DrawItem> opaque;
-    std::vector<DrawItem> transparent;
-    opaque.reserve(reg.AliveCount());
-    transparent.reserve(reg.AliveCount());
+    // Индекс ведётся, пока есть что отсекать и спрайтов много
+    if (cull && reg.Count<SpriteComponent>() >= spatialIndexThreshold) {
+        index = &UseSpriteSpatialIndex(reg);
+        if (!index->IsBuilt() || index->CellSize() != cellSize) {
+            index->Rebuild(cellSize);
+        }
+    } else if (index && index->IsBuilt()) {
+        index->Clear();
+    }
 
-    reg.ForEach<TransformComponent, SpriteComponent>([&](Entity, TransformComponent& transform, SpriteComponent& sprite) {
-        auto* tex = sprite.sprite.GetTexture().get();
-        if (!sprite.visible || !tex) {
-            return;
+    // Собираем видимые спрайты, затем сортируем их ключи один раз
+    m_Submitted = 0;
+    m_Culled = 0;
+    m_Draws.clear();
+    m_DrawEntities.clear();
+    if (index && index->IsBuilt()) {
+        m_Visible.clear();
+        index->Query(view, m_Visible);
+        m_Culled = static_cast<uint32_t>(index->Size() - m_Visible.size());
+        for (Entity e : m_Visible) {
+            m_Draws.push_back(std::as_const(reg).Get<SpriteComponent>(e));
+            m_DrawEntities.push_back(e);
         }
-        DrawItem item{sprite.layer, &sprite.sprite, &transform, tex, sprite.transparent};
-        (sprite.transparent ? transparent : opaque).push_back(item);
-    });
+    } else {
+        reg.ForEach<const SpriteComponent>([&](Entity e, const SpriteComponent& sprite) {
+            if (!sprite.visible || !sprite.sprite.GetTexture() || !reg.Has<TransformComponent>(e)) {
+                return;
+            }
+            if (cull && !sprite.bounds.Intersects(view)) {
+                ++m_Culled;
+                return;
+            }
+            m_Draws.push_back(&sprite);
+            m_DrawEntities.push_back(e);
+        });
+    }
 
-    auto sorter = [](const DrawItem& a, const DrawItem& b) {
-        if (a.layer != b.layer) return a.layer < b.layer;
-        // Remove texture sorting to preserve draw order (Painter's Algorithm)
-        // If we want depth sorting, we should use Y position, but for now rely on insertion order
-        return false; 
-    };
-    std::stable_sort(opaque.begin(), opaque.end(), sorter);
-    std::stable_sort(transparent.begin(), transparent.end(), sorter); // back-to-front по layer
-
-    auto drawList = [&](std::vector<DrawItem>& list) {
-        for (auto& item : list) {
-            item.sprite->transform.position = item.transform->position;
-            item.sprite->transform.scale = item.transform->scale;
-            item.sprite->transform.rotation = item.transform->rotation;
-            item.sprite->transform.origin = item.transform->origin;
-            if (m_DrawCallback) {
-                m_DrawCallback(*item.sprite);
-            } else {
-                // Submit to batch
-                Renderer::SubmitSprite(*item.sprite);
+    SubmitSorted(UseSpriteSequence(reg));
+
+    if (m_Culled > 0) {
+        Renderer::RecordCulledSprites(m_Culled);
+    }
+    Renderer::FlushSpriteBatch();
+}
+
+void SpriteRenderSystem::SubmitSorted(const SpriteSequence& sequence) {
+    // Глубина - позиция по Y, квантованная в диапазоне видимых спрайтов кадра
+    float minY = 0.0f;
+    float depthScale = 0.0f;
+    if (ySort != YSort::None && !m_Draws.empty()) {
+        minY = m_Draws.front()->sprite.transform.position.y;
+        float maxY = minY;
+        for (const SpriteComponent* sprite : m_Draws) {
+            minY = std::min(minY, sprite->sprite.transform.position.y);
+            maxY = std::max(maxY, sprite->sprite.transform.position.y);
+        }
+        if (maxY > minY) {
+            depthScale = static_cast<float>(SpriteSortKey::kMaxDepth) / (maxY - minY);
+        }
+    }
+
+    // Прозрачные нумеруются рангом отметки создания среди видимых за кадр:
+    // номер не зависит от индекса сущности и помещается в kSequenceBits
+    constexpr uint32_t kMaxRank = (1u << SpriteSortKey::kSequenceBits) - 1;
+    m_Translucent.clear();
+    for (size_t i = 0; i < m_Draws.size(); ++i) {
+        if (m_Draws[i]->transparent) {
+            m_Translucent.push_back({sequence.Of(m_DrawEntities[i]), static_cast<uint32_t>(i)});
+        }
+    }
+    RadixSort(m_Translucent, m_SortScratch);
+    m_Ranks.assign(m_Draws.size(), 0);
+    for (size_t rank = 0; rank < m_Translucent.size(); ++rank) {
+        m_Ranks[m_Translucent[rank].index] = static_cast<uint32_t>(std::min<size_t>(rank, kMaxRank));
+    }
+
+    // Непрозрачные спрайты одного слоя и глубины группируются по текстуре,
+    // прозрачные сохраняют порядок создания
+    m_Keys.resize(m_Draws.size());
+    for (size_t i = 0; i < m_Draws.size(); ++i) {
+        const SpriteComponent& sprite = *m_Draws[i];
+        uint32_t depth = 0;
+        if (ySort != YSort::None) {
+            depth = static_cast<uint32_t>((sprite.sprite.transform.position.y - minY) * depthScale);
+            if (ySort == YSort::Descending) {
+                depth = SpriteSortKey::kMaxDepth - std::min(depth, SpriteSortKey::kMaxDepth);
             }
         }
-    };
+        const uint32_t textureId = SpriteSortKey::TextureId(sprite.sprite.GetTexture().get());
+        m_Keys[i] = {SpriteSortKey::Make(sprite.transparent, sprite.layer, depth, m_Ranks[i], textureId),
+                     static_cast<uint32_t>(i)};
+    }
+    RadixSort(m_Keys, m_SortScratch);
 
-    // сначала непрозрачные, затем прозрачные для корректного альфа-блендинга
-    drawList(opaque);
-    drawList(transparent);
-    
-    Renderer::FlushSpriteBatch();
+    for (const SortEntry& entry : m_Keys) {
+        const Sprite& sprite = m_Draws[entry.index]->sprite;
+        if (m_DrawCallback) {
+            m_DrawCallback(sprite);
+        } else {
+            // Ключи уже по возрастанию: батчер не сортирует повторно
+            Renderer::SubmitSprite(sprite, entry.key);
+        }
+    }
+    m_Submitted = static_cast<uint32_t>(m_Keys.size());
 }
 
-void TilemapRenderSystem::Tick(Registry& reg, float /*deltaTime*/) {
-    Camera2D camera;
-    bool foundCamera = false;
-    
-    // Try to find an active camera component
-    reg.ForEach<CameraComponent, TransformComponent>([&](Entity, CameraComponent& cam, TransformComponent& trans) {
-        if (cam.active && !foundCamera) {
-            camera = cam.camera;
-            camera.SetPosition(trans.position);
-            foundCamera = true;
+SpriteSpatialIndex::SpriteSpatialIndex(Registry& registry) : m_Registry(&registry) {
+    registry.OnDestroy<SpriteComponent>().Connect<&SpriteSpatialIndex::OnRemove>(this);
+    registry.OnDestroy<TransformComponent>().Connect<&SpriteSpatialIndex::OnRemove>(this);
+}
+
+SpriteSpatialIndex::~SpriteSpatialIndex() {
+    m_Registry->OnDestroy<SpriteComponent>().Disconnect(this);
+    m_Registry->OnDestroy<TransformComponent>().Disconnect(this);
+}
+
+void SpriteSpatialIndex::Rebuild(float cellSize) {
+    Clear();
+    m_CellSize = cellSize;
+    m_Built = true;
+    m_Registry->ForEach<const SpriteComponent, const TransformComponent>(
+        [this](Entity e, const SpriteComponent& sprite, const TransformComponent&) { Update(e, sprite); });
+}
+
+void SpriteSpatialIndex::Clear() {
+    for (auto& [cell, list] : m_Cells) {
+        list.clear();
+    }
+    m_Large.clear();
+    std::fill(m_Entries.begin(), m_Entries.end(), Entry{});
+    m_Size = 0;
+    m_Built = false;
+}
+
+uint64_t SpriteSpatialIndex::CellOf(const Rect& bounds) const {
+    const auto x = static_cast<int32_t>(std::floor((bounds.x + bounds.width * 0.5f) / m_CellSize));
+    const auto y = static_cast<int32_t>(std::floor((bounds.y + bounds.height * 0.5f) / m_CellSize));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void SpriteSpatialIndex::Update(Entity e, const SpriteComponent& sprite) {
+    if (!m_Built) {
+        return;
+    }
+    const uint32_t index = detail::DecodeIndex(e);
+    if (index >= m_Entries.size()) {
+        m_Entries.resize(index + 1);
+    }
+    Entry& entry = m_Entries[index];
+    if (!sprite.visible || !sprite.sprite.GetTexture()) {
+        Remove(entry);
+        return;
+    }
+    const bool large = sprite.bounds.width > m_CellSize || sprite.bounds.height > m_CellSize;
+    const uint64_t cell = large ? 0 : CellOf(sprite.bounds);
+    if (entry.entity == e && entry.large == large && entry.cell == cell) {
+        return;
+    }
+    Remove(entry);
+
+    std::vector<Entity>& list = large ? m_Large : m_Cells[cell];
+    entry = {e, large, cell, static_cast<uint32_t>(list.size())};
+    list.push_back(e);
+    ++m_Size;
+}
+
+void SpriteSpatialIndex::Remove(Entry& entry) {
+    if (entry.entity == kInvalidEntity) {
+        return;
+    }
+    std::vector<Entity>& list = entry.large ? m_Large : m_Cells[entry.cell];
+    const Entity moved = list.back();
+    list[entry.slot] = moved;
+    m_Entries[detail::DecodeIndex(moved)].slot = entry.slot;
+    list.pop_back();
+    entry.entity = kInvalidEntity;
+    --m_Size;
+}
+
+void SpriteSpatialIndex::OnRemove(Registry& /*registry*/, Entity e) {
+    const uint32_t index = detail::DecodeIndex(e);
+    if (index < m_Entries.size() && m_Entries[index].entity == e) {
+        Remove(m_Entries[index]);
+    }
+}
+
+void SpriteSpatialIndex::Query(const Rect& view, std::vector<Entity>& out) const {
+    const Registry& registry = *m_Registry;
+    auto collect = [&](const std::vector<Entity>& list) {
+        for (Entity e : list) {
+            const auto* sprite = registry.Get<SpriteComponent>(e);
+            if (sprite && sprite->bounds.Intersects(view)) {
+                out.push_back(e);
+            }
         }
-    });
+    };
+
+    // Центр спрайта не крупнее ячейки лежит не дальше полуячейки от его краёв
+    const float half = m_CellSize * 0.5f;
+    const auto x0 = static_cast<int64_t>(std::floor((view.x - half) / m_CellSize));
+    const auto x1 = static_cast<int64_t>(std::floor((view.x + view.width + half) / m_CellSize));
+    const auto y0 = static_cast<int64_t>(std::floor((view.y - half) / m_CellSize));
+    const auto y1 = static_cast<int64_t>(std::floor((view.y + view.height + half) / m_CellSize));
+    if (static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1) <= m_Cells.size()) {
+        for (int64_t y = y0; y <= y1; ++y) {
+            for (int64_t x = x0; x <= x1; ++x) {
+                const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+                if (auto it = m_Cells.find(key); it != m_Cells.end()) {
+                    collect(it->second);
+                }
+            }
+        }
+    } else {
+        // Вид охватывает больше ячеек, чем занято: обходим занятые
+        for (const auto& [cell, list] : m_Cells) {
+            collect(list);
+        }
+    }
+    collect(m_Large);
+}
+
+SpriteSpatialIndex& UseSpriteSpatialIndex(Registry& reg) {
+    if (auto* index = reg.FindCtx<SpriteSpatialIndex>()) {
+        return *index;
+    }
+    return reg.EmplaceCtx<SpriteSpatialIndex>(reg);
+}
+
+SpriteSequence::SpriteSequence(Registry& registry) : m_Registry(&registry) {
+    registry.OnConstruct<SpriteComponent>().Connect<&SpriteSequence::OnConstruct>(this);
+    Reset();
+}
+
+SpriteSequence::~SpriteSequence() {
+    m_Registry->OnConstruct<SpriteComponent>().Disconnect(this);
+}
+
+void SpriteSequence::Reset() {
+    std::fill(m_Stamps.begin(), m_Stamps.end(), 0);
+    m_Next = 0;
+    m_Registry->ForEach<const SpriteComponent>(
+        [this](Entity e, const SpriteComponent&) { OnConstruct(*m_Registry, e); });
+}
+
+uint64_t SpriteSequence::Of(Entity e) const {
+    const uint32_t index = detail::DecodeIndex(e);
+    return index < m_Stamps.size() ? m_Stamps[index] : 0;
+}
+
+void SpriteSequence::OnConstruct(Registry& /*registry*/, Entity e) {
+    const uint32_t index = detail::DecodeIndex(e);
+    if (index >= m_Stamps.size()) {
+        m_Stamps.resize(index + 1, 0);
+    }
+    m_Stamps[index] = ++m_Next;
+}
 
+SpriteSequence& UseSpriteSequence(Registry& reg) {
+    if (auto* sequence = reg.FindCtx<SpriteSequence>()) {
+        return *sequence;
+    }
+    return reg.EmplaceCtx<SpriteSequence>(reg);
+}
+
+void TilemapRenderSystem::Tick(Registry& reg, float /*deltaTime*/) {
     auto* backend = Renderer::GetBackend();
     if (!backend) return;
 
-    if (foundCamera) {
-        backend->BeginSpriteBatch(&camera);
-    } else {
-        backend->BeginSpriteBatch(nullptr);
-    }
+    static const Camera2D kDefaultCamera;
+    const auto* active = GetActiveCamera(reg);
+    const Camera2D& camera = active ? active->camera : kDefaultCamera;
+    backend->BeginSpriteBatch(active ? &camera : nullptr);
 
-    reg.ForEach<TilemapComponent>([&](Entity, TilemapComponent& tc) {
+    reg.ForEach<const TilemapComponent>([&](Entity, const TilemapComponent& tc) {
         if (tc.visible && tc.tilemap) {
             tc.tilemap->Render(backend, camera);
         }
@@ -398,17 +707,247 @@ void TilemapRenderSystem::Tick(Registry& reg, float /*deltaTime*/) {
 }
 
 void MovementSystem::Tick(Registry& reg, float deltaTime) {
-    reg.ForEach<TransformComponent, VelocityComponent>([&reg, deltaTime](Entity e, TransformComponent& trans, VelocityComponent& vel) {
-        // Skip entities with RigidBodyComponent - let PhysicsSystem handle them
-        if (reg.Has<RigidBodyComponent>(e)) return;
+    // Сущности независимы: чанки плотного массива обрабатываются на воркерах.
+    // Тела с RigidBodyComponent двигает PhysicsSystem: отсекаются по сигнатуре.
+    // Сущности с SoAMotionTag интегрируются пакетно по своим потокам.
+    reg.ParallelForEach<TransformComponent, const VelocityComponent, Without<RigidBodyComponent, SoAMotionTag>>(
+        [deltaTime](Entity, TransformComponent& trans, const VelocityComponent& vel) {
+            trans.position += vel.velocity * deltaTime;
+            trans.rotation += vel.angularVelocity * deltaTime;
+        });
+    if (auto* streams = reg.FindCtx<MotionStreams>()) {
+        streams->Step(deltaTime);
+    }
+}
+
+namespace {
+    // Вынимает сущность из списка детей её родителя
+    void Unlink(Registry& reg, Entity e) {
+        auto* node = reg.Get<HierarchyComponent>(e);
+        if (!node || node->parent == kInvalidEntity) {
+            return;
+        }
+        if (node->prevSibling != kInvalidEntity) {
+            if (auto* prev = reg.Get<HierarchyComponent>(node->prevSibling)) prev->nextSibling = node->nextSibling;
+        } else if (auto* parent = reg.Get<HierarchyComponent>(node->parent)) {
+            parent->firstChild = node->nextSibling;
+        }
+        if (node->nextSibling != kInvalidEntity) {
+            if (auto* next = reg.Get<HierarchyComponent>(node->nextSibling)) next->prevSibling = node->prevSibling;
+        }
+        node->parent = kInvalidEntity;
+        node->prevSibling = kInvalidEntity;
+        node->nextSibling = kInvalidEntity;
+    }
+
+    // Узел уничтожается любым путём (DestroyEntity, DeathSystem,
+    // Deferred().Destroy): вынимаем его из списка родителя, дети становятся корнями
+    void OnHierarchyDestroyed(Registry& reg, Entity e) {
+        Unlink(reg, e);
+        auto* node = reg.Get<HierarchyComponent>(e);
+        for (Entity c = node ? node->firstChild : kInvalidEntity; c != kInvalidEntity;) {
+            auto* child = reg.Get<HierarchyComponent>(c);
+            if (!child) break;
+            c = child->nextSibling;
+            child->parent = kInvalidEntity;
+            child->prevSibling = kInvalidEntity;
+            child->nextSibling = kInvalidEntity;
+        }
+        if (node) node->firstChild = kInvalidEntity;
+    }
 
-        trans.position += vel.velocity * deltaTime;
-        trans.rotation += vel.angularVelocity * deltaTime;
+    void EnsureHierarchyComponents(Registry& reg, Entity e) {
+        if (!reg.Has<HierarchyComponent>(e)) reg.Add<HierarchyComponent>(e);
+        if (!reg.Has<WorldTransformComponent>(e)) reg.Add<WorldTransformComponent>(e);
+    }
+}
+
+void SetParent(Registry& reg, Entity child, Entity parent) {
+    if (!reg.IsAlive(child) || child == parent) {
+        return;
+    }
+    if (parent != kInvalidEntity) {
+        if (!reg.IsAlive(parent)) {
+            return;
+        }
+        // Родитель не может быть потомком ребёнка
+        for (Entity p = parent; p != kInvalidEntity;) {
+            if (p == child) {
+                SAGE_WARN("SetParent: entity {} is an ancestor of {}, ignored", child, parent);
+                return;
+            }
+            const auto* node = std::as_const(reg).Get<HierarchyComponent>(p);
+            p = node ? node->parent : kInvalidEntity;
+        }
+    }
+
+    Unlink(reg, child);
+    if (parent == kInvalidEntity) {
+        return;
+    }
+
+    // Обработчик уничтожения держит списки детей целыми; один на реестр
+    auto& onDestroy = reg.OnDestroy<HierarchyComponent>();
+    onDestroy.Disconnect<&OnHierarchyDestroyed>();
+    onDestroy.Connect<&OnHierarchyDestroyed>();
+
+    EnsureHierarchyComponents(reg, child);
+    EnsureHierarchyComponents(reg, parent);
+    auto* parentNode = reg.Get<HierarchyComponent>(parent);
+    auto* childNode = reg.Get<HierarchyComponent>(child);
+    childNode->parent = parent;
+    childNode->nextSibling = parentNode->firstChild;
+    if (parentNode->firstChild != kInvalidEntity) {
+        reg.Get<HierarchyComponent>(parentNode->firstChild)->prevSibling = child;
+    }
+    parentNode->firstChild = child;
+}
+
+void DestroyWithChildren(Registry& reg, Entity e) {
+    if (!reg.IsAlive(e)) {
+        return;
+    }
+    Unlink(reg, e);
+    std::vector<Entity> subtree{e};
+    for (size_t i = 0; i < subtree.size(); ++i) {
+        const auto* node = std::as_const(reg).Get<HierarchyComponent>(subtree[i]);
+        for (Entity c = node ? node->firstChild : kInvalidEntity; c != kInvalidEntity;) {
+            subtree.push_back(c);
+            const auto* childNode = std::as_const(reg).Get<HierarchyComponent>(c);
+            c = childNode ? childNode->nextSibling : kInvalidEntity;
+        }
+    }
+    for (Entity doomed : subtree) {
+        reg.DestroyEntity(doomed);
+    }
+}
+
+void TransformPropagationSystem::RebuildOrder(Registry& reg) {
+    const Registry& view = reg;
+    m_Order.clear();
+    m_Links.clear();
+    // Корни: без родителя (или родитель уже уничтожен). Дети берутся по
+    // ссылке parent, а не по списку братьев: битое звено списка не теряет
+    // оставшихся братьев и их поддеревья
+    reg.ForEach<const HierarchyComponent>([&](Entity e, const HierarchyComponent& node) {
+        if (node.parent == kInvalidEntity || !view.Has<HierarchyComponent>(node.parent)) {
+            m_Order.push_back({e, kRoot});
+        } else {
+            m_Links.emplace_back(node.parent, e);
+        }
     });
+    std::sort(m_Links.begin(), m_Links.end());
+    // Дети добавляются за родителями: обход в ширину по самому массиву
+    for (size_t i = 0; i < m_Order.size(); ++i) {
+        const Entity parent = m_Order[i].entity;
+        auto it = std::lower_bound(m_Links.begin(), m_Links.end(), std::make_pair(parent, Entity{0}));
+        for (; it != m_Links.end() && it->first == parent; ++it) {
+            m_Order.push_back({it->second, static_cast<uint32_t>(i)});
+        }
+    }
+    m_HierarchyCount = reg.Count<HierarchyComponent>();
+}
+
+void TransformPropagationSystem::Tick(Registry& reg, float /*deltaTime*/) {
+    const Registry& view = reg;
+
+    auto writeWorld = [](WorldTransformComponent& world, const WorldTransformComponent* parent, const TransformComponent& local) {
+        const Matrix3 localMatrix = Matrix3::TRS(local.position, local.rotation, local.scale);
+        if (parent) {
+            world.matrix = parent->matrix.MultiplyAffine(localMatrix);
+            world.position = {world.matrix.m[2], world.matrix.m[5]};
+            world.rotation = parent->rotation + local.rotation;
+            world.scale = {parent->scale.x * local.scale.x, parent->scale.y * local.scale.y};
+        } else {
+            world.matrix = localMatrix;
+            world.position = local.position;
+            world.rotation = local.rotation;
+            world.scale = local.scale;
+        }
+    };
+
+    // Сущности вне иерархии: мировой трансформ совпадает с локальным
+    auto copyLocal = [&](Entity e, WorldTransformComponent& world, const TransformComponent& local) {
+        if (!view.Has<HierarchyComponent>(e)) writeWorld(world, nullptr, local);
+    };
+    reg.ForEach<WorldTransformComponent, const TransformComponent, Changed<TransformComponent>>(copyLocal);
+    reg.ForEach<WorldTransformComponent, const TransformComponent, Added<WorldTransformComponent>>(copyLocal);
+
+    // Связи менялись (SetParent) или часть узлов удалена: порядок обхода устарел
+    bool rebuild = m_HierarchyCount != reg.Count<HierarchyComponent>();
+    reg.ForEach<const HierarchyComponent, Changed<HierarchyComponent>>([&](Entity, const HierarchyComponent&) {
+        rebuild = true;
+    });
+    if (rebuild) {
+        RebuildOrder(reg);
+    }
+
+    m_Worlds.assign(m_Order.size(), nullptr);
+    m_Dirty.assign(m_Order.size(), rebuild ? 1 : 0);
+    for (size_t i = 0; i < m_Order.size(); ++i) {
+        const Node& node = m_Order[i];
+        const WorldTransformComponent* parentWorld = node.parent == kRoot ? nullptr : m_Worlds[node.parent];
+        m_Worlds[i] = view.Get<WorldTransformComponent>(node.entity);
+
+        const bool dirty = m_Dirty[i]
+            || (node.parent != kRoot && m_Dirty[node.parent])
+            || view.IsChanged<TransformComponent>(node.entity)
+            || view.IsAdded<WorldTransformComponent>(node.entity);
+        if (!dirty || !m_Worlds[i]) {
+            continue;
+        }
+        m_Dirty[i] = 1;
+
+        static const TransformComponent kIdentity{};
+        const auto* local = view.Get<TransformComponent>(node.entity);
+        writeWorld(*reg.Get<WorldTransformComponent>(node.entity), parentWorld, local ? *local : kIdentity);
+    }
+}
+
+void SpatialReorderSystem::Tick(Registry& reg, float /*deltaTime*/) {
+    if (reg.GetStorageMode() != StorageMode::SparseSet) {
+        return; // порядок в архетипах задаётся чанками
+    }
+    const size_t count = reg.Count<TransformComponent>();
+    if (count < 2) {
+        return;
+    }
+    const float cell = cellSize;
+    auto key = [cell](const TransformComponent& t) { return Morton::FromPosition(t.position, cell); };
+
+    // Первый запуск или размер пула изменился вдвое: полная сортировка
+    if (m_SortedCount == 0 || count > m_SortedCount * 2 || count * 2 < m_SortedCount) {
+        reg.SortByKey<TransformComponent>(key);
+        SyncRelatedPools(reg);
+        m_SortedCount = count;
+        m_Cursor = 0;
+        return;
+    }
+
+    const size_t window = std::clamp<size_t>(static_cast<size_t>(static_cast<float>(count) * fractionPerFrame),
+                                             std::min(kMinWindow, count), count);
+    if (m_Cursor >= count) {
+        m_Cursor = 0;
+    }
+    reg.SortByKey<TransformComponent>(key, m_Cursor, m_Cursor + window);
+    // Перекрытие окон даёт сущностям переходить из окна в окно
+    m_Cursor += std::max<size_t>(window / 2, 1);
+    if (m_Cursor + window / 2 >= count) {
+        m_Cursor = 0;
+        SyncRelatedPools(reg);
+    }
+}
+
+void SpatialReorderSystem::SyncRelatedPools(Registry& reg) {
+    reg.SortAs<WorldTransformComponent, TransformComponent>();
+    reg.SortAs<VelocityComponent, TransformComponent>();
+    reg.SortAs<ColliderComponent, TransformComponent>();
+    reg.SortAs<RigidBodyComponent, TransformComponent>();
+    reg.SortAs<PhysicsColliderComponent, TransformComponent>();
 }
 
 void PathFollowSystem::Tick(Registry& reg, float deltaTime) {
-    reg.ForEach<TransformComponent, PathFollowerComponent>([deltaTime](Entity, TransformComponent& trans, PathFollowerComponent& follower) {
+    reg.ParallelForEach<TransformComponent, PathFollowerComponent>([deltaTime](Entity, TransformComponent& trans, PathFollowerComponent& follower) {
         if (!follower.active || !follower.path) return;
 
         // Update t
@@ -447,43 +986,150 @@ void PathFollowSystem::Tick(Registry& reg, float deltaTime) {
     });
 }
 
+namespace {
+    // Ячейки одной строки попадают в соседние корзины, так что соседи 3x3 —
+    // три непрерывных участка памяти вместо девяти случайных
+    uint32_t CellHash(int32_t x, int32_t y) {
+        return static_cast<uint32_t>(y) * 2654435761u + static_cast<uint32_t>(x);
+    }
+}
+
 void CollisionSystem::Tick(Registry& reg, float /*deltaTime*/) {
-    std::vector<Entity> colliders;
-    colliders.reserve(reg.AliveCount());
-    reg.ForEach<ColliderComponent, TransformComponent>([&](Entity e, ColliderComponent&, TransformComponent&) {
-        colliders.push_back(e);
+    std::swap(m_Pairs, m_PrevPairs);
+    m_Pairs.clear();
+    m_Boxes.clear();
+    reg.ForEach<ColliderComponent, const TransformComponent>([this](Entity e, ColliderComponent& c, const TransformComponent& t) {
+        c.colliding = false;
+        const Rect r = Rect::FromCenter(t.position + c.offset, c.size);
+        m_Boxes.push_back({r.Left(), r.Bottom(), r.Right(), r.Top(), 0, 0, e, &c});
     });
 
-    // Reset colliding flags
-    for (auto e : colliders) {
-        if (auto* c = reg.Get<ColliderComponent>(e)) {
-            c->colliding = false;
-        }
-    }
-
-    for (size_t i = 0; i < colliders.size(); ++i) {
-        for (size_t j = i + 1; j < colliders.size(); ++j) {
-            Entity a = colliders[i];
-            Entity b = colliders[j];
-            auto* ca = reg.Get<ColliderComponent>(a);
-            auto* cb = reg.Get<ColliderComponent>(b);
-            auto* ta = reg.Get<TransformComponent>(a);
-            auto* tb = reg.Get<TransformComponent>(b);
-            if (!ca || !cb || !ta || !tb) continue;
-
-            Rect ra = Rect::FromCenter(ta->position + ca->offset, ca->size);
-            Rect rb = Rect::FromCenter(tb->position + cb->offset, cb->size);
-            if (ra.Intersects(rb)) {
-                ca->colliding = true;
-                cb->colliding = true;
-                // Доп. обработка (триггеры/урон) оставляем игровой логике
+    if (m_Boxes.size() > 1) {
+        BuildGrid();
+        FindPairs();
+        std::sort(m_Pairs.begin(), m_Pairs.end(), [](const Pair& l, const Pair& r) { return l.Key() < r.Key(); });
+    }
+    EmitEvents();
+}
+
+void CollisionSystem::BuildGrid() {
+    float extentSum = 0.0f;
+    for (const Box& box : m_Boxes) {
+        extentSum += std::max(box.maxX - box.minX, box.maxY - box.minY);
+    }
+    const float cell = std::max(2.0f * extentSum / static_cast<float>(m_Boxes.size()), 1.0f);
+    const float invCell = 1.0f / cell;
+
+    size_t buckets = 1;
+    while (buckets < m_Boxes.size() * 2) {
+        buckets <<= 1;
+    }
+    m_BucketMask = static_cast<uint32_t>(buckets - 1);
+    m_BucketStart.assign(buckets + 1, 0);
+    m_BucketOf.resize(m_Boxes.size());
+    m_Large.clear();
+
+    // Сортировка подсчётом по корзинам: соседи по ячейке лежат подряд
+    for (size_t i = 0; i < m_Boxes.size(); ++i) {
+        Box& box = m_Boxes[i];
+        if (box.maxX - box.minX > cell || box.maxY - box.minY > cell) {
+            m_Large.push_back(box);
+            m_BucketOf[i] = kNoBucket;
+            continue;
+        }
+        box.cellX = static_cast<int32_t>(std::floor(box.minX * invCell));
+        box.cellY = static_cast<int32_t>(std::floor(box.minY * invCell));
+        m_BucketOf[i] = CellHash(box.cellX, box.cellY) & m_BucketMask;
+        ++m_BucketStart[m_BucketOf[i] + 1];
+    }
+    for (size_t b = 1; b < m_BucketStart.size(); ++b) {
+        m_BucketStart[b] += m_BucketStart[b - 1];
+    }
+    m_Grid.resize(m_BucketStart.back());
+    for (size_t i = 0; i < m_Boxes.size(); ++i) {
+        if (m_BucketOf[i] != kNoBucket) {
+            // m_BucketStart[b] сдвигается к концу корзины b
+            m_Grid[m_BucketStart[m_BucketOf[i]]++] = m_Boxes[i];
+        }
+    }
+    // Конец корзины b - 1 и есть начало корзины b
+    for (size_t b = m_BucketStart.size() - 1; b > 0; --b) {
+        m_BucketStart[b] = m_BucketStart[b - 1];
+    }
+    m_BucketStart[0] = 0;
+}
+
+void CollisionSystem::FindPairs() {
+    auto overlaps = [](const Box& l, const Box& r) {
+        // Как Rect::Intersects: касание считается пересечением
+        return !(l.maxX < r.minX || l.minX > r.maxX || l.maxY < r.minY || l.minY > r.maxY);
+    };
+
+    // Оба не крупнее ячейки: нижние углы пересекающихся отстоят меньше чем
+    // на ячейку, значит лежат в соседних ячейках
+    for (uint32_t i = 0; i < m_Grid.size(); ++i) {
+        Box& box = m_Grid[i];
+        uint32_t visited[9];
+        int visitedCount = 0;
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                const uint32_t bucket = CellHash(box.cellX + dx, box.cellY + dy) & m_BucketMask;
+                // Разные ячейки могут попасть в одну корзину
+                if (std::find(visited, visited + visitedCount, bucket) != visited + visitedCount) {
+                    continue;
+                }
+                visited[visitedCount++] = bucket;
+                for (uint32_t j = std::max(m_BucketStart[bucket], i + 1); j < m_BucketStart[bucket + 1]; ++j) {
+                    if (overlaps(box, m_Grid[j])) {
+                        AddPair(box, m_Grid[j]);
+                    }
+                }
             }
         }
     }
+
+    for (size_t l = 0; l < m_Large.size(); ++l) {
+        Box& large = m_Large[l];
+        for (Box& other : m_Grid) {
+            if (overlaps(large, other)) {
+                AddPair(large, other);
+            }
+        }
+        for (size_t m = l + 1; m < m_Large.size(); ++m) {
+            if (overlaps(large, m_Large[m])) {
+                AddPair(large, m_Large[m]);
+            }
+        }
+    }
+}
+
+void CollisionSystem::AddPair(Box& first, Box& second) {
+    first.collider->colliding = true;
+    second.collider->colliding = true;
+    m_Pairs.push_back({std::min(first.entity, second.entity), std::max(first.entity, second.entity)});
+}
+
+void CollisionSystem::EmitEvents() {
+    m_Events.clear();
+    size_t cur = 0;
+    size_t prev = 0;
+    while (cur < m_Pairs.size() || prev < m_PrevPairs.size()) {
+        if (prev == m_PrevPairs.size() || (cur < m_Pairs.size() && m_Pairs[cur].Key() < m_PrevPairs[prev].Key())) {
+            m_Events.push_back({Event::Type::Enter, m_Pairs[cur].a, m_Pairs[cur].b});
+            ++cur;
+        } else if (cur == m_Pairs.size() || m_PrevPairs[prev].Key() < m_Pairs[cur].Key()) {
+            m_Events.push_back({Event::Type::Exit, m_PrevPairs[prev].a, m_PrevPairs[prev].b});
+            ++prev;
+        } else {
+            m_Events.push_back({Event::Type::Stay, m_Pairs[cur].a, m_Pairs[cur].b});
+            ++cur;
+            ++prev;
+        }
+    }
 }
 
 void GroundCheckSystem::Tick(Registry& reg, float /*deltaTime*/) {
-    reg.ForEach<PlayerMovementComponent, TransformComponent, PhysicsColliderComponent>([&](Entity, PlayerMovementComponent& move, TransformComponent& trans, PhysicsColliderComponent& col) {
+    reg.ForEach<PlayerMovementComponent, const TransformComponent, const PhysicsColliderComponent>([&](Entity, PlayerMovementComponent& move, const TransformComponent& trans, const PhysicsColliderComponent& col) {
         // Raycast down to check for ground
         // Start from the bottom of the collider
         float halfHeight = col.size.y * 0.5f;
@@ -498,8 +1144,8 @@ void GroundCheckSystem::Tick(Registry& reg, float /*deltaTime*/) {
 }
 
 void PlatformBehaviorSystem::Tick(Registry& reg, float /*deltaTime*/) {
-    reg.ForEach<PlatformBehaviorComponent, TransformComponent, RigidBodyComponent, PhysicsColliderComponent>(
-        [&](Entity, PlatformBehaviorComponent& pb, TransformComponent& trans, RigidBodyComponent& rb, PhysicsColliderComponent& col) {
+    reg.ForEach<const PlatformBehaviorComponent, const TransformComponent, const RigidBodyComponent, const PhysicsColliderComponent>(
+        [&](Entity, const PlatformBehaviorComponent& pb, const TransformComponent& trans, const RigidBodyComponent& rb, const PhysicsColliderComponent& col) {
             if (!pb.stayOnPlatform || !rb.IsValid()) return;
 
             Vector2 velocity = m_PhysicsWorld.GetLinearVelocity(rb.bodyHandle);
@@ -525,8 +1171,8 @@ void PlatformBehaviorSystem::Tick(Registry& reg, float /*deltaTime*/) {
     );
 }
 
-void PlayerInputSystem::Tick(Registry& reg, float deltaTime) {
-    reg.ForEach<PlayerTag, VelocityComponent, PlayerMovementComponent>([this, deltaTime, &reg](Entity e, PlayerTag&, VelocityComponent& vel, PlayerMovementComponent& move) {
+void PlayerInputSystem::Tick(Registry& reg, float /*deltaTime*/) {
+    reg.ForEach<With<PlayerTag>, VelocityComponent, const PlayerMovementComponent, Optional<const InputComponent>>([this](Entity, VelocityComponent& vel, const PlayerMovementComponent& move, const InputComponent* ic) {
         float speed = move.moveSpeed > 0.0f ? move.moveSpeed : moveSpeed;
         vel.velocity = {0.0f, 0.0f};
         auto state = m_Provider ? m_Provider() : InputState{
@@ -537,7 +1183,7 @@ void PlayerInputSystem::Tick(Registry& reg, float deltaTime) {
             Input::IsKeyDown(KeyCode::Space)
         };
 
-        if (auto* ic = reg.Get<InputComponent>(e)) {
+        if (ic) {
             state.left = ic->left;
             state.right = ic->right;
             state.up = ic->up;
@@ -553,15 +1199,10 @@ void PlayerInputSystem::Tick(Registry& reg, float deltaTime) {
 }
 
 void CameraFollowSystem::Tick(Registry& reg, float deltaTime) {
-    // Find active camera
-    CameraComponent* activeCam = nullptr;
-    reg.ForEach<CameraComponent>([&](Entity, CameraComponent& cam) {
-        if (cam.active) activeCam = &cam;
-    });
-    
+    CameraComponent* activeCam = GetActiveCamera(reg);
     if (!activeCam) return;
 
-    reg.ForEach<CameraFollowComponent, TransformComponent>([&](Entity, CameraFollowComponent& follow, TransformComponent& t) {
+    reg.ForEach<const CameraFollowComponent, const TransformComponent>([&](Entity, const CameraFollowComponent& follow, const TransformComponent& t) {
         // Простой линейный интерполяционный фоллоу
         Vector2 target = t.position;
         Vector2 current = activeCam->camera.GetPosition();
@@ -573,54 +1214,142 @@ void CameraFollowSystem::Tick(Registry& reg, float deltaTime) {
     });
 }
 
-void AudioSystem::Tick(Registry& reg, float /*deltaTime*/) {
+void AudioSystem::Tick(Registry& reg, float deltaTime) {
     // 1. Update Listener Position (Camera)
-    bool listenerSet = false;
-    reg.ForEach<CameraComponent, TransformComponent>([&](Entity, CameraComponent& cam, TransformComponent& trans) {
-        if (cam.active && !listenerSet) {
-            Audio::SetListenerPosition(trans.position);
-            listenerSet = true;
+    Vector2 listener{0.0f, 0.0f};
+    if (GetActiveCamera(reg)) {
+        if (const auto* trans = std::as_const(reg).Get<TransformComponent>(reg.Ctx<ActiveCamera>().entity)) {
+            listener = trans->position;
+            Audio::SetListenerPosition(listener);
         }
-    });
+    }
 
-    // 2. Update Audio Components
-    reg.ForEach<AudioComponent>([&](Entity e, AudioComponent& audio) {
+    // 2. Свойства уходят в Sound только у изменённых компонентов
+    reg.ForEach<AudioComponent, Changed<AudioComponent>>([&reg](Entity e, AudioComponent& audio) {
         // Load sound if needed
         if (!audio.sound && !audio.path.empty()) {
-            SoundType type = SoundType::Static;
-            if (audio.path.find(".ogg") != std::string::npos || audio.path.find(".mp3") != std::string::npos) {
-                type = SoundType::Stream;
-            }
-            audio.sound = Sound::Create(audio.path, type);
+            const std::string_view path = audio.path;
+            const bool stream = path.ends_with(".ogg") || path.ends_with(".mp3");
+            audio.sound = Sound::Create(audio.path, stream ? SoundType::Stream : SoundType::Static);
         }
-
         if (!audio.sound) return;
 
-        // Update properties
         audio.sound->SetLooping(audio.loop);
         audio.sound->SetVolume(audio.volume);
         audio.sound->SetSpatial(audio.spatial);
-        
         if (audio.spatial) {
             audio.sound->SetMinDistance(audio.minDistance);
             audio.sound->SetMaxDistance(audio.maxDistance);
-            
-            // Update position if entity has transform
-            if (auto* trans = reg.Get<TransformComponent>(e)) {
+            if (const auto* trans = std::as_const(reg).Get<TransformComponent>(e)) {
                 audio.sound->SetPosition(trans->position);
             }
         }
+    });
+    reg.ForEach<const AudioComponent, const TransformComponent, Changed<TransformComponent>>(
+        [](Entity, const AudioComponent& audio, const TransformComponent& trans) {
+            if (audio.sound && audio.spatial) {
+                audio.sound->SetPosition(trans.position);
+            }
+        });
 
-        // Handle Play Request
-        if (audio.playRequested && !audio.sound->IsPlaying()) {
-            audio.sound->Play();
-            audio.playRequested = false;
+    // 3. Жизненный цикл голосов: запуск, окончание, курсор виртуальных.
+    // Проход читающий: в компонент пишем, только если состояние изменилось
+    m_Audible.clear();
+    reg.ForEach<const AudioComponent>([&](Entity e, const AudioComponent& audio) {
+        if (!audio.sound) return;
+
+        bool requested = audio.playRequested;
+        bool playing = audio.playing;
+        bool virtualVoice = audio.virtualVoice;
+        float cursor = audio.cursor;
+        const bool loaded = audio.sound->IsLoaded();
+        if (requested && !playing) {
+            // Новый голос стартует виртуальным с нуля; реальным его сделает отбор ниже.
+            // Незагруженному звуку играть нечего: запрос просто снимается
+            playing = loaded;
+            virtualVoice = loaded;
+            cursor = 0.0f;
+            requested = false;
+        } else if (!loaded) {
+            playing = false; // не загрузился или выгружен: слот голоса не держим
+        } else if (playing && virtualVoice) {
+            cursor += deltaTime;
+            const float length = audio.sound->GetLength();
+            if (length > 0.0f && cursor >= length) {
+                if (audio.loop) {
+                    cursor = std::fmod(cursor, length);
+                } else {
+                    playing = false;
+                }
+            }
+        } else if (playing && !audio.sound->IsPlaying()) {
+            playing = false; // доиграл или остановлен напрямую через Sound
         }
+        if (!playing) {
+            virtualVoice = false;
+            cursor = 0.0f;
+        }
+
+        if (requested != audio.playRequested || playing != audio.playing
+            || virtualVoice != audio.virtualVoice || cursor != audio.cursor) {
+            AudioComponent& state = *reg.Get<AudioComponent>(e);
+            state.playRequested = requested;
+            state.playing = playing;
+            state.virtualVoice = virtualVoice;
+            state.cursor = cursor;
+        }
+        if (!playing) return;
+
+        float priority = -1.0f;
+        if (audio.spatial) {
+            const auto* trans = std::as_const(reg).Get<TransformComponent>(e);
+            const Vector2 offset = (trans ? trans->position : Vector2{0.0f, 0.0f}) - listener;
+            priority = offset.x * offset.x + offset.y * offset.y;
+            if (priority > audio.maxDistance * audio.maxDistance) {
+                priority = std::numeric_limits<float>::infinity(); // вне слышимости
+            }
+        }
+        m_Audible.push_back({e, &audio, priority});
     });
+
+    // 4. Реальными остаются слышимые ближайшие, не больше maxRealVoices;
+    // компонент трогаем только у голосов, сменивших режим
+    const size_t realCount = SelectRealVoices(m_Audible, maxRealVoices);
+    m_RealVoices = static_cast<uint32_t>(realCount);
+    m_VirtualVoices = static_cast<uint32_t>(m_Audible.size() - realCount);
+    for (size_t i = 0; i < m_Audible.size(); ++i) {
+        const bool real = i < realCount;
+        if (real != m_Audible[i].audio->virtualVoice) {
+            continue; // режим не меняется
+        }
+        AudioComponent& audio = *reg.Get<AudioComponent>(m_Audible[i].entity);
+        if (real) {
+            audio.sound->Seek(audio.cursor);
+            audio.sound->Play();
+            audio.virtualVoice = false;
+        } else {
+            audio.cursor = audio.sound->GetCursor();
+            audio.sound->Pause();
+            audio.virtualVoice = true;
+        }
+    }
+}
+
+size_t AudioSystem::SelectRealVoices(std::span<Voice> voices, size_t maxReal) {
+    auto inRange = [](const Voice& voice) { return voice.priority != std::numeric_limits<float>::infinity(); };
+    const auto audible = std::partition(voices.begin(), voices.end(), inRange);
+    const size_t count = static_cast<size_t>(audible - voices.begin());
+    if (count <= maxReal) {
+        return count;
+    }
+    const auto split = voices.begin() + static_cast<std::ptrdiff_t>(maxReal);
+    std::nth_element(voices.begin(), split, audible,
+                     [](const Voice& a, const Voice& b) { return a.priority < b.priority; });
+    return maxReal;
 }
 
 void StatsSystem::Tick(Registry& reg, float deltaTime) {
-    reg.ForEach<StatsComponent>([this, deltaTime](Entity, StatsComponent& stats) {
+    reg.ParallelForEach<StatsComponent>([this, deltaTime](Entity, StatsComponent& stats) {
         // Регенерация
         if (regenHealthPerSec > 0.0f) {
             stats.health = std::min(stats.maxHealth, stats.health + static_cast<int>(regenHealthPerSec * deltaTime));
@@ -647,7 +1376,7 @@ void InputStateSystem::Tick(Registry& reg, float /*deltaTime*/) {
 }
 
 void ParticleSystemSystem::Tick(Registry& reg, float deltaTime) {
-    reg.ForEach<ParticleEmitterComponent, TransformComponent>([deltaTime](Entity, ParticleEmitterComponent& emitter, TransformComponent& t) {
+    reg.ForEach<ParticleEmitterComponent, const TransformComponent>([this, deltaTime](Entity, ParticleEmitterComponent& emitter, const TransformComponent& t) {
         if (!emitter.system) {
             return;
         }
@@ -664,27 +1393,30 @@ void ParticleSystemSystem::Tick(Registry& reg, float deltaTime) {
 
         emitter.system->Update(deltaTime);
 
-        // Рендерим частицы как квадраты
+        // Все живые частицы эмиттера - один пакет квадратов
+        m_Instances.clear();
+        // Живые частицы собраны в начале массива
         const auto& particles = emitter.system->GetParticles();
-        for (const auto& p : particles) {
+        const size_t activeCount = std::min(emitter.system->GetActiveCount(), particles.size());
+        for (size_t i = 0; i < activeCount; ++i) {
+            const Particle& p = particles[i];
             if (!p.active) continue;
             Color c = p.color;
             c.a *= std::max(0.0f, 1.0f - (p.age / p.lifetime) * p.fadeOut);
-            Renderer::DrawParticle(t.position + p.position, p.size, c, p.rotation);
+            m_Instances.push_back({t.position + p.position, p.size, p.rotation, c});
         }
+        Renderer::DrawParticles(m_Instances, emitter.system->GetTexture().get());
     });
 }
 
 void DeathSystem::Tick(Registry& reg, float /*deltaTime*/) {
-    std::vector<Entity> toDestroy;
-    reg.ForEach<HealthComponent>([&](Entity e, HealthComponent& h) {
+    // Удаление откладывается до ближайшей точки синхронизации планировщика
+    CommandBuffer& commands = reg.Deferred();
+    reg.ForEach<const HealthComponent>([&](Entity e, const HealthComponent& h) {
         if (h.IsDead()) {
-            toDestroy.push_back(e);
+            commands.Destroy(e);
         }
     });
-    for (auto e : toDestroy) {
-        reg.DestroyEntity(e);
-    }
 }
 
 void HudRenderSystem::Tick(Registry&, float) {
@@ -743,7 +1475,7 @@ Entity RaycastSystem::RaycastFromScreen(Registry& reg, const Vector2& screenPos,
     Entity hitEntity = kInvalidEntity;
     int maxLayer = -1; // To handle overlapping sprites/bodies, pick the one on top (highest layer)
 
-    reg.ForEach<TransformComponent, PhysicsColliderComponent>([&](Entity e, TransformComponent& trans, PhysicsColliderComponent& col) {
+    reg.ForEach<const TransformComponent, const PhysicsColliderComponent>([&](Entity e, const TransformComponent& trans, const PhysicsColliderComponent& col) {
         // Calculate collider world position/shape
         // Assuming Box for now
         if (col.shape == ColliderShape::Box) {
@@ -0,0 +1,190 @@
+#include "SAGE/Core/JobSystem.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace SAGE {
+
+namespace {
+    // Which pool/queue the current thread works for (workers only)
+    thread_local const JobSystem* tl_Owner = nullptr;
+    thread_local uint32_t tl_QueueIndex = 0;
+}
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    m_Queues.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_Queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    m_Workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stopping = true;
+    }
+    m_WakeCondition.notify_all();
+    for (auto& worker : m_Workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+uint32_t JobSystem::DefaultWorkerCount() {
+    const uint32_t hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 0;
+}
+
+void JobSystem::Submit(Job job) {
+    if (!job) {
+        return;
+    }
+
+    if (m_Workers.empty()) {
+        job();
+        return;
+    }
+
+    // Workers keep their own jobs local; other threads spread them round-robin
+    const uint32_t index = tl_Owner == this
+        ? tl_QueueIndex
+        : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(m_Queues.size());
+    // Counted before it is visible, so a thief never takes the count below zero
+    m_Pending.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_Queues[index]->mutex);
+        m_Queues[index]->jobs.push_back(std::move(job));
+    }
+    {
+        // Pairs with the predicate check in WorkerLoop so the wake-up is not lost
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_WakeCondition.notify_one();
+}
+
+bool JobSystem::RunPendingJob() {
+    if (m_Queues.empty() || m_Pending.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Job job;
+    const bool isWorker = tl_Owner == this;
+    const uint32_t start = isWorker ? tl_QueueIndex : 0;
+    if ((isWorker && PopOwn(start, job)) || Steal(start, job)) {
+        m_Pending.fetch_sub(1, std::memory_order_relaxed);
+        job();
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const RangeJob& fn) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (m_Workers.empty() || chunkCount == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Chunks are claimed from a shared counter, so fast threads take more of them
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto runChunks = [&]() {
+        while (!failed.load(std::memory_order_relaxed)) {
+            const size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount) {
+                return;
+            }
+            const size_t begin = chunk * grainSize;
+            try {
+                fn(begin, std::min(count, begin + grainSize));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    const size_t helperCount = std::min<size_t>(m_Workers.size(), chunkCount - 1);
+    std::atomic<size_t> activeHelpers{helperCount};
+    for (size_t i = 0; i < helperCount; ++i) {
+        Submit([&]() {
+            runChunks();
+            activeHelpers.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    runChunks();
+
+    // Helpers reference this frame: wait until every one has left
+    while (activeHelpers.load(std::memory_order_acquire) != 0) {
+        if (!RunPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool JobSystem::PopOwn(uint32_t index, Job& job) {
+    WorkerQueue& queue = *m_Queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::Steal(uint32_t start, Job& job) {
+    const uint32_t count = static_cast<uint32_t>(m_Queues.size());
+    for (uint32_t offset = 0; offset < count; ++offset) {
+        WorkerQueue& queue = *m_Queues[(start + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::WorkerLoop(uint32_t index) {
+    tl_Owner = this;
+    tl_QueueIndex = index;
+
+    for (;;) {
+        Job job;
+        if (PopOwn(index, job) || Steal(index + 1, job)) {
+            m_Pending.fetch_sub(1, std::memory_order_relaxed);
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_WakeCondition.wait(lock, [this]() {
+            return m_Stopping || m_Pending.load(std::memory_order_acquire) > 0;
+        });
+        if (m_Stopping && m_Pending.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+} // namespace SAGE
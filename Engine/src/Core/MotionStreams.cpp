@@ -0,0 +1,251 @@
+#include "SAGE/Core/MotionStreams.h"
+#include "SAGE/Core/JobSystem.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define SAGE_MOTION_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SAGE_MOTION_SSE2 1
+#endif
+
+namespace SAGE::ECS {
+
+namespace {
+    // Слотов на задачу при параллельном шаге; кратно ширине AVX2-итерации
+    constexpr size_t kSlotsPerJob = 16 * 1024;
+
+    // value[i] += rate[i] * dt. Умножение и сложение раздельно (без FMA),
+    // поэтому векторный путь совпадает со скалярным до бита.
+    void Advance(float* value, const float* rate, size_t count, float dt) {
+        size_t i = 0;
+#if defined(SAGE_MOTION_AVX2)
+        const __m256 step = _mm256_set1_ps(dt);
+        for (; i + 16 <= count; i += 16) {
+            const __m256 a = _mm256_add_ps(_mm256_loadu_ps(value + i), _mm256_mul_ps(_mm256_loadu_ps(rate + i), step));
+            const __m256 b = _mm256_add_ps(_mm256_loadu_ps(value + i + 8), _mm256_mul_ps(_mm256_loadu_ps(rate + i + 8), step));
+            _mm256_storeu_ps(value + i, a);
+            _mm256_storeu_ps(value + i + 8, b);
+        }
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(value + i, _mm256_add_ps(_mm256_loadu_ps(value + i), _mm256_mul_ps(_mm256_loadu_ps(rate + i), step)));
+        }
+#elif defined(SAGE_MOTION_SSE2)
+        const __m128 step = _mm_set1_ps(dt);
+        for (; i + 8 <= count; i += 8) {
+            const __m128 a = _mm_add_ps(_mm_loadu_ps(value + i), _mm_mul_ps(_mm_loadu_ps(rate + i), step));
+            const __m128 b = _mm_add_ps(_mm_loadu_ps(value + i + 4), _mm_mul_ps(_mm_loadu_ps(rate + i + 4), step));
+            _mm_storeu_ps(value + i, a);
+            _mm_storeu_ps(value + i + 4, b);
+        }
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(value + i), _mm_mul_ps(_mm_loadu_ps(rate + i), step)));
+        }
+#endif
+        for (; i < count; ++i) {
+            value[i] += rate[i] * dt;
+        }
+    }
+}
+
+void IntegrateMotion(float* x, float* y, float* rotation,
+                     const float* velocityX, const float* velocityY, const float* angularVelocity,
+                     size_t count, float deltaTime) {
+    Advance(x, velocityX, count, deltaTime);
+    Advance(y, velocityY, count, deltaTime);
+    Advance(rotation, angularVelocity, count, deltaTime);
+}
+
+const char* MotionSimdPath() {
+#if defined(SAGE_MOTION_AVX2)
+    return "AVX2";
+#elif defined(SAGE_MOTION_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+MotionStreams::MotionStreams(Registry& registry) : m_Registry(&registry) {
+    registry.OnConstruct<SoAMotionTag>().Connect<&MotionStreams::OnAttach>(this);
+    registry.OnDestroy<SoAMotionTag>().Connect<&MotionStreams::OnDetach>(this);
+    registry.OnConstruct<RigidBodyComponent>().Connect<&MotionStreams::OnBodyAttach>(this);
+    registry.OnDestroy<RigidBodyComponent>().Connect<&MotionStreams::OnBodyDetach>(this);
+    Rebuild();
+}
+
+MotionStreams::~MotionStreams() {
+    m_Registry->OnConstruct<SoAMotionTag>().Disconnect(this);
+    m_Registry->OnDestroy<SoAMotionTag>().Disconnect(this);
+    m_Registry->OnConstruct<RigidBodyComponent>().Disconnect(this);
+    m_Registry->OnDestroy<RigidBodyComponent>().Disconnect(this);
+}
+
+uint32_t MotionStreams::SlotOf(Entity e) const {
+    const uint32_t index = detail::DecodeIndex(e);
+    if (index >= m_Slots.size() || m_Slots[index] == kNoSlot || m_Entities[m_Slots[index]] != e) {
+        return kNoSlot;
+    }
+    return m_Slots[index];
+}
+
+TransformProxy MotionStreams::Transform(Entity e) {
+    const uint32_t slot = SlotOf(e);
+    auto* transform = slot != kNoSlot ? m_Registry->Get<TransformComponent>(e) : nullptr;
+    if (!transform) {
+        throw std::logic_error("ECS: entity has no SoA motion slot or TransformComponent");
+    }
+    return TransformProxy(m_X[slot], m_Y[slot], m_Rotation[slot], *transform);
+}
+
+void MotionStreams::Step(float deltaTime) {
+    if (m_Entities.empty()) {
+        return;
+    }
+    Pull();
+    Integrate(deltaTime);
+    if (writeBack) {
+        WriteBack();
+    }
+}
+
+void MotionStreams::Rebuild() {
+    for (Entity e : m_Entities) {
+        m_Slots[detail::DecodeIndex(e)] = kNoSlot;
+    }
+    m_Entities.clear();
+    m_X.clear();
+    m_Y.clear();
+    m_Rotation.clear();
+    m_VelocityX.clear();
+    m_VelocityY.clear();
+    m_AngularVelocity.clear();
+    m_Registry->ForEach<With<SoAMotionTag>>([this](Entity e) { OnAttach(*m_Registry, e); });
+}
+
+void MotionStreams::OnAttach(Registry& registry, Entity e) {
+    if (Contains(e)) {
+        return;
+    }
+    const uint32_t index = detail::DecodeIndex(e);
+    if (index >= m_Slots.size()) {
+        m_Slots.resize(index + 1, kNoSlot);
+    }
+    m_Slots[index] = static_cast<uint32_t>(m_Entities.size());
+    m_Entities.push_back(e);
+
+    const Registry& view = registry;
+    const auto* transform = view.Get<TransformComponent>(e);
+    m_X.push_back(transform ? transform->position.x : 0.0f);
+    m_Y.push_back(transform ? transform->position.y : 0.0f);
+    m_Rotation.push_back(transform ? transform->rotation : 0.0f);
+    m_VelocityX.push_back(0.0f);
+    m_VelocityY.push_back(0.0f);
+    m_AngularVelocity.push_back(0.0f);
+    LoadVelocity(view, e, m_Slots[index], view.Has<RigidBodyComponent>(e));
+}
+
+void MotionStreams::LoadVelocity(const Registry& registry, Entity e, uint32_t slot, bool body) {
+    // Тело двигает PhysicsSystem: нулевая скорость, чтобы не сдвинуть его второй раз
+    const auto* velocity = body ? nullptr : registry.Get<VelocityComponent>(e);
+    m_VelocityX[slot] = velocity ? velocity->velocity.x : 0.0f;
+    m_VelocityY[slot] = velocity ? velocity->velocity.y : 0.0f;
+    m_AngularVelocity[slot] = velocity ? velocity->angularVelocity : 0.0f;
+}
+
+void MotionStreams::OnBodyAttach(Registry& registry, Entity e) {
+    if (const uint32_t slot = SlotOf(e); slot != kNoSlot) {
+        LoadVelocity(registry, e, slot, true);
+    }
+}
+
+void MotionStreams::OnBodyDetach(Registry& registry, Entity e) {
+    // Сигнал приходит до удаления тела
+    if (const uint32_t slot = SlotOf(e); slot != kNoSlot) {
+        LoadVelocity(registry, e, slot, false);
+    }
+}
+
+void MotionStreams::OnDetach(Registry& registry, Entity e) {
+    const uint32_t slot = SlotOf(e);
+    if (slot == kNoSlot) {
+        return;
+    }
+    // Компонент остаётся с последним состоянием потоков
+    if (auto* transform = registry.Get<TransformComponent>(e)) {
+        transform->position = {m_X[slot], m_Y[slot]};
+        transform->rotation = m_Rotation[slot];
+    }
+
+    const uint32_t last = static_cast<uint32_t>(m_Entities.size() - 1);
+    auto moveLast = [slot, last](std::vector<float>& stream) {
+        stream[slot] = stream[last];
+        stream.pop_back();
+    };
+    moveLast(m_X);
+    moveLast(m_Y);
+    moveLast(m_Rotation);
+    moveLast(m_VelocityX);
+    moveLast(m_VelocityY);
+    moveLast(m_AngularVelocity);
+    m_Slots[detail::DecodeIndex(m_Entities[last])] = slot;
+    m_Entities[slot] = m_Entities[last];
+    m_Entities.pop_back();
+    m_Slots[detail::DecodeIndex(e)] = kNoSlot;
+}
+
+void MotionStreams::Pull() {
+    // Своя запись в WriteBack помечена тиком прошлого запуска системы и
+    // сюда не попадает; остальное — внешние правки компонентов
+    if (writeBack) {
+        m_Registry->ForEach<const TransformComponent, Changed<TransformComponent>, With<SoAMotionTag>>(
+            [this](Entity e, const TransformComponent& transform) {
+                const uint32_t slot = SlotOf(e);
+                m_X[slot] = transform.position.x;
+                m_Y[slot] = transform.position.y;
+                m_Rotation[slot] = transform.rotation;
+            });
+    }
+    m_Registry->ForEach<const VelocityComponent, Changed<VelocityComponent>, With<SoAMotionTag>, Without<RigidBodyComponent>>(
+        [this](Entity e, const VelocityComponent& velocity) {
+            const uint32_t slot = SlotOf(e);
+            m_VelocityX[slot] = velocity.velocity.x;
+            m_VelocityY[slot] = velocity.velocity.y;
+            m_AngularVelocity[slot] = velocity.angularVelocity;
+        });
+}
+
+void MotionStreams::Integrate(float deltaTime) {
+    auto run = [&](size_t begin, size_t end) {
+        IntegrateMotion(m_X.data() + begin, m_Y.data() + begin, m_Rotation.data() + begin,
+                        m_VelocityX.data() + begin, m_VelocityY.data() + begin, m_AngularVelocity.data() + begin,
+                        end - begin, deltaTime);
+    };
+    JobSystem* jobs = m_Registry->GetJobSystem();
+    if (!jobs || m_Entities.size() <= kSlotsPerJob) {
+        run(0, m_Entities.size());
+        return;
+    }
+    jobs->ParallelFor(m_Entities.size(), kSlotsPerJob, run);
+}
+
+void MotionStreams::WriteBack() {
+    m_Registry->ParallelForEach<TransformComponent, With<SoAMotionTag>, Without<RigidBodyComponent>>([this](Entity e, TransformComponent& transform) {
+        const uint32_t slot = m_Slots[detail::DecodeIndex(e)];
+        transform.position = {m_X[slot], m_Y[slot]};
+        transform.rotation = m_Rotation[slot];
+    });
+}
+
+MotionStreams& UseMotionStreams(Registry& reg) {
+    if (auto* streams = reg.FindCtx<MotionStreams>()) {
+        return *streams;
+    }
+    return reg.EmplaceCtx<MotionStreams>(reg);
+}
+
+} // namespace SAGE::ECS
@@ -35,8 +35,14 @@ void Profiler::EndScope(const std::string& name) {
     
     // Calculate duration in milliseconds
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    double durationMs = duration.count() / 1000.0;
-    
+    AddSample(name, duration.count() / 1000.0);
+}
+
+void Profiler::AddSample(const std::string& name, double durationMs) {
+    if (!m_Enabled) {
+        return;
+    }
+
     // Update scope data
     auto& scope = m_Scopes[name];
     scope.samples.push_back(durationMs);
@@ -52,6 +58,18 @@ void Profiler::EndScope(const std::string& name) {
     scope.max = std::max(scope.max, durationMs);
 }
 
+namespace {
+    // Nearest-rank 99th percentile of the kept samples
+    double Percentile99(std::vector<double> samples) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        const size_t rank = (samples.size() * 99 + 99) / 100 - 1;
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank];
+    }
+}
+
 std::vector<Profiler::ProfileResult> Profiler::GetResults() const {
     std::vector<ProfileResult> results;
     results.reserve(m_Scopes.size());
@@ -63,6 +81,7 @@ std::vector<Profiler::ProfileResult> Profiler::GetResults() const {
         result.totalMs = scope.total;
         result.minMs = scope.min;
         result.maxMs = scope.max;
+        result.p99Ms = Percentile99(scope.samples);
         
         if (!scope.samples.empty()) {
             result.averageMs = scope.total / scope.samples.size();
@@ -94,6 +113,7 @@ Profiler::ProfileResult Profiler::GetResult(const std::string& name) const {
     result.totalMs = scope.total;
     result.minMs = scope.min;
     result.maxMs = scope.max;
+    result.p99Ms = Percentile99(scope.samples);
     
     if (!scope.samples.empty()) {
         result.averageMs = scope.total / scope.samples.size();
@@ -1,12 +1,19 @@
 #include "SAGE/Core/Scene.h"
 #include "SAGE/Core/ECSSystems.h"
 #include "SAGE/Core/Prefab.h"
+#include "SAGE/Application.h"
 
 namespace SAGE {
 
 Scene::Scene(const std::string& name)
     : m_Name(name)
 {
+    // Use the engine worker pool when running inside an application
+    if (Application* app = GetActiveApplication()) {
+        m_Registry.SetJobSystem(&app->GetJobSystem());
+        m_Scheduler.SetJobSystem(&app->GetJobSystem());
+    }
+
     // Register core systems
     m_Scheduler.AddSystem<ECS::NativeScriptSystem>(this);
     m_Scheduler.AddSystem<ECS::CameraSystem>();
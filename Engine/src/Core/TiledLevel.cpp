@@ -10,6 +10,10 @@ void TiledLevelBuilder::Build(const TiledLevel& level, Registry& reg, const Buil
     const size_t rows = level.grid.size();
     const size_t cols = level.grid[0].size();
 
+    // Сначала собираем тайлы, затем создаём сущности и компоненты пачками:
+    // таблица сущностей и массивы пулов растут один раз, а не на каждый тайл
+    std::vector<const TileDefinition*> tiles;
+    std::vector<TransformComponent> transforms;
     for (size_t y = 0; y < rows; ++y) {
         for (size_t x = 0; x < cols; ++x) {
             char id = level.grid[y][x];
@@ -17,38 +21,55 @@ void TiledLevelBuilder::Build(const TiledLevel& level, Registry& reg, const Buil
             if (it == level.definitions.end()) {
                 continue; // неизвестный id трактуем как "воздух"
             }
-            const TileDefinition& def = it->second;
             // позиция — центр тайла
-            Vector2 pos{
+            TransformComponent t;
+            t.position = {
                 level.origin.x + static_cast<float>(x) * level.tileSize.x + level.tileSize.x * 0.5f,
                 level.origin.y + static_cast<float>(y) * level.tileSize.y + level.tileSize.y * 0.5f
             };
-
-            Entity e = reg.CreateEntity();
-            auto& t = reg.Add<TransformComponent>(e);
-            t.position = pos;
             t.scale = level.tileSize;
+            tiles.push_back(&it->second);
+            transforms.push_back(t);
+        }
+    }
 
-            if (def.texture) {
-                auto& s = reg.Add<SpriteComponent>(e);
-                s.layer = opts.renderLayer;
-                s.transparent = def.transparent;
-                s.sprite.SetTexture(def.texture);
-            }
+    std::vector<Entity> entities(tiles.size());
+    reg.CreateEntities(entities.size(), entities);
+    reg.Insert<TransformComponent>(entities, transforms);
 
-            if (def.solid) {
-                auto& c = reg.Add<ColliderComponent>(e);
-                c.size = level.tileSize;
-            }
+    std::vector<Entity> spriteEntities;
+    std::vector<SpriteComponent> sprites;
+    std::vector<Entity> solidEntities;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const TileDefinition& def = *tiles[i];
+        if (def.texture) {
+            SpriteComponent s;
+            s.layer = opts.renderLayer;
+            s.transparent = def.transparent;
+            s.sprite.SetTexture(def.texture);
+            spriteEntities.push_back(entities[i]);
+            sprites.push_back(std::move(s));
+        }
+        if (def.solid) {
+            solidEntities.push_back(entities[i]);
+        }
+    }
+    reg.Insert<SpriteComponent>(spriteEntities, sprites);
 
-            if (def.onSpawn) {
-                def.onSpawn(e, reg);
-            }
+    ColliderComponent tileCollider;
+    tileCollider.size = level.tileSize;
+    reg.Insert<ColliderComponent>(solidEntities, tileCollider);
+
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (tiles[i]->onSpawn) {
+            tiles[i]->onSpawn(entities[i], reg);
         }
     }
 
     // Merging solid colliders по строкам для снижения числа коллайдеров
     if (opts.mergeSolidColliders) {
+        std::vector<TransformComponent> segmentTransforms;
+        std::vector<ColliderComponent> segmentColliders;
         for (size_t y = 0; y < rows; ++y) {
             size_t x = 0;
             while (x < cols) {
@@ -74,14 +95,20 @@ void TiledLevelBuilder::Build(const TiledLevel& level, Registry& reg, const Buil
                     level.origin.x + (static_cast<float>(start) + (static_cast<float>(end - start) * 0.5f)) * level.tileSize.x,
                     level.origin.y + static_cast<float>(y) * level.tileSize.y + level.tileSize.y * 0.5f
                 };
-                Entity seg = reg.CreateEntity();
-                auto& tSeg = reg.Add<TransformComponent>(seg);
+                TransformComponent tSeg;
                 tSeg.position = pos;
                 tSeg.scale = {width, level.tileSize.y};
-                auto& cSeg = reg.Add<ColliderComponent>(seg);
+                ColliderComponent cSeg;
                 cSeg.size = {width, level.tileSize.y};
+                segmentTransforms.push_back(tSeg);
+                segmentColliders.push_back(cSeg);
             }
         }
+
+        std::vector<Entity> segments(segmentTransforms.size());
+        reg.CreateEntities(segments.size(), segments);
+        reg.Insert<TransformComponent>(segments, segmentTransforms);
+        reg.Insert<ColliderComponent>(segments, segmentColliders);
     }
 }
 
@@ -407,9 +407,18 @@ void OpenGLRenderBackend::SubmitSprite(const Sprite& sprite) {
     if (!m_Initialized) {
         return;
     }
+    m_Stats.spritesSubmitted++;
     m_SpriteRenderer.Submit(sprite);
 }
 
+void OpenGLRenderBackend::SubmitSprite(const Sprite& sprite, uint64_t sortKey) {
+    if (!m_Initialized) {
+        return;
+    }
+    m_Stats.spritesSubmitted++;
+    m_SpriteRenderer.Submit(sprite, sortKey);
+}
+
 void OpenGLRenderBackend::FlushSpriteBatch() {
     if (!m_Initialized) {
         return;
@@ -420,6 +429,10 @@ void OpenGLRenderBackend::FlushSpriteBatch() {
     m_Stats.triangles += batchStats.triangles;
 }
 
+void OpenGLRenderBackend::RecordCulledSprites(uint32_t count) {
+    m_Stats.spritesCulled += count;
+}
+
 void OpenGLRenderBackend::DrawParticle(const Vector2& position, float size, const Color& color, float rotation) {
     if (!m_Initialized || !m_DefaultShader) {
         return;
@@ -447,6 +460,16 @@ void OpenGLRenderBackend::DrawParticle(const Vector2& position, float size, cons
     m_Stats.triangles += 2;
 }
 
+void OpenGLRenderBackend::DrawParticles(std::span<const ParticleInstance> particles, Texture* texture) {
+    if (!m_Initialized || particles.empty()) {
+        return;
+    }
+    const auto batchStats = m_SpriteRenderer.DrawParticles(m_ViewProjection, particles, texture);
+    m_Stats.drawCalls += batchStats.drawCalls;
+    m_Stats.vertices += batchStats.vertices;
+    m_Stats.triangles += batchStats.triangles;
+}
+
 void OpenGLRenderBackend::SetProjectionMatrix(const Matrix3& projection) {
     m_Projection = projection;
     m_ViewProjection = m_Projection * m_View;
@@ -46,9 +46,12 @@ public:
 
     void BeginSpriteBatch(const Camera2D* camera) override;
     void SubmitSprite(const Sprite& sprite) override;
+    void SubmitSprite(const Sprite& sprite, uint64_t sortKey) override;
     void FlushSpriteBatch() override;
+    void RecordCulledSprites(uint32_t count) override;
 
     void DrawParticle(const Vector2& position, float size, const Color& color, float rotation) override;
+    void DrawParticles(std::span<const ParticleInstance> particles, Texture* texture) override;
 
     void SetProjectionMatrix(const Matrix3& projection) override;
     void SetViewMatrix(const Matrix3& view) override;
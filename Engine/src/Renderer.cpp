@@ -489,12 +489,33 @@ void Renderer::SubmitSprite(const Sprite& sprite) {
     }
 }
 
+void Renderer::SubmitSprite(const Sprite& sprite, uint64_t sortKey) {
+    if (auto* backend = RequireBackend("SubmitSprite")) {
+        backend->SubmitSprite(sprite, sortKey);
+    }
+}
+
 void Renderer::FlushSpriteBatch() {
     if (auto* backend = RequireBackend("FlushSpriteBatch")) {
         backend->FlushSpriteBatch();
     }
 }
 
+void Renderer::RecordCulledSprites(uint32_t count) {
+    if (auto* backend = RequireBackend("RecordCulledSprites")) {
+        backend->RecordCulledSprites(count);
+    }
+}
+
+void Renderer::DrawParticles(std::span<const ParticleInstance> particles, Texture* texture) {
+    if (particles.empty()) {
+        return;
+    }
+    if (auto* backend = RequireBackend("DrawParticles")) {
+        backend->DrawParticles(particles, texture);
+    }
+}
+
 void Renderer::DrawParticle(const Vector2& position, float size, const Color& color, float rotation) {
     if (auto* backend = RequireBackend("DrawParticle")) {
         backend->DrawParticle(position, size, color, rotation);
@@ -1,5 +1,7 @@
 #include "SAGE/Graphics/Sprite.h"
 
+#include <cmath>
+
 namespace SAGE {
 
 Sprite::Sprite(std::shared_ptr<Texture> texture)
@@ -28,4 +30,27 @@ Rect Sprite::GetBounds() const {
     return Rect(pos.x, pos.y, sz.x, sz.y);
 }
 
+Rect Sprite::GetWorldBounds() const {
+    if (!m_Texture) {
+        return {transform.position.x, transform.position.y, 0.0f, 0.0f};
+    }
+    const float uvWidth = textureRect.width != 0.0f ? textureRect.width : 1.0f;
+    const float uvHeight = textureRect.height != 0.0f ? textureRect.height : 1.0f;
+    const float width = static_cast<float>(m_Texture->GetWidth()) * uvWidth * transform.scale.x;
+    const float height = static_cast<float>(m_Texture->GetHeight()) * uvHeight * transform.scale.y;
+
+    // Quad centre relative to the pivot, rotated around the position
+    const float localX = width * (0.5f - transform.origin.x);
+    const float localY = height * (0.5f - transform.origin.y);
+    const float c = std::cos(transform.rotation);
+    const float s = std::sin(transform.rotation);
+    const float centerX = transform.position.x + c * localX - s * localY;
+    const float centerY = transform.position.y + s * localX + c * localY;
+    const float halfX = std::abs(width) * 0.5f;
+    const float halfY = std::abs(height) * 0.5f;
+    const float extentX = std::abs(c) * halfX + std::abs(s) * halfY;
+    const float extentY = std::abs(s) * halfX + std::abs(c) * halfY;
+    return {centerX - extentX, centerY - extentY, extentX * 2.0f, extentY * 2.0f};
+}
+
 } // namespace SAGE
@@ -1,10 +1,12 @@
 #include "SAGE/Graphics/SpriteRenderer.h"
 #include "SAGE/Graphics/Shader.h"
+#include "SAGE/Graphics/SpriteSortKey.h"
 #include "SAGE/Log.h"
 
 #include <glad/glad.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace SAGE {
 
@@ -57,6 +59,7 @@ namespace {
         
         // Uniforms
         uniform sampler2D uTexture;
+        uniform int uUseTexture;   // 0: untextured quads (particles without a texture)
         
         // Optional: gamma correction (set to 2.2 for sRGB)
         const float GAMMA = 2.2;
@@ -73,7 +76,7 @@ namespace {
         
         void main() {
             // Sample texture
-            vec4 texColor = texture(uTexture, vTexCoord);
+            vec4 texColor = uUseTexture != 0 ? texture(uTexture, vTexCoord) : vec4(1.0);
             
             // Multiply by vertex color (tint)
             vec4 finalColor = texColor * vColor;
@@ -146,6 +149,8 @@ void SpriteRenderer::Shutdown() {
     m_Shader.reset();
 
     m_Commands.clear();
+    m_Order.clear();
+    m_SortScratch.clear();
     m_VertexBuffer.clear();
     m_IndexBuffer.clear();
 
@@ -159,9 +164,17 @@ void SpriteRenderer::Begin(const Matrix3& projection) {
 
     m_Projection = projection;
     m_Commands.clear();
+    m_Order.clear();
+    m_LastKey = 0;
+    m_Presorted = true;
 }
 
 void SpriteRenderer::Submit(const Sprite& sprite) {
+    const auto texture = sprite.GetTexture();
+    Submit(sprite, SpriteSortKey::Make(false, sprite.layer, 0, 0, SpriteSortKey::TextureId(texture.get())));
+}
+
+void SpriteRenderer::Submit(const Sprite& sprite, uint64_t sortKey) {
     if (!sprite.visible) {
         return;
     }
@@ -187,7 +200,6 @@ void SpriteRenderer::Submit(const Sprite& sprite) {
 
     cmd.origin = sprite.transform.origin;
     cmd.texture = texture;
-    cmd.layer = sprite.layer;
     cmd.flipX = sprite.flipX;
     cmd.flipY = sprite.flipY;
 
@@ -205,6 +217,11 @@ void SpriteRenderer::Submit(const Sprite& sprite) {
     cmd.transform = Matrix3::Translation(sprite.transform.position) *
                     Matrix3::Rotation(sprite.transform.rotation);
 
+    if (sortKey < m_LastKey) {
+        m_Presorted = false;
+    }
+    m_LastKey = sortKey;
+    m_Order.push_back({sortKey, static_cast<uint32_t>(m_Commands.size())});
     m_Commands.emplace_back(std::move(cmd));
 }
 
@@ -215,35 +232,29 @@ SpriteRenderer::BatchStats SpriteRenderer::Flush() {
         return totals;
     }
 
-    std::sort(m_Commands.begin(), m_Commands.end(), [](const SpriteCommand& a, const SpriteCommand& b) {
-        if (a.layer == b.layer) {
-            return a.texture.get() < b.texture.get();
-        }
-        return a.layer < b.layer;
-    });
+    // Callers that submit in key order (SpriteRenderSystem) already paid for the sort
+    if (!m_Presorted) {
+        RadixSort(m_Order, m_SortScratch);
+    }
 
     EnsureGPUResources();
 
     m_Shader->Bind();
     m_Shader->SetMat3("uProjection", m_Projection.m.data());
     m_Shader->SetInt("uTexture", 0);
+    m_Shader->SetInt("uUseTexture", 1);
 
     glBindVertexArray(m_VAO);
 
+    // Consecutive draws sharing a texture form one batch; the key order already
+    // interleaves layers and translucency correctly.
     size_t batchStart = 0;
-    while (batchStart < m_Commands.size()) {
-        if (batchStart >= m_Commands.size()) {
-            break;
-        }
-        const auto* currentTexture = m_Commands[batchStart].texture.get();
-        const int currentLayer = m_Commands[batchStart].layer;
+    while (batchStart < m_Order.size()) {
+        const auto* currentTexture = m_Commands[m_Order[batchStart].index].texture.get();
 
         size_t batchEnd = batchStart + 1;
-        while (batchEnd < m_Commands.size()) {
-            const auto& candidate = m_Commands[batchEnd];
-            if (candidate.layer != currentLayer || candidate.texture.get() != currentTexture) {
-                break;
-            }
+        while (batchEnd < m_Order.size() &&
+               m_Commands[m_Order[batchEnd].index].texture.get() == currentTexture) {
             ++batchEnd;
         }
 
@@ -263,7 +274,7 @@ SpriteRenderer::BatchStats SpriteRenderer::Flush() {
         m_VertexBuffer.reserve(currentBatchSize * 4);
 
         for (size_t i = batchStart; i < batchStart + currentBatchSize; ++i) {
-            const auto& cmd = m_Commands[i];
+            const auto& cmd = m_Commands[m_Order[i].index];
 
             const float width = cmd.size.x;
             const float height = cmd.size.y;
@@ -311,39 +322,100 @@ SpriteRenderer::BatchStats SpriteRenderer::Flush() {
             continue;
         }
 
-        // Check if we have space in the buffer
-        if (m_BufferOffset + currentBatchSize * 4 > MaxVertices) {
-            // Orphan the buffer
-            glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-            glBufferData(GL_ARRAY_BUFFER, MaxVertices * sizeof(SpriteVertex), nullptr, GL_DYNAMIC_DRAW);
-            m_BufferOffset = 0;
-        }
-
-        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, m_BufferOffset * sizeof(SpriteVertex), static_cast<GLsizeiptr>(m_VertexBuffer.size() * sizeof(SpriteVertex)), m_VertexBuffer.data());
-
-        m_Commands[batchStart].texture->Bind(0);
-        
-        // Use DrawElementsBaseVertex to draw from the correct offset
-        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(currentBatchSize * 6), GL_UNSIGNED_INT, nullptr, static_cast<GLint>(m_BufferOffset));
-
-        m_BufferOffset += static_cast<uint32_t>(currentBatchSize * 4);
-
-        totals.drawCalls++;
-        totals.vertices += static_cast<uint32_t>(m_VertexBuffer.size());
-        totals.triangles += static_cast<uint32_t>(currentBatchSize * 2);
+        m_Commands[m_Order[batchStart].index].texture->Bind(0);
+        DrawVertexBuffer(totals);
 
         batchStart += currentBatchSize;
     }
 
     glBindVertexArray(0);
     m_Commands.clear();
+    m_Order.clear();
+    m_LastKey = 0;
+    m_Presorted = true;
     // Reset buffer offset at end of frame? No, keep it for next frame (ring buffer across frames)
     // But we need to ensure we don't overflow if we don't reset.
     // The check `m_BufferOffset + ... > MaxVertices` handles it.
     return totals;
 }
 
+SpriteRenderer::BatchStats SpriteRenderer::DrawParticles(const Matrix3& projection,
+                                                         std::span<const ParticleInstance> particles,
+                                                         Texture* texture) {
+    BatchStats totals{};
+    if (particles.empty()) {
+        return totals;
+    }
+    if (!m_Initialized) {
+        Init();
+    }
+    EnsureGPUResources();
+
+    const bool textured = texture && texture->IsLoaded();
+    m_Shader->Bind();
+    m_Shader->SetMat3("uProjection", projection.m.data());
+    m_Shader->SetInt("uTexture", 0);
+    m_Shader->SetInt("uUseTexture", textured ? 1 : 0);
+    if (textured) {
+        texture->Bind(0);
+    }
+
+    // Same Y-up UV flip as Submit
+    const float v0 = projection.m[4] > 0.0f ? 1.0f : 0.0f;
+    const float v1 = 1.0f - v0;
+    const Vector2 texCoords[4] = {{0.0f, v0}, {1.0f, v0}, {1.0f, v1}, {0.0f, v1}};
+
+    glBindVertexArray(m_VAO);
+    for (size_t start = 0; start < particles.size(); start += MaxSprites) {
+        const size_t count = std::min(particles.size() - start, static_cast<size_t>(MaxSprites));
+        m_VertexBuffer.clear();
+        m_VertexBuffer.reserve(count * 4);
+        for (const ParticleInstance& particle : particles.subspan(start, count)) {
+            const float half = particle.size * 0.5f;
+            const float c = std::cos(particle.rotation) * half;
+            const float s = std::sin(particle.rotation) * half;
+            // Corners (-1,-1), (1,-1), (1,1), (-1,1) scaled by half size and rotated
+            const Vector2 positions[4] = {
+                {particle.position.x - c + s, particle.position.y - s - c},
+                {particle.position.x + c + s, particle.position.y + s - c},
+                {particle.position.x + c - s, particle.position.y + s + c},
+                {particle.position.x - c - s, particle.position.y - s + c}
+            };
+            for (int vert = 0; vert < 4; ++vert) {
+                m_VertexBuffer.push_back({positions[vert], texCoords[vert], particle.color});
+            }
+        }
+        DrawVertexBuffer(totals);
+    }
+    glBindVertexArray(0);
+    return totals;
+}
+
+void SpriteRenderer::DrawVertexBuffer(BatchStats& totals) {
+    const size_t vertexCount = m_VertexBuffer.size();
+    const size_t quadCount = vertexCount / 4;
+
+    // Check if we have space in the buffer
+    if (m_BufferOffset + vertexCount > MaxVertices) {
+        // Orphan the buffer
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        glBufferData(GL_ARRAY_BUFFER, MaxVertices * sizeof(SpriteVertex), nullptr, GL_DYNAMIC_DRAW);
+        m_BufferOffset = 0;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, m_BufferOffset * sizeof(SpriteVertex), static_cast<GLsizeiptr>(vertexCount * sizeof(SpriteVertex)), m_VertexBuffer.data());
+
+    // Use DrawElementsBaseVertex to draw from the correct offset
+    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(quadCount * 6), GL_UNSIGNED_INT, nullptr, static_cast<GLint>(m_BufferOffset));
+
+    m_BufferOffset += static_cast<uint32_t>(vertexCount);
+
+    totals.drawCalls++;
+    totals.vertices += static_cast<uint32_t>(vertexCount);
+    totals.triangles += static_cast<uint32_t>(quadCount * 2);
+}
+
 void SpriteRenderer::EnsureGPUResources() {
     if (m_VAO != 0 && m_VBO != 0 && m_EBO != 0) {
         return;
@@ -115,3 +115,31 @@ TEST_CASE("Camera2D properties", "[camera][graphics]") {
         REQUIRE(screenPos.y == Catch::Approx(540.0f).margin(2.5f));
     }
 }
+
+TEST_CASE("Camera2D world bounds", "[camera][graphics]") {
+    Camera2D camera(200.0f, 100.0f);
+    camera.SetPosition({50.0f, 10.0f});
+
+    SECTION("Zoom shrinks the visible area") {
+        camera.SetZoom(2.0f);
+        Rect bounds = camera.GetWorldBounds();
+        REQUIRE(bounds.x == Catch::Approx(0.0f).margin(0.01f));
+        REQUIRE(bounds.y == Catch::Approx(-15.0f).margin(0.01f));
+        REQUIRE(bounds.width == Catch::Approx(100.0f).margin(0.01f));
+        REQUIRE(bounds.height == Catch::Approx(50.0f).margin(0.01f));
+    }
+
+    SECTION("Rotation widens the AABB") {
+        camera.SetZoom(1.0f);
+        camera.SetRotation(1.5707963f);
+        Rect bounds = camera.GetWorldBounds();
+        REQUIRE(bounds.width == Catch::Approx(100.0f).margin(0.01f));
+        REQUIRE(bounds.height == Catch::Approx(200.0f).margin(0.01f));
+        REQUIRE((bounds.x + bounds.width * 0.5f) == Catch::Approx(50.0f).margin(0.01f));
+    }
+
+    SECTION("Empty viewport") {
+        Camera2D empty;
+        REQUIRE(empty.GetWorldBounds().width == 0.0f);
+    }
+}
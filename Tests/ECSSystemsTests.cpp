@@ -2,9 +2,18 @@
 #include <SAGE/Core/ECS.h>
 #include <SAGE/Core/ECSComponents.h>
 #include <SAGE/Core/ECSSystems.h>
+#include <SAGE/Core/MotionStreams.h>
 #include <SAGE/Graphics/Camera2D.h>
+#include <SAGE/Graphics/SpriteSortKey.h>
+#include <SAGE/Math/Morton.h>
 #include "OpenGLStub.h"
 
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
 using namespace SAGE;
 using namespace SAGE::ECS;
 using Catch::Approx;
@@ -78,7 +87,7 @@ TEST_CASE("SpriteRenderSystem applies transform and respects layer ordering via
     reg.Get<SpriteComponent>(eTransparent)->transparent = true;
 
     std::vector<float> drawOrder;
-    renderer.SetDrawCallback([&](Sprite& sprite) {
+    renderer.SetDrawCallback([&](const Sprite& sprite) {
         drawOrder.push_back(sprite.transform.position.x);
     });
 
@@ -91,6 +100,222 @@ TEST_CASE("SpriteRenderSystem applies transform and respects layer ordering via
     REQUIRE(drawOrder[2] == Approx(10.0f));
 }
 
+TEST_CASE("SpriteRenderSystem orders draws by sort key", "[ecs][systems]") {
+    Registry reg;
+    SpriteRenderSystem renderer;
+    auto texA = std::make_shared<Texture>();
+    auto texB = std::make_shared<Texture>();
+
+    auto makeEntity = [&](int layer, const Vector2& pos, const std::shared_ptr<Texture>& tex, bool transparent) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = pos;
+        auto& s = reg.Add<SpriteComponent>(e);
+        s.layer = layer;
+        s.transparent = transparent;
+        s.sprite.SetTexture(tex);
+        return e;
+    };
+
+    std::vector<const Sprite*> order;
+    renderer.SetDrawCallback([&](const Sprite& sprite) { order.push_back(&sprite); });
+    auto textureOrder = [&]() {
+        std::vector<Texture*> textures;
+        for (const Sprite* sprite : order) textures.push_back(sprite->GetTexture().get());
+        return textures;
+    };
+
+    SECTION("Opaque sprites of a layer are grouped by texture") {
+        for (int i = 0; i < 6; ++i) {
+            makeEntity(0, {static_cast<float>(i), 0.0f}, i % 2 ? texA : texB, false);
+        }
+        renderer.Tick(reg, 0.016f);
+        REQUIRE(order.size() == 6);
+        auto textures = textureOrder();
+        if (SpriteSortKey::TextureId(texA.get()) != SpriteSortKey::TextureId(texB.get())) {
+            // Одна смена текстуры на слой - один батч на текстуру
+            size_t switches = 0;
+            for (size_t i = 1; i < textures.size(); ++i) {
+                switches += textures[i] != textures[i - 1];
+            }
+            REQUIRE(switches == 1);
+        }
+    }
+
+    SECTION("Translucent sprites keep creation order and Y-sort orders by depth") {
+        // Прозрачные рисуются после непрозрачных из прошлой секции: берём хвост
+        const float ys[] = {30.0f, -10.0f, 20.0f, 0.0f};
+        std::vector<float> created;
+        for (int i = 0; i < 4; ++i) {
+            makeEntity(1, {0.0f, ys[i]}, i % 2 ? texA : texB, true);
+            created.push_back(ys[i]);
+        }
+        auto drawnTranslucent = [&](SpriteRenderSystem::YSort mode) {
+            order.clear();
+            renderer.ySort = mode;
+            renderer.Tick(reg, 0.016f);
+            std::vector<float> drawn;
+            for (size_t i = order.size() - 4; i < order.size(); ++i) {
+                drawn.push_back(order[i]->transform.position.y);
+            }
+            return drawn;
+        };
+
+        REQUIRE(drawnTranslucent(SpriteRenderSystem::YSort::None) == created);
+        auto ascending = drawnTranslucent(SpriteRenderSystem::YSort::Ascending);
+        REQUIRE(std::is_sorted(ascending.begin(), ascending.end()));
+        auto descending = drawnTranslucent(SpriteRenderSystem::YSort::Descending);
+        REQUIRE(std::is_sorted(descending.rbegin(), descending.rend()));
+        REQUIRE(renderer.GetSubmittedCount() == 10);
+    }
+}
+
+namespace {
+    // Прозрачные спрайты одного слоя рисуются в порядке создания, а не индекса сущности
+    std::vector<float> DrawnTranslucentX(Registry& reg) {
+        SpriteRenderSystem renderer;
+        std::vector<float> drawn;
+        renderer.SetDrawCallback([&](const Sprite& sprite) { drawn.push_back(sprite.transform.position.x); });
+        renderer.Tick(reg, 0.016f);
+        return drawn;
+    }
+
+    Entity MakeTranslucentSprite(Registry& reg, float x, const std::shared_ptr<Texture>& tex) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = {x, 0.0f};
+        auto& s = reg.Add<SpriteComponent>(e);
+        s.layer = 1;
+        s.transparent = true;
+        s.sprite.SetTexture(tex);
+        return e;
+    }
+}
+
+TEST_CASE("Translucent sprites keep creation order when an entity index is reused", "[ecs][systems]") {
+    Registry reg;
+    auto texA = std::make_shared<Texture>();
+    auto texB = std::make_shared<Texture>();
+
+    auto early = reg.CreateEntity();
+    MakeTranslucentSprite(reg, 1.0f, texA);
+    MakeTranslucentSprite(reg, 2.0f, texB);
+    reg.DestroyEntity(early);
+    // Новая сущность занимает освобождённый, меньший индекс
+    auto late = MakeTranslucentSprite(reg, 3.0f, texA);
+    REQUIRE(detail::DecodeIndex(late) == detail::DecodeIndex(early));
+
+    const std::vector<float> expected{1.0f, 2.0f, 3.0f};
+    REQUIRE(DrawnTranslucentX(reg) == expected);
+}
+
+TEST_CASE("Translucent sprites keep creation order past the sequence bits", "[ecs][systems]") {
+    Registry reg;
+    auto texA = std::make_shared<Texture>();
+    auto texB = std::make_shared<Texture>();
+
+    // Индексы сущностей шире kSequenceBits: ключ не должен их обрезать
+    MakeTranslucentSprite(reg, 1.0f, texA);
+    std::vector<Entity> filler(size_t{1} << SpriteSortKey::kSequenceBits);
+    reg.CreateEntities(filler.size(), filler);
+    auto high = MakeTranslucentSprite(reg, 2.0f, texB);
+    REQUIRE(detail::DecodeIndex(high) >= (1u << SpriteSortKey::kSequenceBits));
+
+    const std::vector<float> expected{1.0f, 2.0f};
+    REQUIRE(DrawnTranslucentX(reg) == expected);
+}
+
+TEST_CASE("AnimationClipLibrary interns clips with contiguous frames", "[ecs][systems]") {
+    AnimationClipLibrary library;
+    AnimationClip walk("walk");
+    walk.AddFrame(Rect{0.0f, 0.0f, 0.25f, 1.0f}, 0.1f);
+    walk.AddFrame(Rect{0.25f, 0.0f, 0.25f, 1.0f}, 0.1f);
+    AnimationClip jump("jump", false);
+    jump.AddFrame(Rect{0.5f, 0.0f, 0.25f, 1.0f}, 0.2f);
+
+    const AnimationClipId walkId = library.Add(walk);
+    const AnimationClipId jumpId = library.Add(jump);
+    REQUIRE(walkId != jumpId);
+    REQUIRE(library.Find("walk") == walkId);
+    REQUIRE(library.Find("run") == kInvalidAnimationClip);
+    REQUIRE(library.Add(AnimationClip("empty")) == kInvalidAnimationClip);
+    REQUIRE(library.GetFrameCount() == 3);
+    REQUIRE(library.GetFrames(jumpId).data() == library.GetFrames(walkId).data() + 2);
+
+    // Замена клипа сохраняет id и сдвигает кадры следующих клипов
+    walk.AddFrame(Rect{0.75f, 0.0f, 0.25f, 1.0f}, 0.1f);
+    REQUIRE(library.Add(walk) == walkId);
+    REQUIRE(library.GetFrames(walkId).size() == 3);
+    REQUIRE(library.GetFrames(jumpId)[0].uvRect.x == Approx(0.5f));
+    REQUIRE(library.GetFrameCount() == 4);
+
+    uint32_t frame = 0;
+    float elapsed = 0.0f;
+    REQUIRE_FALSE(library.Advance(walkId, frame, elapsed, 0.05f));
+    REQUIRE(library.Advance(walkId, frame, elapsed, 0.1f));
+    REQUIRE(frame == 1);
+    REQUIRE(elapsed == Approx(0.05f).margin(1e-5f));
+    // Пять полных циклов и ещё кадр: цикл отбрасывается целиком
+    REQUIRE(library.Advance(walkId, frame, elapsed, 1.6f));
+    REQUIRE(frame == 2);
+
+    frame = 0;
+    elapsed = 0.0f;
+    REQUIRE_FALSE(library.Advance(jumpId, frame, elapsed, 5.0f));
+    REQUIRE(frame == 0);
+    REQUIRE(elapsed == Approx(0.2f));
+}
+
+TEST_CASE("AnimationSystem advances playheads from the shared library", "[ecs][systems]") {
+    Registry reg;
+    auto library = std::make_shared<AnimationClipLibrary>();
+    AnimationClip walk("walk");
+    for (int i = 0; i < 4; ++i) {
+        AnimationFrame frame;
+        frame.uvRect = Rect{0.25f * static_cast<float>(i), 0.0f, 0.25f, 1.0f};
+        frame.pivot = {0.5f, static_cast<float>(i) * 0.1f};
+        walk.AddFrame(frame);
+    }
+    const AnimationClipId walkId = library->Add(walk);
+    reg.Ctx<AnimationLibrary>().clips = library;
+
+    std::vector<Entity> goblins;
+    for (int i = 0; i < 3; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<SpriteComponent>(e);
+        PlayAnimation(reg, e, walkId);
+        goblins.push_back(e);
+    }
+    REQUIRE(reg.Get<AnimationComponent>(goblins[0])->clip == walkId);
+    REQUIRE(reg.Get<SpriteComponent>(goblins[0])->sprite.textureRect.x == Approx(0.0f));
+    reg.Get<AnimationComponent>(goblins[1])->speed = 2.0f;
+    reg.Get<AnimationComponent>(goblins[2])->speed = 0.0f;
+
+    AnimationSystem system;
+    reg.ClearChangeTracking();
+    system.Tick(reg, 0.15f);
+    REQUIRE(reg.Get<AnimationComponent>(goblins[0])->frame == 1);
+    REQUIRE(reg.Get<AnimationComponent>(goblins[1])->frame == 3);
+    REQUIRE(reg.Get<AnimationComponent>(goblins[2])->frame == 0);
+    REQUIRE(reg.Get<SpriteComponent>(goblins[1])->sprite.textureRect.x == Approx(0.75f));
+    REQUIRE(reg.Get<SpriteComponent>(goblins[1])->sprite.transform.origin.y == Approx(0.3f));
+
+    // Спрайт помечается изменённым только при смене кадра
+    int changed = 0;
+    reg.ForEach<const SpriteComponent, Changed<SpriteComponent>>([&](Entity, const SpriteComponent&) { ++changed; });
+    REQUIRE(changed == 2);
+    reg.ClearChangeTracking();
+    system.Tick(reg, 0.01f);
+    changed = 0;
+    reg.ForEach<const SpriteComponent, Changed<SpriteComponent>>([&](Entity, const SpriteComponent&) { ++changed; });
+    REQUIRE(changed == 0);
+
+    // Тот же клип без restart продолжается, с restart - с начала
+    PlayAnimation(reg, goblins[0], walkId);
+    REQUIRE(reg.Get<AnimationComponent>(goblins[0])->frame == 1);
+    PlayAnimation(reg, goblins[0], walkId, true);
+    REQUIRE(reg.Get<AnimationComponent>(goblins[0])->frame == 0);
+    REQUIRE(reg.Get<SpriteComponent>(goblins[0])->sprite.textureRect.x == Approx(0.0f));
+}
+
 TEST_CASE("CameraFollowSystem moves camera toward target", "[ecs][systems]") {
     Registry reg;
     
@@ -114,3 +339,550 @@ TEST_CASE("CameraFollowSystem moves camera toward target", "[ecs][systems]") {
     REQUIRE(camPos.x == Approx(50.0f));
     REQUIRE(camPos.y == Approx(20.0f));
 }
+
+TEST_CASE("TransformPropagationSystem updates world transforms of dirty subtrees", "[ecs][systems]") {
+    Registry reg;
+    TransformPropagationSystem system;
+
+    auto root = reg.CreateEntity();
+    reg.Add<TransformComponent>(root).position = {100.0f, 0.0f};
+    auto arm = reg.CreateEntity();
+    reg.Add<TransformComponent>(arm).position = {10.0f, 0.0f};
+    auto hand = reg.CreateEntity();
+    reg.Add<TransformComponent>(hand).position = {5.0f, 0.0f};
+    SetParent(reg, arm, root);
+    SetParent(reg, hand, arm);
+
+    system.Tick(reg, 0.016f);
+    REQUIRE(reg.Get<WorldTransformComponent>(hand)->position.x == Approx(115.0f));
+
+    // Поворот корня поворачивает всё поддерево
+    reg.ClearChangeTracking();
+    reg.Get<TransformComponent>(root)->rotation = 1.5707963f;
+    system.Tick(reg, 0.016f);
+    const auto* world = std::as_const(reg).Get<WorldTransformComponent>(hand);
+    REQUIRE(world->position.x == Approx(100.0f).margin(0.001f));
+    REQUIRE(world->position.y == Approx(15.0f).margin(0.001f));
+    REQUIRE(world->rotation == Approx(1.5707963f));
+
+    // Без изменений мировые трансформы не переписываются
+    reg.ClearChangeTracking();
+    system.Tick(reg, 0.016f);
+    REQUIRE_FALSE(reg.IsChanged<WorldTransformComponent>(hand));
+
+    // Отвязанный ребёнок снова в координатах мира
+    reg.ClearChangeTracking();
+    SetParent(reg, hand, kInvalidEntity);
+    system.Tick(reg, 0.016f);
+    REQUIRE(reg.Get<WorldTransformComponent>(hand)->position.x == Approx(5.0f));
+
+    // Цикл не создаётся
+    SetParent(reg, root, arm);
+    REQUIRE(std::as_const(reg).Get<HierarchyComponent>(root)->parent == kInvalidEntity);
+
+    DestroyWithChildren(reg, root);
+    REQUIRE_FALSE(reg.IsAlive(root));
+    REQUIRE_FALSE(reg.IsAlive(arm));
+    REQUIRE(reg.IsAlive(hand));
+}
+
+TEST_CASE("TransformPropagationSystem survives children destroyed with DestroyEntity", "[ecs][systems]") {
+    Registry reg;
+    TransformPropagationSystem system;
+
+    auto root = reg.CreateEntity();
+    reg.Add<TransformComponent>(root).position = {100.0f, 0.0f};
+    auto makeChild = [&](Entity parent, float x) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = {x, 0.0f};
+        SetParent(reg, e, parent);
+        return e;
+    };
+    // SetParent вставляет в начало: список детей root - last, middle, first
+    auto first = makeChild(root, 1.0f);
+    auto middle = makeChild(root, 2.0f);
+    auto last = makeChild(root, 3.0f);
+    auto orphan = makeChild(middle, 10.0f);
+    auto grandchild = makeChild(first, 20.0f);
+    system.Tick(reg, 0.016f);
+
+    // Уничтожение в обход DestroyWithChildren (как DeathSystem)
+    reg.DestroyEntity(middle);
+    const auto* rootNode = std::as_const(reg).Get<HierarchyComponent>(root);
+    REQUIRE(rootNode->firstChild == last);
+    REQUIRE(std::as_const(reg).Get<HierarchyComponent>(last)->nextSibling == first);
+    REQUIRE(std::as_const(reg).Get<HierarchyComponent>(orphan)->parent == kInvalidEntity);
+
+    reg.ClearChangeTracking();
+    reg.Get<TransformComponent>(root)->position = {200.0f, 0.0f};
+    system.Tick(reg, 0.016f);
+    REQUIRE(reg.Get<WorldTransformComponent>(last)->position.x == Approx(203.0f));
+    REQUIRE(reg.Get<WorldTransformComponent>(first)->position.x == Approx(201.0f));
+    REQUIRE(reg.Get<WorldTransformComponent>(grandchild)->position.x == Approx(221.0f));
+    REQUIRE(reg.Get<WorldTransformComponent>(orphan)->position.x == Approx(10.0f));
+}
+
+TEST_CASE("Active camera is kept in the registry context", "[ecs][systems]") {
+    Registry reg;
+    REQUIRE(GetActiveCamera(reg) == nullptr);
+
+    auto first = reg.CreateEntity();
+    reg.Add<CameraComponent>(first);
+    reg.Add<TransformComponent>(first).position = {30.0f, 40.0f};
+    auto second = reg.CreateEntity();
+    reg.Add<CameraComponent>(second).active = false;
+
+    // Первая активная камера найдена и запомнена; позиция взята из трансформа
+    CameraComponent* active = GetActiveCamera(reg);
+    REQUIRE(active == reg.Get<CameraComponent>(first));
+    REQUIRE(reg.Ctx<ActiveCamera>().entity == first);
+    REQUIRE(active->camera.GetPosition().x == Approx(30.0f));
+
+    SetActiveCamera(reg, second);
+    REQUIRE(GetActiveCamera(reg) == reg.Get<CameraComponent>(second));
+    REQUIRE_FALSE(reg.Get<CameraComponent>(first)->active);
+
+    // Удалённая камера: выбирается следующая активная
+    reg.Get<CameraComponent>(first)->active = true;
+    reg.DestroyEntity(second);
+    REQUIRE(GetActiveCamera(reg) == reg.Get<CameraComponent>(first));
+    REQUIRE(reg.Ctx<ActiveCamera>().entity == first);
+}
+
+TEST_CASE("SpatialReorderSystem keeps pools in Morton order", "[ecs][systems]") {
+    Registry reg;
+    // Сущности созданы вразброс: соседние слоты далеко друг от друга в мире
+    constexpr int kCount = 1000;
+    for (int i = 0; i < kCount; ++i) {
+        auto e = reg.CreateEntity();
+        const float x = static_cast<float>((i * 7919) % kCount);
+        reg.Add<TransformComponent>(e).position = {x, static_cast<float>(i % 10) * 50.0f};
+        if (i % 2 == 0) reg.Add<VelocityComponent>(e).velocity = {x, 0.0f};
+    }
+
+    SpatialReorderSystem system;
+    system.cellSize = 16.0f;
+    auto keys = [&]() {
+        std::vector<uint64_t> result;
+        reg.ForEach<const TransformComponent>([&](Entity, const TransformComponent& t) {
+            result.push_back(Morton::FromPosition(t.position, system.cellSize));
+        });
+        return result;
+    };
+
+    // Первый тик: полная сортировка, связанные пулы в том же порядке
+    system.Tick(reg, 0.016f);
+    auto sorted = keys();
+    REQUIRE(std::is_sorted(sorted.begin(), sorted.end()));
+    uint64_t lastKey = 0;
+    reg.ForEach<const VelocityComponent>([&](Entity e, const VelocityComponent& v) {
+        const auto* transform = std::as_const(reg).Get<TransformComponent>(e);
+        const uint64_t key = Morton::FromPosition(transform->position, system.cellSize);
+        REQUIRE(key >= lastKey);
+        REQUIRE(transform->position.x == Approx(v.velocity.x));
+        lastKey = key;
+    });
+
+    // Смещение части сущностей исправляется окнами за несколько тиков
+    reg.ForEach<TransformComponent>([](Entity, TransformComponent& t) {
+        if (t.position.y == 100.0f) t.position.x += 40.0f;
+    });
+    for (int frame = 0; frame < 64; ++frame) {
+        system.Tick(reg, 0.016f);
+    }
+    sorted = keys();
+    REQUIRE(std::is_sorted(sorted.begin(), sorted.end()));
+}
+
+TEST_CASE("IntegrateMotion matches the scalar update", "[ecs][systems]") {
+    // 37 элементов: полные векторные итерации и скалярный хвост
+    constexpr size_t kCount = 37;
+    std::vector<float> x(kCount), y(kCount), rotation(kCount);
+    std::vector<float> vx(kCount), vy(kCount), angular(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        x[i] = static_cast<float>(i) * 1.5f;
+        y[i] = -static_cast<float>(i);
+        rotation[i] = static_cast<float>(i % 4) * 90.0f;
+        vx[i] = 10.0f + static_cast<float>(i);
+        vy[i] = -3.0f * static_cast<float>(i);
+        angular[i] = static_cast<float>(i % 3) - 1.0f;
+    }
+    auto expectedX = x;
+    auto expectedY = y;
+    auto expectedRotation = rotation;
+    const float dt = 0.016f;
+    for (size_t i = 0; i < kCount; ++i) {
+        expectedX[i] += vx[i] * dt;
+        expectedY[i] += vy[i] * dt;
+        expectedRotation[i] += angular[i] * dt;
+    }
+
+    IntegrateMotion(x.data(), y.data(), rotation.data(), vx.data(), vy.data(), angular.data(), kCount, dt);
+    for (size_t i = 0; i < kCount; ++i) {
+        REQUIRE(x[i] == Approx(expectedX[i]));
+        REQUIRE(y[i] == Approx(expectedY[i]));
+        REQUIRE(rotation[i] == Approx(expectedRotation[i]));
+    }
+}
+
+TEST_CASE("MovementSystem moves SoA entities through MotionStreams", "[ecs][systems]") {
+    Registry reg;
+    auto& streams = UseMotionStreams(reg);
+    MovementSystem movement;
+
+    auto soa = reg.CreateEntity();
+    reg.Add<TransformComponent>(soa).position = {10.0f, 0.0f};
+    reg.Add<VelocityComponent>(soa).velocity = {100.0f, 0.0f};
+    reg.Add<SoAMotionTag>(soa);
+    auto plain = reg.CreateEntity();
+    reg.Add<TransformComponent>(plain);
+    reg.Add<VelocityComponent>(plain).velocity = {0.0f, 50.0f};
+    REQUIRE(streams.Size() == 1);
+    REQUIRE(streams.Contains(soa));
+    REQUIRE_FALSE(streams.Contains(plain));
+
+    // Обе сущности двигаются, результат SoA виден в TransformComponent
+    movement.Tick(reg, 0.5f);
+    const Registry& view = reg;
+    REQUIRE(view.Get<TransformComponent>(soa)->position.x == Approx(60.0f));
+    REQUIRE(view.Get<TransformComponent>(plain)->position.y == Approx(25.0f));
+
+    // Правки компонентов подхватываются потоками
+    reg.Get<TransformComponent>(soa)->position = {0.0f, 0.0f};
+    reg.Get<VelocityComponent>(soa)->velocity = {0.0f, 10.0f};
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(soa)->position.x == Approx(0.0f));
+    REQUIRE(view.Get<TransformComponent>(soa)->position.y == Approx(10.0f));
+
+    // Прокси пишет в потоки и в компонент
+    auto proxy = streams.Transform(soa);
+    proxy.position += Vector2{5.0f, 0.0f};
+    proxy.rotation = 45.0f;
+    REQUIRE(static_cast<Vector2>(proxy.position).x == Approx(5.0f));
+    REQUIRE(view.Get<TransformComponent>(soa)->rotation == Approx(45.0f));
+    REQUIRE(streams.X()[0] == Approx(5.0f));
+
+    // Без writeBack компонент устаревает, актуальные данные — через прокси
+    streams.writeBack = false;
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(soa)->position.y == Approx(10.0f));
+    REQUIRE(static_cast<Vector2>(streams.Transform(soa).position).y == Approx(20.0f));
+
+    // Снятие маркера оставляет в компоненте последнее состояние
+    reg.Remove<SoAMotionTag>(soa);
+    REQUIRE(streams.Size() == 0);
+    REQUIRE(view.Get<TransformComponent>(soa)->position.y == Approx(20.0f));
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(soa)->position.y == Approx(30.0f));
+
+    // Уничтожение освобождает слот, оставшиеся сохраняют свои данные
+    streams.writeBack = true;
+    reg.Add<SoAMotionTag>(soa);
+    reg.Add<SoAMotionTag>(plain);
+    REQUIRE(streams.Size() == 2);
+    reg.DestroyEntity(soa);
+    REQUIRE(streams.Size() == 1);
+    REQUIRE(streams.Entities()[0] == plain);
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(plain)->position.y == Approx(225.0f));
+
+    // Тело с RigidBodyComponent двигает PhysicsSystem, потоки его не сдвигают
+    auto body = reg.CreateEntity();
+    reg.Add<TransformComponent>(body);
+    reg.Add<VelocityComponent>(body).velocity = {100.0f, 0.0f};
+    reg.Add<SoAMotionTag>(body);
+    reg.Add<RigidBodyComponent>(body);
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(body)->position.x == Approx(0.0f));
+    REQUIRE(view.Get<TransformComponent>(plain)->position.y == Approx(275.0f));
+
+    // Позиция от физики забирается в потоки
+    reg.Get<TransformComponent>(body)->position = {40.0f, 0.0f};
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(body)->position.x == Approx(40.0f));
+    REQUIRE(static_cast<Vector2>(streams.Transform(body).position).x == Approx(40.0f));
+
+    // Без тела сущность снова идёт по своей скорости
+    reg.Remove<RigidBodyComponent>(body);
+    movement.Tick(reg, 1.0f);
+    REQUIRE(view.Get<TransformComponent>(body)->position.x == Approx(140.0f));
+}
+
+TEST_CASE("CollisionSystem reports pairs with enter, stay and exit events", "[ecs][systems]") {
+    Registry reg;
+    CollisionSystem collision;
+    auto makeBox = [&](Vector2 position, Vector2 size) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = position;
+        reg.Add<ColliderComponent>(e).size = size;
+        return e;
+    };
+    auto countEvents = [&](CollisionSystem::Event::Type type) {
+        auto events = collision.GetEvents();
+        return std::count_if(events.begin(), events.end(), [type](const auto& ev) { return ev.type == type; });
+    };
+
+    auto a = makeBox({0.0f, 0.0f}, {10.0f, 10.0f});
+    auto b = makeBox({10.0f, 0.0f}, {10.0f, 10.0f}); // касается a
+    auto c = makeBox({100.0f, 0.0f}, {10.0f, 10.0f});
+    const Registry& view = reg;
+
+    collision.Tick(reg, 0.0f);
+    REQUIRE(collision.GetPairs().size() == 1);
+    REQUIRE(collision.GetPairs()[0].a == std::min(a, b));
+    REQUIRE(collision.GetPairs()[0].b == std::max(a, b));
+    REQUIRE(countEvents(CollisionSystem::Event::Type::Enter) == 1);
+    REQUIRE(view.Get<ColliderComponent>(a)->colliding);
+    REQUIRE(view.Get<ColliderComponent>(b)->colliding);
+    REQUIRE_FALSE(view.Get<ColliderComponent>(c)->colliding);
+
+    // Пара сохраняется — Stay; c заезжает на b — Enter
+    reg.Get<TransformComponent>(c)->position = {18.0f, 0.0f};
+    collision.Tick(reg, 0.0f);
+    REQUIRE(collision.GetPairs().size() == 2);
+    REQUIRE(countEvents(CollisionSystem::Event::Type::Stay) == 1);
+    REQUIRE(countEvents(CollisionSystem::Event::Type::Enter) == 1);
+    REQUIRE(view.Get<ColliderComponent>(c)->colliding);
+
+    // Расхождение и уничтожение дают Exit, флаги сбрасываются
+    reg.Get<TransformComponent>(a)->position = {-50.0f, 0.0f};
+    reg.DestroyEntity(c);
+    collision.Tick(reg, 0.0f);
+    REQUIRE(collision.GetPairs().empty());
+    REQUIRE(countEvents(CollisionSystem::Event::Type::Exit) == 2);
+    REQUIRE_FALSE(view.Get<ColliderComponent>(a)->colliding);
+    REQUIRE_FALSE(view.Get<ColliderComponent>(b)->colliding);
+
+    collision.Tick(reg, 0.0f);
+    REQUIRE(collision.GetEvents().empty());
+}
+
+TEST_CASE("CollisionSystem broadphase matches the brute-force pair test", "[ecs][systems]") {
+    Registry reg;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(-400.0f, 400.0f);
+    std::uniform_real_distribution<float> extent(4.0f, 40.0f);
+    std::vector<Entity> entities;
+    for (int i = 0; i < 600; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = {pos(rng), pos(rng)};
+        auto& collider = reg.Add<ColliderComponent>(e);
+        // Несколько крупных коллайдеров идут мимо хеша
+        collider.size = i % 97 == 0 ? Vector2{300.0f, 200.0f} : Vector2{extent(rng), extent(rng)};
+        collider.offset = {extent(rng) - 20.0f, 0.0f};
+        entities.push_back(e);
+    }
+
+    const Registry& view = reg;
+    std::vector<std::pair<Entity, Entity>> expected;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        for (size_t j = i + 1; j < entities.size(); ++j) {
+            const auto* ci = view.Get<ColliderComponent>(entities[i]);
+            const auto* cj = view.Get<ColliderComponent>(entities[j]);
+            const Rect ri = Rect::FromCenter(view.Get<TransformComponent>(entities[i])->position + ci->offset, ci->size);
+            const Rect rj = Rect::FromCenter(view.Get<TransformComponent>(entities[j])->position + cj->offset, cj->size);
+            if (ri.Intersects(rj)) {
+                expected.emplace_back(std::min(entities[i], entities[j]), std::max(entities[i], entities[j]));
+            }
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    CollisionSystem collision;
+    collision.Tick(reg, 0.0f);
+    std::vector<std::pair<Entity, Entity>> actual;
+    for (const auto& pair : collision.GetPairs()) {
+        actual.emplace_back(pair.a, pair.b);
+    }
+    REQUIRE(!expected.empty());
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("SpriteRenderSystem culls sprites outside the camera view", "[ecs][systems]") {
+    Registry reg;
+    auto tex = std::make_shared<Texture>(); // пустая текстура-стаб: спрайт — точка
+    auto camera = reg.CreateEntity();
+    auto& cam = reg.Add<CameraComponent>(camera);
+    cam.camera = Camera2D(100.0f, 100.0f);
+    cam.camera.SetZoom(2.0f); // видно [-25, 25] по обеим осям
+
+    auto makeSprite = [&](const Vector2& pos) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = pos;
+        reg.Add<SpriteComponent>(e).sprite.SetTexture(tex);
+        return e;
+    };
+    makeSprite({0.0f, 0.0f});
+    makeSprite({20.0f, -20.0f});
+    auto corner = makeSprite({30.0f, 0.0f});
+    makeSprite({500.0f, 500.0f});
+
+    SpriteRenderSystem renderer;
+    std::vector<float> drawn;
+    renderer.SetDrawCallback([&](const Sprite& sprite) { drawn.push_back(sprite.transform.position.x); });
+
+    renderer.Tick(reg, 0.016f);
+    REQUIRE(renderer.GetSubmittedCount() == 2);
+    REQUIRE(renderer.GetCulledCount() == 2);
+
+    // Поворот камеры на 45° расширяет AABB вида до ~35 единиц
+    cam.camera.SetRotation(0.7853982f);
+    drawn.clear();
+    renderer.Tick(reg, 0.016f);
+    REQUIRE(drawn.size() == 3);
+    REQUIRE(renderer.GetCulledCount() == 1);
+
+    // Перемещённый спрайт пересчитывает свой AABB
+    reg.Get<TransformComponent>(corner)->position = {600.0f, 0.0f};
+    renderer.Tick(reg, 0.016f);
+    REQUIRE(renderer.GetSubmittedCount() == 2);
+
+    // Без отсечения рисуется всё
+    renderer.culling = false;
+    renderer.Tick(reg, 0.016f);
+    REQUIRE(renderer.GetSubmittedCount() == 4);
+    REQUIRE(renderer.GetCulledCount() == 0);
+
+    // Отрисовка читает спрайты, не помечая их изменёнными
+    reg.ClearChangeTracking();
+    renderer.Tick(reg, 0.016f);
+    size_t stamped = 0;
+    reg.ForEach<const SpriteComponent, Changed<SpriteComponent>>([&](Entity, const SpriteComponent&) { ++stamped; });
+    REQUIRE(stamped == 0);
+}
+
+TEST_CASE("SpriteRenderSystem spatial index matches the linear cull", "[ecs][systems]") {
+    auto tex = std::make_shared<Texture>();
+    // Два одинаковых мира: один рисуется обходом пула, другой через индекс
+    auto populate = [&](Registry& reg) {
+        auto camera = reg.CreateEntity();
+        reg.Add<CameraComponent>(camera).camera = Camera2D(400.0f, 300.0f);
+        reg.Add<TransformComponent>(camera).position = {100.0f, 50.0f};
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> pos(-400.0f, 400.0f);
+        std::uniform_int_distribution<int> layer(0, 3);
+        std::vector<Entity> sprites;
+        for (int i = 0; i < 2000; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<TransformComponent>(e).position = {pos(rng), pos(rng)};
+            auto& sprite = reg.Add<SpriteComponent>(e);
+            sprite.sprite.SetTexture(tex);
+            sprite.layer = layer(rng);
+            sprite.transparent = i % 5 == 0;
+            sprites.push_back(e);
+        }
+        return sprites;
+    };
+    // Нарисованные сущности и ключи (прозрачность, слой) в порядке отрисовки
+    auto render = [](Registry& reg, SpriteRenderSystem& renderer) {
+        std::vector<const Sprite*> order;
+        renderer.SetDrawCallback([&](const Sprite& sprite) { order.push_back(&sprite); });
+        renderer.Tick(reg, 0.016f);
+        std::vector<Entity> entities;
+        std::vector<std::pair<bool, int>> keys;
+        for (const Sprite* drawn : order) {
+            reg.ForEach<const SpriteComponent>([&](Entity e, const SpriteComponent& sprite) {
+                if (&sprite.sprite == drawn) {
+                    entities.push_back(e);
+                    keys.emplace_back(sprite.transparent, sprite.layer);
+                }
+            });
+        }
+        return std::make_pair(entities, keys);
+    };
+
+    Registry linearReg;
+    Registry indexedReg;
+    auto sprites = populate(linearReg);
+    REQUIRE(populate(indexedReg) == sprites);
+    SpriteRenderSystem linear;
+    linear.spatialIndexThreshold = static_cast<size_t>(-1);
+    SpriteRenderSystem indexed;
+    indexed.spatialIndexThreshold = 1;
+    indexed.cellSize = 64.0f;
+
+    for (int frame = 0; frame < 3; ++frame) {
+        auto [expected, linearKeys] = render(linearReg, linear);
+        auto [actual, keys] = render(indexedReg, indexed);
+        REQUIRE(indexedReg.FindCtx<SpriteSpatialIndex>() != nullptr);
+        REQUIRE(linearReg.FindCtx<SpriteSpatialIndex>() == nullptr);
+        REQUIRE_FALSE(expected.empty());
+        REQUIRE(indexed.GetCulledCount() == linear.GetCulledCount());
+        REQUIRE(indexed.GetSubmittedCount() == linear.GetSubmittedCount());
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        REQUIRE(actual == expected);
+        // Непрозрачные, затем прозрачные, внутри — по layer
+        REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+        REQUIRE(std::is_sorted(linearKeys.begin(), linearKeys.end()));
+
+        // Сдвиг, уничтожение и скрытие между кадрами, в обоих мирах одинаково
+        for (Registry* reg : {&linearReg, &indexedReg}) {
+            reg->ClearChangeTracking();
+            for (size_t i = frame; i < sprites.size(); i += 7) {
+                reg->Get<TransformComponent>(sprites[i])->position.x += 150.0f;
+            }
+            reg->DestroyEntity(sprites[frame * 3]);
+            reg->Get<SpriteComponent>(sprites[frame * 3 + 1])->visible = false;
+        }
+        sprites.erase(sprites.begin() + frame * 3);
+    }
+}
+
+TEST_CASE("AudioSystem virtualizes voices out of range or over the cap", "[ecs][systems]") {
+    // Отбор: не пространственные и ближние реальные, вне слышимости - никогда
+    using Voice = AudioSystem::Voice;
+    constexpr float kOut = std::numeric_limits<float>::infinity();
+    auto select = [](std::vector<Voice> voices, size_t maxReal) {
+        const size_t count = AudioSystem::SelectRealVoices(voices, maxReal);
+        std::vector<Entity> real;
+        for (size_t i = 0; i < count; ++i) real.push_back(voices[i].entity);
+        std::sort(real.begin(), real.end());
+        return real;
+    };
+    const std::vector<Voice> voices{
+        {5, nullptr, kOut}, {4, nullptr, 300.0f * 300.0f}, {1, nullptr, -1.0f},
+        {3, nullptr, 200.0f * 200.0f}, {2, nullptr, 100.0f * 100.0f}};
+    REQUIRE((select(voices, 3) == std::vector<Entity>{1, 2, 3}));
+    REQUIRE((select(voices, 1) == std::vector<Entity>{1}));
+    REQUIRE((select(voices, 32) == std::vector<Entity>{1, 2, 3, 4}));
+    REQUIRE(select(voices, 0).empty());
+
+    // Без аудио-движка Sound не загружен: голос слот не занимает
+    Registry reg;
+    auto camera = reg.CreateEntity();
+    reg.Add<CameraComponent>(camera).camera = Camera2D(100.0f, 100.0f);
+    reg.Add<TransformComponent>(camera);
+
+    std::vector<Entity> entities;
+    for (float x : {0.0f, 100.0f, 5000.0f}) {
+        auto e = reg.CreateEntity();
+        reg.Add<TransformComponent>(e).position = {x, 0.0f};
+        auto& audio = reg.Add<AudioComponent>(e);
+        audio.path = "voice.wav";
+        audio.spatial = x > 0.0f;
+        audio.playRequested = true;
+        entities.push_back(e);
+    }
+
+    AudioSystem system;
+    system.maxRealVoices = 1;
+    system.Tick(reg, 0.016f);
+    REQUIRE(system.GetRealVoiceCount() == 0);
+    REQUIRE(system.GetVirtualVoiceCount() == 0);
+    for (Entity e : entities) {
+        const auto* audio = std::as_const(reg).Get<AudioComponent>(e);
+        REQUIRE(audio->sound);
+        REQUIRE_FALSE(audio->sound->IsLoaded());
+        REQUIRE_FALSE(audio->playRequested);
+        REQUIRE_FALSE(audio->playing);
+        REQUIRE_FALSE(audio->virtualVoice);
+    }
+
+    // Без изменений состояния компонент не штампуется
+    reg.ClearChangeTracking();
+    system.Tick(reg, 0.016f);
+    size_t stamped = 0;
+    reg.ForEach<const AudioComponent, Changed<AudioComponent>>([&](Entity, const AudioComponent&) { ++stamped; });
+    REQUIRE(stamped == 0);
+}
@@ -1,5 +1,14 @@
 #include "catch2.hpp"
 #include <SAGE/Core/ECS.h>
+#include <SAGE/Core/JobSystem.h>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 
 using namespace SAGE::ECS;
 using Catch::Approx;
@@ -124,3 +133,1107 @@ TEST_CASE("SystemScheduler executes systems in order", "[ecs][scheduler]") {
     REQUIRE(counter.first == 1);
     REQUIRE(counter.second == 1);
 }
+
+TEST_CASE("SystemScheduler orders conflicting systems and runs the rest in parallel", "[ecs][scheduler]") {
+    class IntegrateSystem : public ISystem {
+    public:
+        void Tick(Registry& reg, float dt) override {
+            reg.ForEach<Transform, Velocity>([dt](Entity, Transform& t, Velocity& v) {
+                t.x += v.vx * dt;
+            });
+        }
+        SystemAccess Access() const override { return SystemAccess().Write<Transform>().Read<Velocity>(); }
+    };
+
+    class AccelerateSystem : public ISystem {
+    public:
+        void Tick(Registry& reg, float) override {
+            reg.ForEach<Velocity>([](Entity, Velocity& v) { v.vx += 1.0f; });
+        }
+        SystemAccess Access() const override { return SystemAccess().Write<Velocity>(); }
+    };
+
+    class MainThreadSystem : public ISystem {
+    public:
+        explicit MainThreadSystem(std::thread::id& id) : ref(id) {}
+        void Tick(Registry&, float) override { ref = std::this_thread::get_id(); }
+        SystemAccess Access() const override { return SystemAccess().MainThread(); }
+    private:
+        std::thread::id& ref;
+    };
+
+    Registry reg;
+    for (int i = 0; i < 100; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e);
+        reg.Add<Velocity>(e);
+    }
+
+    SAGE::JobSystem jobs(2);
+    SystemScheduler sched;
+    sched.SetJobSystem(&jobs);
+
+    std::thread::id mainSystemThread;
+    sched.AddSystem<AccelerateSystem>();
+    sched.AddSystem<IntegrateSystem>(); // conflicts on Velocity -> runs after AccelerateSystem
+    sched.AddSystem<MainThreadSystem>(mainSystemThread);
+
+    for (int frame = 0; frame < 10; ++frame) {
+        sched.UpdateAll(reg, 1.0f);
+    }
+
+    // vx = 1..10, x = sum(1..10)
+    reg.ForEach<Transform, Velocity>([](Entity, Transform& t, Velocity& v) {
+        REQUIRE(v.vx == Approx(10.0f));
+        REQUIRE(t.x == Approx(55.0f));
+    });
+    REQUIRE(mainSystemThread == std::this_thread::get_id());
+}
+
+TEST_CASE("SystemScheduler runs Setup once per registry", "[ecs][scheduler]") {
+    class SetupCounter : public ISystem {
+    public:
+        explicit SetupCounter(int& count) : ref(count) {}
+        void Setup(Registry&) override { ++ref; }
+        void Tick(Registry&, float) override {}
+        SystemAccess Access() const override { return SystemAccess().Read<Transform>(); }
+    private:
+        int& ref;
+    };
+
+    int setups = 0;
+    SystemScheduler sched;
+    sched.AddSystem<SetupCounter>(setups);
+
+    // A registry rebuilt in place (scene reload) keeps its address but is new
+    std::optional<Registry> reg;
+    reg.emplace();
+    const Registry* address = &*reg;
+    sched.UpdateAll(*reg, 0.016f);
+    sched.UpdateAll(*reg, 0.016f);
+    REQUIRE(setups == 1);
+
+    reg.reset();
+    reg.emplace();
+    REQUIRE(&*reg == address);
+    sched.UpdateAll(*reg, 0.016f);
+    REQUIRE(setups == 2);
+}
+
+TEST_CASE("SystemAccess conflict rules", "[ecs][scheduler]") {
+    auto readT = SystemAccess().Read<Transform>();
+    auto writeT = SystemAccess().Write<Transform>();
+    auto writeV = SystemAccess().Write<Velocity>();
+
+    REQUIRE_FALSE(readT.ConflictsWith(SystemAccess().Read<Transform>()));
+    REQUIRE(readT.ConflictsWith(writeT));
+    REQUIRE(writeT.ConflictsWith(readT));
+    REQUIRE_FALSE(writeT.ConflictsWith(writeV));
+    REQUIRE(writeV.ConflictsWith(SystemAccess::Exclusive()));
+}
+
+TEST_CASE("SystemAccess tracks context types apart from components", "[ecs][scheduler]") {
+    struct Clock { float time = 0.0f; };
+
+    auto readCtx = SystemAccess().ReadCtx<Clock>();
+    auto writeCtx = SystemAccess().WriteCtx<Clock>();
+    REQUIRE_FALSE(readCtx.ConflictsWith(SystemAccess().ReadCtx<Clock>()));
+    REQUIRE(readCtx.ConflictsWith(writeCtx));
+    REQUIRE(writeCtx.ConflictsWith(readCtx));
+    REQUIRE_FALSE(writeCtx.ConflictsWith(SystemAccess().Write<Transform>()));
+    REQUIRE(writeCtx.reads.empty());
+    REQUIRE(writeCtx.writes.empty());
+}
+
+#if SAGE_ECS_ACCESS_CHECKS
+TEST_CASE("SystemScheduler access validation reports undeclared access", "[ecs][scheduler]") {
+    class SneakySystem : public ISystem {
+    public:
+        void Tick(Registry& reg, float) override {
+            reg.ForEach<Transform>([&reg](Entity e, Transform&) {
+                (void)reg.Get<Velocity>(e); // not declared
+            });
+        }
+        SystemAccess Access() const override { return SystemAccess().Write<Transform>(); }
+    };
+
+    class SpawnerSystem : public ISystem {
+    public:
+        void Tick(Registry& reg, float) override { reg.CreateEntity(); }
+        SystemAccess Access() const override { return SystemAccess(); }
+    };
+
+    // Declares Read but writes: through a mutable term and a mutable Get
+    class ReaderThatWritesSystem : public ISystem {
+    public:
+        void Tick(Registry& reg, float) override {
+            reg.ForEach<const Velocity>([](Entity, const Velocity&) {});  // fine
+            reg.ForEach<Velocity>([](Entity, Velocity&) {});              // undeclared write
+            reg.ForEach<const Transform>([&reg](Entity e, const Transform&) {
+                (void)std::as_const(reg).Get<Transform>(e);                // fine
+                (void)reg.Get<Transform>(e);                               // undeclared write
+            });
+        }
+        SystemAccess Access() const override { return SystemAccess().Read<Transform, Velocity>(); }
+    };
+
+    Registry reg;
+    auto e = reg.CreateEntity();
+    reg.Add<Transform>(e);
+    reg.Add<Velocity>(e);
+
+    SystemScheduler sched;
+    sched.SetAccessValidation(true);
+    sched.AddSystem<SneakySystem>();
+    sched.AddSystem<SpawnerSystem>();
+    sched.AddSystem<ReaderThatWritesSystem>();
+    sched.UpdateAll(reg, 0.016f);
+
+    const auto& violations = sched.GetAccessViolations();
+    REQUIRE(violations.size() == 4);
+    REQUIRE(violations[0].systemIndex == 0);
+    REQUIRE_FALSE(violations[0].structural);
+    REQUIRE(violations[1].systemIndex == 1);
+    REQUIRE(violations[1].structural);
+
+    REQUIRE(violations[2].systemIndex == 2);
+    REQUIRE(violations[2].componentTypeId == detail::GetComponentTypeID<Velocity>());
+    REQUIRE(violations[2].write);
+    REQUIRE(violations[3].systemIndex == 2);
+    REQUIRE(violations[3].componentTypeId == detail::GetComponentTypeID<Transform>());
+    REQUIRE(violations[3].write);
+}
+#endif
+
+TEST_CASE("Owning group keeps matching entities packed", "[ecs][group]") {
+    Registry reg;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 10; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e).x = static_cast<float>(i);
+        if (i % 2 == 0) {
+            reg.Add<Velocity>(e).vx = 1.0f;
+        }
+        entities.push_back(e);
+    }
+
+    auto group = reg.Group<Transform, Velocity>();
+    REQUIRE(group.Size() == 5);
+
+    // Incremental updates on Add / Remove / Destroy
+    auto& v = reg.Add<Velocity>(entities[1]);
+    v.vx = 2.0f;
+    REQUIRE(group.Size() == 6);
+    REQUIRE(group.Contains(entities[1]));
+    REQUIRE(reg.Get<Velocity>(entities[1])->vx == Approx(2.0f));
+    REQUIRE(reg.Get<Transform>(entities[1])->x == Approx(1.0f));
+
+    reg.Remove<Velocity>(entities[0]);
+    REQUIRE(group.Size() == 5);
+    REQUIRE_FALSE(group.Contains(entities[0]));
+
+    reg.DestroyEntity(entities[2]);
+    REQUIRE(group.Size() == 4);
+
+    // ForEach<Transform, Velocity> walks the group
+    int visited = 0;
+    reg.ForEach<Transform, Velocity>([&](Entity e, Transform& t, Velocity&) {
+        REQUIRE(reg.Get<Transform>(e) == &t);
+        visited++;
+    });
+    REQUIRE(visited == 4);
+
+    // Components stay attached to the right entities after reordering
+    for (int i = 3; i < 10; ++i) {
+        REQUIRE(reg.Get<Transform>(entities[i])->x == Approx(static_cast<float>(i)));
+    }
+
+    // Asking again returns the same group
+    REQUIRE((reg.Group<Transform, Velocity>().Size() == 4));
+}
+
+TEST_CASE("CommandBuffer defers structural changes until playback", "[ecs][commands]") {
+    Registry reg;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 6; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e).x = static_cast<float>(i);
+        entities.push_back(e);
+    }
+
+    CommandBuffer& commands = reg.Deferred();
+    reg.ForEach<Transform>([&](Entity e, Transform& t) {
+        if (static_cast<int>(t.x) % 2 == 0) {
+            commands.Destroy(e);
+        } else {
+            commands.Add<Velocity>(e, Velocity{t.x, 0.0f});
+        }
+    });
+
+    auto spawned = commands.Create();
+    commands.Add<Transform>(spawned, Transform{100.0f, 0.0f});
+    commands.Add<std::string>(spawned, "spawned");
+
+    // Nothing applied yet
+    REQUIRE(reg.AliveCount() == 6);
+    REQUIRE(commands.Size() == 9);
+
+    reg.FlushCommands();
+    REQUIRE(commands.Empty());
+    REQUIRE(reg.AliveCount() == 4);
+    REQUIRE_FALSE(reg.IsAlive(entities[0]));
+    REQUIRE(reg.Get<Velocity>(entities[3])->vx == Approx(3.0f));
+
+    int withName = 0;
+    reg.ForEach<Transform, std::string>([&](Entity, Transform& t, std::string& name) {
+        REQUIRE(t.x == Approx(100.0f));
+        REQUIRE(name == "spawned");
+        withName++;
+    });
+    REQUIRE(withName == 1);
+}
+
+TEST_CASE("SystemScheduler flushes deferred commands at sync points", "[ecs][commands]") {
+    class KillSystem : public ISystem {
+    public:
+        void Tick(Registry& reg, float) override {
+            reg.ForEach<Transform>([&reg](Entity e, Transform&) { reg.Deferred().Destroy(e); });
+        }
+        SystemAccess Access() const override { return SystemAccess().Read<Transform>(); }
+    };
+
+    class CountSystem : public ISystem {
+    public:
+        explicit CountSystem(size_t& c) : count(c) {}
+        void Tick(Registry& reg, float) override { count = reg.AliveCount(); }
+    private:
+        size_t& count;
+    };
+
+    Registry reg;
+    for (int i = 0; i < 3; ++i) {
+        reg.Add<Transform>(reg.CreateEntity());
+    }
+
+    size_t seenByExclusive = 0;
+    SAGE::JobSystem jobs(2);
+    SystemScheduler sched;
+    sched.SetJobSystem(&jobs);
+    sched.AddSystem<KillSystem>();
+    sched.AddSystem<CountSystem>(seenByExclusive); // exclusive -> sync point before it
+
+    sched.UpdateAll(reg, 0.016f);
+    REQUIRE(seenByExclusive == 0);
+    REQUIRE(reg.AliveCount() == 0);
+}
+
+TEST_CASE("SystemScheduler profiles time, entities and structural changes per system", "[ecs][scheduler]") {
+    class ProfiledMover : public ISystem {
+    public:
+        void Tick(Registry& reg, float dt) override {
+            reg.ParallelForEach<Transform, const Velocity>([dt](Entity, Transform& t, const Velocity& v) {
+                t.x += v.vx * dt;
+            }, 64);
+        }
+        SystemAccess Access() const override { return SystemAccess().Write<Transform>().Read<Velocity>(); }
+    };
+
+    class Spawner : public ISystem {
+    public:
+        void Tick(Registry& reg, float) override {
+            reg.Deferred().Add<Velocity>(reg.Deferred().Create());
+        }
+        void FixedTick(Registry& reg, float) override { reg.Add<Transform>(reg.CreateEntity()); }
+        std::string_view Name() const override { return "Spawn"; }
+    };
+
+    Registry reg;
+    for (int i = 0; i < 1000; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e);
+        if (i % 2 == 0) reg.Add<Velocity>(e).vx = 1.0f;
+    }
+
+    SAGE::JobSystem jobs(2);
+    reg.SetJobSystem(&jobs);
+    SystemScheduler sched;
+    sched.SetJobSystem(&jobs);
+    sched.AddSystem<ProfiledMover>();
+    sched.AddSystem<Spawner>();
+    REQUIRE(sched.GetSystemName(0) == "ProfiledMover");
+    REQUIRE(sched.GetSystemName(1) == "Spawn");
+
+    // Disabled: nothing is recorded
+    sched.UpdateAll(reg, 0.016f);
+    REQUIRE(sched.GetSystemProfiles().empty());
+
+    sched.SetProfiling(true);
+    for (int frame = 0; frame < 10; ++frame) {
+        sched.UpdateAll(reg, 0.016f);
+    }
+    sched.FixedUpdateAll(reg, 0.02f);
+
+    const SystemProfile mover = sched.GetSystemProfile(0);
+    REQUIRE(mover.samples == 10);
+    REQUIRE(mover.avgEntities == Approx(500.0)); // 500 movers; deferred spawns get no Transform
+    REQUIRE(mover.avgStructuralChanges == Approx(0.0));
+    REQUIRE(mover.minMs <= mover.avgMs);
+    REQUIRE(mover.avgMs <= mover.p99Ms);
+    REQUIRE(mover.p99Ms <= mover.maxMs);
+
+    const SystemProfile spawn = sched.GetSystemProfile(1);
+    REQUIRE(spawn.samples == 10);
+    REQUIRE(spawn.avgStructuralChanges == Approx(2.0)); // deferred create + add
+    const SystemProfile fixedSpawn = sched.GetSystemProfile(1, true);
+    REQUIRE(fixedSpawn.fixedUpdate);
+    REQUIRE(fixedSpawn.samples == 1);
+    REQUIRE(fixedSpawn.avgStructuralChanges == Approx(2.0));
+    REQUIRE(sched.GetSystemProfiles().size() == 4); // both systems ran in both phases
+
+    // Runs are reported to the Profiler as well
+    auto& profiler = SAGE::Profiler::Get();
+    profiler.Clear();
+    profiler.SetEnabled(true);
+    sched.UpdateAll(reg, 0.016f);
+    REQUIRE(profiler.GetResult("ECS/ProfiledMover").callCount == 1);
+    REQUIRE(profiler.GetResult("ECS/Spawn").callCount == 1);
+    profiler.Clear();
+
+    sched.ResetProfiles();
+    REQUIRE(sched.GetSystemProfile(0).samples == 0);
+}
+
+TEST_CASE("Component mask tracks ownership through Add/Remove/Destroy", "[ecs][registry]") {
+    Registry reg;
+    auto e = reg.CreateEntity();
+    reg.Add<Transform>(e);
+    reg.Add<Velocity>(e);
+
+    const ComponentMask* mask = reg.GetComponentMask(e);
+    REQUIRE(mask != nullptr);
+    REQUIRE(mask->Test(SAGE::ECS::detail::GetComponentTypeID<Transform>()));
+    REQUIRE(mask->Test(SAGE::ECS::detail::GetComponentTypeID<Velocity>()));
+
+    reg.Remove<Velocity>(e);
+    REQUIRE_FALSE(reg.Has<Velocity>(e));
+    REQUIRE_FALSE(mask->Test(SAGE::ECS::detail::GetComponentTypeID<Velocity>()));
+
+    int removedCallbacks = 0;
+    reg.SetOnComponentRemoved<Transform>([&](Entity, Transform&) { removedCallbacks++; });
+    reg.DestroyEntity(e);
+    REQUIRE(removedCallbacks == 1);
+    REQUIRE(reg.GetComponentMask(e) == nullptr);
+    REQUIRE_FALSE(reg.Has<Transform>(e));
+
+    // Recycled slot starts with an empty signature
+    auto recycled = reg.CreateEntity();
+    REQUIRE_FALSE(reg.Has<Transform>(recycled));
+    reg.ForEach<Transform>([&](Entity, Transform&) { REQUIRE(false); });
+}
+
+TEST_CASE("Component pools use paged sparse storage", "[ecs][memory]") {
+    Registry reg;
+
+    // Push the entity index far out, then give only the last entity a component
+    std::vector<Entity> entities;
+    for (int i = 0; i < 20000; ++i) {
+        entities.push_back(reg.CreateEntity());
+    }
+    reg.Add<Velocity>(entities.back());
+
+    auto stats = reg.GetPoolMemoryStats<Velocity>();
+    REQUIRE(stats.entityCount == 1);
+    // One 4096-entry page instead of 20000 slots
+    REQUIRE(stats.sparseBytes < 20000 * sizeof(uint32_t));
+    REQUIRE(stats.TotalBytes() == stats.sparseBytes + stats.denseBytes);
+
+    reg.Remove<Velocity>(entities.back());
+    reg.Compact();
+    REQUIRE(reg.GetPoolMemoryStats<Velocity>().sparseBytes == 0);
+
+    reg.Add<Transform>(entities[0]);
+    bool reported = false;
+    for (const auto& entry : reg.GetMemoryReport()) {
+        if (entry.typeId == SAGE::ECS::detail::GetComponentTypeID<Transform>()) {
+            reported = entry.stats.entityCount == 1 && entry.stats.denseBytes > 0;
+        }
+    }
+    REQUIRE(reported);
+
+    reg.Clear();
+    REQUIRE(reg.GetPoolMemoryStats<Transform>().sparseBytes == 0);
+}
+
+TEST_CASE("Registry tracks added and changed components", "[ecs][changes]") {
+    Registry reg;
+    auto a = reg.CreateEntity();
+    auto b = reg.CreateEntity();
+    reg.Add<Transform>(a);
+    reg.Add<Transform>(b);
+    REQUIRE(reg.IsAdded<Transform>(a));
+
+    reg.ClearChangeTracking();
+    REQUIRE_FALSE(reg.IsAdded<Transform>(a));
+    REQUIRE_FALSE(reg.IsChanged<Transform>(a));
+
+    // Const access and read-only iteration do not stamp
+    const Registry& view = reg;
+    REQUIRE(view.Get<Transform>(a) != nullptr);
+    reg.ForEach<const Transform>([](Entity, const Transform&) {});
+    REQUIRE_FALSE(reg.IsChanged<Transform>(a));
+
+    REQUIRE(reg.Patch<Transform>(b, [](Transform& t) { t.x = 3.0f; }));
+    REQUIRE(reg.IsChanged<Transform>(b));
+    REQUIRE_FALSE(reg.IsChanged<Transform>(a));
+
+    int changed = 0;
+    reg.ForEach<const Transform, Changed<Transform>>([&](Entity e, const Transform& t) {
+        REQUIRE(e == b);
+        REQUIRE(t.x == Approx(3.0f));
+        ++changed;
+    });
+    REQUIRE(changed == 1);
+
+    // Mutable iteration marks what it visits
+    reg.ForEach<Transform>([](Entity, Transform&) {});
+    REQUIRE(reg.IsChanged<Transform>(a));
+}
+
+TEST_CASE("SystemScheduler compares changes against each system's last run", "[ecs][changes]") {
+    struct MoveFirst : ISystem {
+        Entity target = kInvalidEntity;
+        void Tick(Registry& reg, float) override {
+            reg.Patch<Transform>(target, [](Transform& t) { t.x += 1.0f; });
+        }
+        SystemAccess Access() const override { return SystemAccess().Write<Transform>(); }
+    };
+    struct CountChanged : ISystem {
+        int changed = 0;
+        int added = 0;
+        void Tick(Registry& reg, float) override {
+            changed = 0;
+            added = 0;
+            reg.ForEach<const Transform, Changed<Transform>>([&](Entity, const Transform&) { ++changed; });
+            reg.ForEach<const Transform, Added<Transform>>([&](Entity, const Transform&) { ++added; });
+        }
+        SystemAccess Access() const override { return SystemAccess().Read<Transform>(); }
+    };
+
+    Registry reg;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 4; ++i) {
+        entities.push_back(reg.CreateEntity());
+        reg.Add<Transform>(entities.back());
+    }
+
+    SystemScheduler sched;
+    auto& mover = sched.AddSystem<MoveFirst>();
+    mover.target = entities[0];
+    auto& counter = sched.AddSystem<CountChanged>();
+
+    sched.UpdateAll(reg, 0.016f);
+    REQUIRE(counter.added == 4);
+    REQUIRE(counter.changed == 4);
+
+    sched.UpdateAll(reg, 0.016f);
+    REQUIRE(counter.added == 0);
+    REQUIRE(counter.changed == 1);
+
+    reg.Add<Transform>(reg.CreateEntity());
+    sched.UpdateAll(reg, 0.016f);
+    REQUIRE(counter.added == 1);
+    REQUIRE(counter.changed == 2);
+}
+
+TEST_CASE("JobSystem ParallelFor covers the range once", "[ecs][jobs]") {
+    SAGE::JobSystem jobs(3);
+    std::vector<int> hits(10000, 0);
+    jobs.ParallelFor(hits.size(), 128, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ++hits[i];
+        }
+    });
+    REQUIRE(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+
+    bool thrown = false;
+    try {
+        jobs.ParallelFor(1000, 10, [](size_t begin, size_t) {
+            if (begin == 500) throw std::runtime_error("chunk failed");
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    REQUIRE(thrown);
+}
+
+TEST_CASE("Registry ParallelForEach visits every match", "[ecs][jobs]") {
+    Registry reg;
+    SAGE::JobSystem jobs(3);
+    reg.SetJobSystem(&jobs);
+
+    for (int i = 0; i < 5000; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e);
+        if (i % 2 == 0) reg.Add<Velocity>(e, Velocity{1.0f, 2.0f});
+    }
+
+    reg.ParallelForEach<Transform, const Velocity>([](Entity, Transform& t, const Velocity& v) {
+        t.x += v.vx;
+        t.y += v.vy;
+    }, 64);
+
+    int moved = 0;
+    reg.ForEach<const Transform>([&](Entity, const Transform& t) {
+        if (t.x == 1.0f && t.y == 2.0f) ++moved;
+    });
+    REQUIRE(moved == 2500);
+
+    // Deferred commands recorded from worker threads are all played back
+    reg.ParallelForEach<const Velocity>([&](Entity e, const Velocity&) { reg.Deferred().Destroy(e); }, 64);
+    reg.FlushCommands();
+    REQUIRE(reg.AliveCount() == 2500);
+}
+
+TEST_CASE("Empty tag components keep no dense storage", "[ecs][memory]") {
+    Registry reg;
+    std::vector<Entity> tagged;
+    for (int i = 0; i < 1000; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e, Transform{static_cast<float>(i), 0.0f});
+        if (i % 4 == 0) {
+            reg.Add<TagA>(e);
+            tagged.push_back(e);
+        }
+    }
+
+    auto stats = reg.GetPoolMemoryStats<TagA>();
+    REQUIRE(stats.entityCount == tagged.size());
+    // Entity list only: no component array, no change ticks
+    REQUIRE(stats.denseBytes == tagged.capacity() * sizeof(Entity));
+    REQUIRE(stats.denseBytes < reg.GetPoolMemoryStats<Transform>().denseBytes / 4);
+
+    int visited = 0;
+    reg.ForEach<const Transform, TagA>([&](Entity e, const Transform& t, TagA&) {
+        REQUIRE(static_cast<int>(t.x) % 4 == 0);
+        REQUIRE(reg.Has<TagA>(e));
+        ++visited;
+    });
+    REQUIRE(visited == static_cast<int>(tagged.size()));
+
+    reg.Remove<TagA>(tagged.front());
+    reg.DestroyEntity(tagged.back());
+    REQUIRE(reg.GetPoolMemoryStats<TagA>().entityCount == tagged.size() - 2);
+    REQUIRE_FALSE(reg.Has<TagA>(tagged.front()));
+}
+
+TEST_CASE("Registry creates entities and inserts components in bulk", "[ecs][registry]") {
+    Registry reg;
+    auto stale = reg.CreateEntity();
+    reg.DestroyEntity(stale);
+
+    std::vector<Entity> entities(100);
+    reg.CreateEntities(entities.size(), entities);
+    REQUIRE(reg.AliveCount() == 100);
+    // The freed slot is recycled with a new version
+    REQUIRE(SAGE::ECS::detail::DecodeIndex(entities[0]) == SAGE::ECS::detail::DecodeIndex(stale));
+    REQUIRE(entities[0] != stale);
+
+    std::vector<Transform> transforms(entities.size());
+    for (size_t i = 0; i < transforms.size(); ++i) {
+        transforms[i].x = static_cast<float>(i);
+    }
+    reg.Insert<Transform>(entities, transforms);
+    reg.Insert<Velocity>(std::span<const Entity>(entities).first(10), Velocity{2.0f, 0.0f});
+    reg.Insert<TagA>(entities);
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        REQUIRE(reg.Get<Transform>(entities[i])->x == Approx(static_cast<float>(i)));
+        REQUIRE(reg.Has<TagA>(entities[i]));
+        REQUIRE(reg.Has<Velocity>(entities[i]) == (i < 10));
+    }
+
+    int both = 0;
+    reg.ForEach<const Transform, const Velocity>([&](Entity, const Transform&, const Velocity& v) {
+        REQUIRE(v.vx == Approx(2.0f));
+        ++both;
+    });
+    REQUIRE(both == 10);
+
+    // Inserting again overwrites
+    reg.Insert<Velocity>(std::span<const Entity>(entities).first(1), Velocity{5.0f, 0.0f});
+    REQUIRE(reg.Get<Velocity>(entities[0])->vx == Approx(5.0f));
+    REQUIRE(reg.GetPoolMemoryStats<Velocity>().entityCount == 10);
+}
+
+TEST_CASE("Registry sorts component pools in place", "[ecs][registry]") {
+    Registry reg;
+    std::vector<Entity> entities(200);
+    reg.CreateEntities(entities.size(), entities);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        // Scrambled keys, with duplicates so stability is observable
+        reg.Add<Transform>(entities[i], Transform{static_cast<float>((i * 37) % 50), static_cast<float>(i)});
+        if (i % 3 == 0) reg.Add<Velocity>(entities[i], Velocity{static_cast<float>(i), 0.0f});
+    }
+
+    auto expectSorted = [&](bool yTieBreak) {
+        float lastX = -1.0f;
+        float lastY = -1.0f;
+        reg.ForEach<const Transform>([&](Entity e, const Transform& t) {
+            REQUIRE(t.x >= lastX);
+            if (yTieBreak && t.x == lastX) REQUIRE(t.y > lastY); // stable
+            lastX = t.x;
+            lastY = t.y;
+            // Sparse indices follow the moved components
+            REQUIRE(reg.Get<Transform>(e) == &t);
+        });
+    };
+
+    reg.Sort<Transform>([](const Transform& a, const Transform& b) { return a.x < b.x; });
+    expectSorted(true);
+
+    // Nearly sorted input goes through the insertion sort path; the moved
+    // entry lands after its new equals
+    reg.Get<Transform>(entities[5])->x = 0.0f;
+    reg.Sort<Transform>([](const Transform& a, const Transform& b) { return a.x < b.x; });
+    expectSorted(false);
+    Entity lastZero = SAGE::ECS::kInvalidEntity;
+    reg.ForEach<const Transform>([&](Entity e, const Transform& t) {
+        if (t.x == 0.0f) lastZero = e;
+    });
+    REQUIRE(lastZero == entities[5]);
+
+    // Radix variant orders by descending y
+    reg.SortByKey<Transform>([](const Transform& t) { return 1000u - static_cast<uint32_t>(t.y); });
+    float lastY = 1e9f;
+    reg.ForEach<const Transform>([&](Entity, const Transform& t) {
+        REQUIRE(t.y < lastY);
+        lastY = t.y;
+    });
+
+    // A slice is sorted on its own; the rest keeps its order
+    reg.SortByKey<Transform>([](const Transform& t) { return static_cast<uint32_t>(t.y); }, 10, 20);
+    std::vector<float> ys;
+    reg.ForEach<const Transform>([&](Entity, const Transform& t) { ys.push_back(t.y); });
+    REQUIRE(std::is_sorted(ys.begin() + 10, ys.begin() + 20));
+    REQUIRE(ys[9] > ys[19]);
+    REQUIRE(ys[10] > ys[20]);
+    reg.SortByKey<Transform>([](const Transform& t) { return 1000u - static_cast<uint32_t>(t.y); }, 10, 20);
+
+    // Velocity takes the Transform order
+    reg.SortAs<Velocity, Transform>();
+    float lastVx = 1e9f;
+    reg.ForEach<const Velocity>([&](Entity e, const Velocity& v) {
+        REQUIRE(v.vx < lastVx);
+        REQUIRE(reg.Get<Transform>(e)->y == Approx(v.vx));
+        lastVx = v.vx;
+    });
+
+    reg.Group<Transform, Velocity>();
+    bool thrown = false;
+    try {
+        reg.Sort<Transform>([](const Transform& a, const Transform& b) { return a.x < b.x; });
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    REQUIRE(thrown);
+}
+
+TEST_CASE("Registry context holds one instance per type", "[ecs][registry]") {
+    struct Settings {
+        int difficulty = 1;
+    };
+
+    Registry reg;
+    REQUIRE(reg.FindCtx<Settings>() == nullptr);
+
+    reg.Ctx<Settings>().difficulty = 3;
+    REQUIRE(reg.FindCtx<Settings>() == &reg.Ctx<Settings>());
+    REQUIRE(reg.Ctx<Settings>().difficulty == 3);
+
+    // Context is not a component and survives Clear()
+    reg.Clear();
+    REQUIRE(std::as_const(reg).FindCtx<Settings>()->difficulty == 3);
+    REQUIRE(reg.GetMemoryReport().empty());
+
+    reg.EmplaceCtx<Settings>(Settings{7});
+    REQUIRE(reg.Ctx<Settings>().difficulty == 7);
+
+    reg.EraseCtx<Settings>();
+    REQUIRE(reg.FindCtx<Settings>() == nullptr);
+}
+
+namespace {
+    struct SignalLog {
+        std::vector<Entity> constructed;
+        std::vector<Entity> updated;
+        std::vector<Entity> destroyed;
+        float lastX = 0.0f;
+
+        void OnConstruct(Registry&, Entity e) { constructed.push_back(e); }
+        void OnUpdate(Registry&, Entity e) { updated.push_back(e); }
+        void OnDestroy(Registry& reg, Entity e) {
+            // The component is still readable while its destroy signal runs
+            lastX = std::as_const(reg).Get<Transform>(e)->x;
+            destroyed.push_back(e);
+        }
+    };
+
+    int g_FreeListenerCalls = 0;
+    void CountConstruct(Registry&, Entity) { ++g_FreeListenerCalls; }
+}
+
+TEST_CASE("Component signals notify every listener", "[ecs][signals]") {
+    Registry reg;
+    SignalLog first;
+    SignalLog second;
+    reg.OnConstruct<Transform>().Connect<&SignalLog::OnConstruct>(&first);
+    reg.OnConstruct<Transform>().Connect<&SignalLog::OnConstruct>(&second);
+    reg.OnUpdate<Transform>().Connect<&SignalLog::OnUpdate>(&first);
+    reg.OnDestroy<Transform>().Connect<&SignalLog::OnDestroy>(&first);
+    g_FreeListenerCalls = 0;
+    reg.OnConstruct<Transform>().Connect<&CountConstruct>();
+
+    auto a = reg.CreateEntity();
+    auto b = reg.CreateEntity();
+    reg.Add<Transform>(a, Transform{1.0f, 0.0f});
+    std::vector<Entity> batch{b};
+    reg.Insert<Transform>(batch, Transform{2.0f, 0.0f});
+    REQUIRE(first.constructed.size() == 2);
+    REQUIRE(second.constructed.size() == 2);
+    REQUIRE(g_FreeListenerCalls == 2);
+
+    reg.Patch<Transform>(a, [](Transform& t) { t.x = 5.0f; });
+    reg.MarkChanged<Transform>(b);
+    REQUIRE((first.updated == std::vector<Entity>{a, b}));
+
+    reg.Remove<Transform>(a);
+    REQUIRE(first.destroyed == std::vector<Entity>{a});
+    REQUIRE(first.lastX == Approx(5.0f));
+    reg.DestroyEntity(b);
+    REQUIRE(first.destroyed.size() == 2);
+    REQUIRE(first.lastX == Approx(2.0f));
+
+    reg.OnConstruct<Transform>().Disconnect(&second);
+    reg.OnConstruct<Transform>().Disconnect<&CountConstruct>();
+    reg.Add<Transform>(reg.CreateEntity());
+    REQUIRE(first.constructed.size() == 3);
+    REQUIRE(second.constructed.size() == 2);
+    REQUIRE(g_FreeListenerCalls == 2);
+
+    reg.Clear();
+    REQUIRE(first.destroyed.size() == 3);
+}
+
+TEST_CASE("Collector yields only newly matching entities", "[ecs][signals]") {
+    Registry reg;
+    auto existing = reg.CreateEntity();
+    reg.Add<Transform>(existing);
+    reg.Add<Velocity>(existing);
+
+    Collector<Velocity, Transform> collector(reg);
+
+    auto late = reg.CreateEntity();
+    reg.Add<Velocity>(late);      // no Transform yet
+    auto removed = reg.CreateEntity();
+    reg.Add<Transform>(removed);
+    reg.Add<Velocity>(removed);
+    reg.Remove<Velocity>(removed);
+    reg.Add<Transform>(late);     // now matches
+    reg.Add<Transform>(late);     // already collected
+
+    std::vector<Entity> seen;
+    collector.Each([&](Entity e) { seen.push_back(e); });
+    REQUIRE((seen == std::vector<Entity>{existing, late}));
+
+    // Drained: nothing until the next match
+    seen.clear();
+    collector.Each([&](Entity e) { seen.push_back(e); });
+    REQUIRE(seen.empty());
+
+    auto next = reg.CreateEntity();
+    reg.Add<Transform>(next);
+    reg.Add<Velocity>(next);
+    collector.Each([&](Entity e) { seen.push_back(e); });
+    REQUIRE(seen == std::vector<Entity>{next});
+}
+
+TEST_CASE("Archetype storage behaves like the sparse-set backend", "[ecs][archetype]") {
+    for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        Registry reg(mode);
+        REQUIRE(reg.GetStorageMode() == mode);
+
+        // Enough entities to span several chunks
+        constexpr int kCount = 3000;
+        std::vector<Entity> entities;
+        for (int i = 0; i < kCount; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<Transform>(e, Transform{static_cast<float>(i), 0.0f});
+            if (i % 2 == 0) reg.Add<Velocity>(e, Velocity{1.0f, 2.0f});
+            if (i % 3 == 0) reg.Add<TagA>(e);
+            entities.push_back(e);
+        }
+        REQUIRE(reg.Count<Transform>() == kCount);
+        REQUIRE(reg.Count<Velocity>() == kCount / 2);
+        REQUIRE(reg.Count<TagA>() == kCount / 3);
+        REQUIRE(reg.Get<Transform>(entities[10])->x == Approx(10.0f));
+        REQUIRE(reg.Has<TagA>(entities[9]));
+        REQUIRE_FALSE(reg.Has<Velocity>(entities[9]));
+
+        int moved = 0;
+        reg.ForEach<Transform, const Velocity>([&](Entity, Transform& t, const Velocity& v) {
+            t.x += v.vx;
+            ++moved;
+        });
+        REQUIRE(moved == kCount / 2);
+        REQUIRE(reg.Get<Transform>(entities[10])->x == Approx(11.0f));
+        REQUIRE(reg.Get<Transform>(entities[11])->x == Approx(11.0f));
+
+        int tagged = 0;
+        reg.ForEach<TagA, const Transform>([&](Entity e, TagA&, const Transform&) {
+            REQUIRE(reg.Has<TagA>(e));
+            ++tagged;
+        });
+        REQUIRE(tagged == kCount / 3);
+
+        // Removing a component keeps the others, in either order
+        reg.Remove<Transform>(entities[4]);
+        REQUIRE_FALSE(reg.Has<Transform>(entities[4]));
+        REQUIRE(reg.Get<Velocity>(entities[4])->vy == Approx(2.0f));
+        reg.Remove<Velocity>(entities[6]);
+        REQUIRE(reg.Get<Transform>(entities[6])->x == Approx(7.0f));
+        REQUIRE(reg.Has<TagA>(entities[6]));
+
+        // Destroying entities leaves the survivors intact
+        for (int i = 0; i < kCount; i += 5) {
+            reg.DestroyEntity(entities[i]);
+        }
+        REQUIRE(reg.Count<Transform>() == kCount - kCount / 5 - 1);
+        float sum = 0.0f;
+        int visited = 0;
+        reg.ForEach<const Transform>([&](Entity, const Transform& t) { sum += t.x; ++visited; });
+        REQUIRE(visited == static_cast<int>(reg.Count<Transform>()));
+        REQUIRE(reg.Get<Transform>(entities[2999])->x == Approx(2999.0f));
+
+        // Change detection
+        reg.ClearChangeTracking();
+        reg.Get<Transform>(entities[1])->y = 5.0f;
+        std::vector<Entity> changed;
+        reg.ForEach<Changed<Transform>>([&](Entity e) { changed.push_back(e); });
+        REQUIRE(changed == std::vector<Entity>{entities[1]});
+        REQUIRE(reg.IsChanged<Transform>(entities[1]));
+        REQUIRE_FALSE(reg.IsChanged<Transform>(entities[2]));
+
+        // Bulk insert overwrites existing components and adds missing ones
+        std::vector<Entity> batch{entities[1], entities[3]};
+        reg.Insert<Velocity>(batch, Velocity{3.0f, 3.0f});
+        REQUIRE(reg.Get<Velocity>(entities[1])->vx == Approx(3.0f));
+        REQUIRE(reg.Get<Velocity>(entities[3])->vx == Approx(3.0f));
+
+        reg.Clear();
+        REQUIRE(reg.Count<Transform>() == 0);
+        REQUIRE(reg.AliveCount() == 0);
+    }
+}
+
+TEST_CASE("Archetype storage publishes component signals", "[ecs][archetype]") {
+    Registry reg(StorageMode::Archetype);
+    int constructed = 0;
+    int destroyed = 0;
+    struct Counter {
+        int* value;
+        void Bump(Registry&, Entity) { ++*value; }
+    };
+    Counter onConstruct{&constructed};
+    Counter onDestroy{&destroyed};
+    reg.OnConstruct<Velocity>().Connect<&Counter::Bump>(&onConstruct);
+    reg.OnDestroy<Velocity>().Connect<&Counter::Bump>(&onDestroy);
+
+    auto a = reg.CreateEntity();
+    auto b = reg.CreateEntity();
+    reg.Add<Velocity>(a);
+    reg.Add<Transform>(a);
+    reg.Add<Velocity>(b);
+    REQUIRE(constructed == 2);
+
+    reg.Remove<Velocity>(b);
+    reg.DestroyEntity(a);
+    REQUIRE(destroyed == 2);
+
+    // Backend can only change while no entity has components
+    auto c = reg.CreateEntity();
+    reg.Add<Transform>(c);
+    bool threw = false;
+    try {
+        reg.SetStorageMode(StorageMode::SparseSet);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    REQUIRE(threw);
+
+    // Pool-only features are rejected
+    threw = false;
+    try {
+        reg.Sort<Transform>([](const Transform& l, const Transform& r) { return l.x < r.x; });
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    REQUIRE(threw);
+}
+
+TEST_CASE("Registry snapshot restores entities and components", "[ecs][snapshot]") {
+    struct Shared { std::shared_ptr<int> value; };
+
+    Registry reg;
+    auto a = reg.CreateEntity();
+    auto b = reg.CreateEntity();
+    auto doomed = reg.CreateEntity();
+    reg.DestroyEntity(doomed);
+    reg.Add<Transform>(a, Transform{1.0f, 2.0f});
+    reg.Add<Transform>(b, Transform{3.0f, 4.0f});
+    reg.Add<TagA>(b);
+    reg.Add<Shared>(a, Shared{std::make_shared<int>(7)});
+    reg.SetCopyHook<Shared>([](const Shared& s) { return Shared{std::make_shared<int>(*s.value)}; });
+
+    const RegistrySnapshot snapshot = reg.Snapshot();
+    REQUIRE(snapshot.AliveCount() == 2);
+
+    // Mutate the live world
+    reg.Get<Transform>(a)->x = 100.0f;
+    *reg.Get<Shared>(a)->value = 99;
+    reg.Remove<TagA>(b);
+    reg.DestroyEntity(b);
+    auto added = reg.CreateEntity();
+    reg.Add<Velocity>(added);
+    int removeCallbacks = 0;
+    reg.SetOnComponentRemoved<Velocity>([&](Entity, Velocity&) { ++removeCallbacks; });
+
+    // The Velocity pool did not exist at snapshot time: emptied silently
+    reg.Restore(snapshot);
+    REQUIRE(removeCallbacks == 0);
+    REQUIRE(reg.AliveCount() == 2);
+    REQUIRE(reg.IsAlive(a));
+    REQUIRE(reg.IsAlive(b));
+    REQUIRE_FALSE(reg.IsAlive(added));
+    REQUIRE_FALSE(reg.IsAlive(doomed));
+    REQUIRE(reg.Get<Transform>(a)->x == Approx(1.0f));
+    REQUIRE(reg.Get<Transform>(b)->y == Approx(4.0f));
+    REQUIRE(reg.Has<TagA>(b));
+    REQUIRE(reg.Count<Velocity>() == 0);
+    // The hook deep-copied the shared value
+    REQUIRE(*reg.Get<Shared>(a)->value == 7);
+    *reg.Get<Shared>(a)->value = 8;
+    reg.Restore(snapshot);
+    REQUIRE(*reg.Get<Shared>(a)->value == 7);
+
+    // Free list comes back too: the next entity reuses the destroyed slot
+    auto again = reg.CreateEntity();
+    REQUIRE(detail::DecodeIndex(again) == detail::DecodeIndex(doomed));
+    REQUIRE_FALSE(reg.IsAlive(doomed));
+
+    // Restoring into another registry clones the world
+    Registry clone;
+    clone.Restore(snapshot);
+    REQUIRE(clone.AliveCount() == 2);
+    REQUIRE(clone.Get<Transform>(b)->x == Approx(3.0f));
+    int visited = 0;
+    clone.ForEach<const Transform, TagA>([&](Entity e, const Transform&, TagA&) {
+        REQUIRE(e == b);
+        ++visited;
+    });
+    REQUIRE(visited == 1);
+}
+
+TEST_CASE("Registry restore re-packs owning groups", "[ecs][snapshot]") {
+    Registry reg;
+    auto group = reg.Group<Transform, Velocity>();
+    std::vector<Entity> entities;
+    for (int i = 0; i < 8; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<Transform>(e, Transform{static_cast<float>(i), 0.0f});
+        if (i % 2 == 0) reg.Add<Velocity>(e);
+        entities.push_back(e);
+    }
+    const RegistrySnapshot snapshot = reg.Snapshot();
+    reg.Remove<Velocity>(entities[0]);
+    reg.Add<Velocity>(entities[1]);
+
+    reg.Restore(snapshot);
+    REQUIRE(group.Size() == 4);
+    int visited = 0;
+    reg.ForEach<Transform, Velocity>([&](Entity e, Transform&, Velocity&) {
+        REQUIRE(detail::DecodeIndex(e) % 2 == 1); // entities[0], [2]... have indices 1, 3...
+        ++visited;
+    });
+    REQUIRE(visited == 4);
+}
+
+TEST_CASE("ForEach filters with With, Without and Optional", "[ecs][query]") {
+    struct Unused { int value = 0; };
+    for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        Registry reg(mode);
+        auto plain = reg.CreateEntity();
+        reg.Add<Transform>(plain, Transform{1.0f, 0.0f});
+        auto moving = reg.CreateEntity();
+        reg.Add<Transform>(moving, Transform{2.0f, 0.0f});
+        reg.Add<Velocity>(moving, Velocity{5.0f, 0.0f});
+        auto tagged = reg.CreateEntity();
+        reg.Add<Transform>(tagged, Transform{3.0f, 0.0f});
+        reg.Add<TagA>(tagged);
+        auto both = reg.CreateEntity();
+        reg.Add<Transform>(both, Transform{4.0f, 0.0f});
+        reg.Add<TagA>(both);
+        reg.Add<TagB>(both);
+        reg.Add<Velocity>(both, Velocity{6.0f, 0.0f});
+
+        std::vector<Entity> seen;
+        reg.ForEach<const Transform, Without<TagA>>([&](Entity e, const Transform&) { seen.push_back(e); });
+        REQUIRE((seen == std::vector<Entity>{plain, moving}));
+
+        seen.clear();
+        reg.ForEach<With<TagA, TagB>, const Transform>([&](Entity e, const Transform&) { seen.push_back(e); });
+        REQUIRE(seen == std::vector<Entity>{both});
+
+        seen.clear();
+        reg.ForEach<const Transform, Without<TagB, Velocity>>([&](Entity e, const Transform&) { seen.push_back(e); });
+        REQUIRE((seen == std::vector<Entity>{plain, tagged}));
+
+        // Optional components arrive as pointers, in term order
+        float velocitySum = 0.0f;
+        int withoutVelocity = 0;
+        reg.ForEach<Optional<const Velocity>, const Transform>([&](Entity e, const Velocity* v, const Transform& t) {
+            REQUIRE(t.x > 0.0f);
+            if (v) {
+                REQUIRE(reg.Has<Velocity>(e));
+                velocitySum += v->vx;
+            } else {
+                ++withoutVelocity;
+            }
+        });
+        REQUIRE(velocitySum == Approx(11.0f));
+        REQUIRE(withoutVelocity == 2);
+
+        // A missing optional pool is not an error; a writable optional is stamped
+        int visited = 0;
+        reg.ForEach<const Transform, Optional<Unused>>([&](Entity, const Transform&, Unused* unused) {
+            REQUIRE(unused == nullptr);
+            ++visited;
+        });
+        REQUIRE(visited == 4);
+
+        reg.ClearChangeTracking();
+        reg.ForEach<With<TagB>, Optional<Velocity>>([&](Entity, Velocity* v) {
+            REQUIRE(v != nullptr);
+            v->vx = 0.0f;
+        });
+        REQUIRE(reg.IsChanged<Velocity>(both));
+        REQUIRE_FALSE(reg.IsChanged<Velocity>(moving));
+
+        // Filters combine with change detection
+        seen.clear();
+        reg.ForEach<Changed<Velocity>, Without<TagA>>([&](Entity e) { seen.push_back(e); });
+        REQUIRE(seen.empty());
+        reg.Get<Velocity>(moving)->vy = 1.0f;
+        reg.ForEach<Changed<Velocity>, Without<TagA>>([&](Entity e) { seen.push_back(e); });
+        REQUIRE(seen == std::vector<Entity>{moving});
+    }
+}
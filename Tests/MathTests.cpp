@@ -3,6 +3,13 @@
 #include "SAGE/Math/Matrix3.h"
 #include "SAGE/Math/Color.h"
 #include "SAGE/Math/Rect.h"
+#include "SAGE/Math/Morton.h"
+#include "SAGE/Math/RadixSort.h"
+#include "SAGE/Graphics/SpriteSortKey.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
 
 using namespace SAGE;
 
@@ -113,6 +120,18 @@ TEST_CASE("Matrix3 operations", "[math][matrix3]") {
         REQUIRE(p.y == Catch::Approx(22.0f));
     }
 
+    SECTION("TRS and affine product match the full product") {
+        Matrix3 full = Matrix3::Translation({3.0f, -4.0f}) * Matrix3::Rotation(0.7f) * Matrix3::Scale({2.0f, 0.5f});
+        Matrix3 trs = Matrix3::TRS({3.0f, -4.0f}, 0.7f, {2.0f, 0.5f});
+        Matrix3 parent = Matrix3::TRS({10.0f, 5.0f}, -1.2f, {1.5f, 1.5f});
+        Matrix3 fullChild = parent * full;
+        Matrix3 affineChild = parent.MultiplyAffine(trs);
+        for (int i = 0; i < 9; ++i) {
+            REQUIRE(trs.m[i] == Catch::Approx(full.m[i]).margin(1e-5f));
+            REQUIRE(affineChild.m[i] == Catch::Approx(fullChild.m[i]).margin(1e-4f));
+        }
+    }
+
     SECTION("Matrix inverse") {
         Matrix3 t = Matrix3::Translation({10.0f, 20.0f});
         Matrix3 inv = t.Inverse();
@@ -198,3 +217,79 @@ TEST_CASE("Rect operations", "[math][rect]") {
         REQUIRE(r.Top() == 70.0f);
     }
 }
+
+TEST_CASE("Morton codes", "[math][morton]") {
+    SECTION("Interleaves x into even and y into odd bits") {
+        REQUIRE(Morton::Encode(0, 0) == 0u);
+        REQUIRE(Morton::Encode(1, 0) == 1u);
+        REQUIRE(Morton::Encode(0, 1) == 2u);
+        REQUIRE(Morton::Encode(3, 3) == 15u);
+        REQUIRE(Morton::Encode(0xFFFFFFFFu, 0) == 0x5555555555555555ull);
+    }
+
+    SECTION("Positions in the same cell share a code") {
+        REQUIRE(Morton::FromPosition({10.0f, 10.0f}, 64.0f) == Morton::FromPosition({60.0f, 1.0f}, 64.0f));
+        REQUIRE(Morton::FromPosition({10.0f, 10.0f}, 64.0f) != Morton::FromPosition({70.0f, 10.0f}, 64.0f));
+    }
+
+    SECTION("Negative cells order before positive ones") {
+        REQUIRE(Morton::FromPosition({-1.0f, -1.0f}, 1.0f) < Morton::FromPosition({0.0f, 0.0f}, 1.0f));
+        REQUIRE(Morton::FromPosition({-5.0f, 3.0f}, 1.0f) < Morton::FromPosition({5.0f, 3.0f}, 1.0f));
+    }
+}
+
+TEST_CASE("Radix sort", "[math][sort]") {
+    std::vector<SortEntry> scratch;
+
+    SECTION("Matches a stable sort on random keys") {
+        std::mt19937_64 rng(7);
+        for (size_t count : {0u, 1u, 5u, 32u, 33u, 1000u}) {
+            std::vector<SortEntry> entries(count);
+            for (size_t i = 0; i < count; ++i) {
+                // Few distinct values so equal keys exercise stability
+                entries[i] = {rng() % 16 << 40 | rng() % 4, static_cast<uint32_t>(i)};
+            }
+            std::vector<SortEntry> expected = entries;
+            std::stable_sort(expected.begin(), expected.end(),
+                             [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+            RadixSort(entries, scratch);
+            REQUIRE(entries.size() == expected.size());
+            for (size_t i = 0; i < count; ++i) {
+                REQUIRE(entries[i].key == expected[i].key);
+                REQUIRE(entries[i].index == expected[i].index);
+            }
+        }
+    }
+
+    SECTION("Full 64-bit keys") {
+        std::vector<SortEntry> entries;
+        for (uint32_t i = 0; i < 100; ++i) {
+            entries.push_back({~0ull - i * 0x0101010101010101ull, i});
+        }
+        RadixSort(entries, scratch);
+        REQUIRE(entries.front().index == 99u);
+        REQUIRE(entries.back().index == 0u);
+        REQUIRE(scratch.capacity() >= 100);
+    }
+}
+
+TEST_CASE("Sprite sort keys", "[math][sort]") {
+    const uint32_t tex = 5;
+    SECTION("Translucent draws follow opaque ones") {
+        REQUIRE(SpriteSortKey::Make(false, 100, 0, 0, tex) < SpriteSortKey::Make(true, -100, 0, 0, tex));
+    }
+
+    SECTION("Layer, then depth, then sequence, then texture") {
+        REQUIRE(SpriteSortKey::Make(false, -1, 0, 0, tex) < SpriteSortKey::Make(false, 0, 0, 0, tex));
+        REQUIRE(SpriteSortKey::Make(false, 0, 9, 0, tex) < SpriteSortKey::Make(false, 1, 0, 0, tex));
+        REQUIRE(SpriteSortKey::Make(false, 0, 1, 0, tex) < SpriteSortKey::Make(false, 0, 2, 0, 0));
+        REQUIRE(SpriteSortKey::Make(true, 0, 0, 3, tex) < SpriteSortKey::Make(true, 0, 0, 4, 0));
+        REQUIRE(SpriteSortKey::Make(false, 0, 0, 0, 1) < SpriteSortKey::Make(false, 0, 0, 0, 2));
+    }
+
+    SECTION("Out of range fields are clamped or masked") {
+        REQUIRE(SpriteSortKey::Make(false, 1 << 20, 0, 0, 0) == SpriteSortKey::Make(false, 32767, 0, 0, 0));
+        REQUIRE(SpriteSortKey::Make(false, 0, 1u << 20, 0, 0) == SpriteSortKey::Make(false, 0, SpriteSortKey::kMaxDepth, 0, 0));
+        REQUIRE(SpriteSortKey::Make(false, 0, 0, 0, 1u << SpriteSortKey::kTextureBits) == SpriteSortKey::Make(false, 0, 0, 0, 0));
+    }
+}
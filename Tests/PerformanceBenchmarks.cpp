@@ -7,8 +7,19 @@
 #include "SAGE/Math/QuadTree.h"
 #include "SAGE/Graphics/ParticleEmitter.h"
 #include "SAGE/Core/Profiler.h"
+#include "SAGE/Core/ECS.h"
+#include "SAGE/Core/ECSComponents.h"
+#include "SAGE/Core/ECSSystems.h"
+#include "SAGE/Core/MotionStreams.h"
+#include "SAGE/Core/JobSystem.h"
+#include "SAGE/Math/Morton.h"
+#include "SAGE/Math/RadixSort.h"
+#include "SAGE/Graphics/SpriteSortKey.h"
 #include <chrono>
+#include <cmath>
+#include <algorithm>
 #include <random>
+#include <utility>
 
 using namespace SAGE;
 using namespace std::chrono;
@@ -346,3 +357,699 @@ TEST_CASE("Benchmark - Real-World Scenarios", "[Benchmark][Integration]") {
         REQUIRE(avgMs < 10.0); // Should be well within frame budget
     }
 }
+
+namespace {
+    struct BenchPosition { float x = 0.0f; float y = 0.0f; };
+    struct BenchVelocity { float vx = 1.0f; float vy = 1.0f; };
+
+    // Every entity gets a position, three out of four a velocity (in shuffled order)
+    void PopulateMovers(ECS::Registry& reg, int count) {
+        std::vector<ECS::Entity> entities;
+        entities.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<BenchPosition>(e);
+            entities.push_back(e);
+        }
+        std::mt19937 gen(42);
+        std::shuffle(entities.begin(), entities.end(), gen);
+        for (int i = 0; i < count; ++i) {
+            if (i % 4 != 0) reg.Add<BenchVelocity>(entities[i]);
+        }
+    }
+
+    long long TimeMovementPasses(ECS::Registry& reg, int passes, double& checksum) {
+        auto start = high_resolution_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            reg.ForEach<BenchPosition, const BenchVelocity>([](ECS::Entity, BenchPosition& p, const BenchVelocity& v) {
+                p.x += v.vx * 0.016f;
+                p.y += v.vy * 0.016f;
+            });
+        }
+        auto end = high_resolution_clock::now();
+        checksum = 0.0;
+        reg.ForEach<BenchPosition>([&](ECS::Entity, BenchPosition& p) { checksum += p.x; });
+        return duration_cast<microseconds>(end - start).count();
+    }
+}
+
+TEST_CASE("Benchmark - ECS Group Iteration", "[Benchmark][ECS]") {
+    for (int count : {100000, 1000000}) {
+        ECS::Registry plain;
+        ECS::Registry grouped;
+        PopulateMovers(plain, count);
+        PopulateMovers(grouped, count);
+        grouped.Group<BenchPosition, BenchVelocity>();
+
+        double plainSum = 0.0;
+        double groupSum = 0.0;
+        auto plainTime = TimeMovementPasses(plain, 10, plainSum);
+        auto groupTime = TimeMovementPasses(grouped, 10, groupSum);
+
+        float speedup = static_cast<float>(plainTime) / static_cast<float>(std::max<long long>(groupTime, 1));
+        std::cout << "  ForEach<Position, Velocity> x10 @ " << count << " entities: sparse "
+                  << plainTime << " us, group " << groupTime << " us (x" << speedup << ")\n";
+
+        REQUIRE(plainSum == Catch::Approx(groupSum).margin(1.0));
+        REQUIRE(plainTime > 0);
+    }
+}
+
+namespace {
+    template<int N>
+    struct BenchFiller { int value = N; };
+
+    template<int... Ns>
+    void RegisterFillerPools(ECS::Registry& reg, std::integer_sequence<int, Ns...>) {
+        auto e = reg.CreateEntity();
+        (reg.Add<BenchFiller<Ns>>(e), ...);
+        reg.DestroyEntity(e);
+    }
+
+    long long TimeMassDestroy(ECS::Registry& reg, int count) {
+        std::vector<ECS::Entity> bullets;
+        bullets.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<BenchPosition>(e);
+            reg.Add<BenchVelocity>(e);
+            bullets.push_back(e);
+        }
+        auto start = high_resolution_clock::now();
+        for (auto e : bullets) {
+            reg.DestroyEntity(e);
+        }
+        auto end = high_resolution_clock::now();
+        return duration_cast<microseconds>(end - start).count();
+    }
+}
+
+TEST_CASE("Benchmark - ECS Mass Destroy", "[Benchmark][ECS]") {
+    constexpr int kBullets = 100000;
+
+    // Same bullets, with and without 40 unrelated component pools registered
+    ECS::Registry fewPools;
+    ECS::Registry manyPools;
+    RegisterFillerPools(manyPools, std::make_integer_sequence<int, 40>{});
+
+    auto fewTime = TimeMassDestroy(fewPools, kBullets);
+    auto manyTime = TimeMassDestroy(manyPools, kBullets);
+
+    std::cout << "  DestroyEntity x" << kBullets << ": 2 pools " << fewTime
+              << " us, 42 pools " << manyTime << " us\n";
+
+    REQUIRE(fewPools.AliveCount() == 0);
+    REQUIRE(manyPools.AliveCount() == 0);
+    // Cost follows the components an entity owns, not the number of pools
+    REQUIRE(manyTime < fewTime * 4 + 1000);
+}
+
+TEST_CASE("Benchmark - ECS ParallelForEach", "[Benchmark][ECS]") {
+    SAGE::JobSystem jobs;
+    std::cout << "  workers: " << jobs.GetWorkerCount() << " (+ calling thread)\n";
+
+    auto integrate = [](ECS::Entity, BenchPosition& p, const BenchVelocity& v) {
+        p.x += v.vx * 0.016f;
+        p.y += v.vy * 0.016f;
+    };
+
+    for (int count : {10000, 100000, 1000000}) {
+        ECS::Registry sequential;
+        ECS::Registry parallel;
+        PopulateMovers(sequential, count);
+        PopulateMovers(parallel, count);
+        parallel.SetJobSystem(&jobs);
+
+        auto start = high_resolution_clock::now();
+        for (int pass = 0; pass < 10; ++pass) {
+            sequential.ForEach<BenchPosition, const BenchVelocity>(integrate);
+        }
+        auto sequentialTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        start = high_resolution_clock::now();
+        for (int pass = 0; pass < 10; ++pass) {
+            parallel.ParallelForEach<BenchPosition, const BenchVelocity>(integrate);
+        }
+        auto parallelTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        double sequentialSum = 0.0;
+        double parallelSum = 0.0;
+        sequential.ForEach<const BenchPosition>([&](ECS::Entity, const BenchPosition& p) { sequentialSum += p.x; });
+        parallel.ForEach<const BenchPosition>([&](ECS::Entity, const BenchPosition& p) { parallelSum += p.x; });
+
+        std::cout << "  Movement x10 @ " << count << " entities: ForEach " << sequentialTime
+                  << " us, ParallelForEach " << parallelTime << " us\n";
+
+        REQUIRE(sequentialSum == Catch::Approx(parallelSum).margin(1.0));
+    }
+}
+
+TEST_CASE("Benchmark - ECS Bulk Creation", "[Benchmark][ECS]") {
+    constexpr int kCount = 100000;
+
+    ECS::Registry single;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < kCount; ++i) {
+        auto e = single.CreateEntity();
+        single.Add<BenchPosition>(e, BenchPosition{static_cast<float>(i), 0.0f});
+        single.Add<BenchVelocity>(e);
+    }
+    auto singleTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    ECS::Registry bulk;
+    std::vector<BenchPosition> positions(kCount);
+    for (int i = 0; i < kCount; ++i) {
+        positions[i].x = static_cast<float>(i);
+    }
+    start = high_resolution_clock::now();
+    std::vector<ECS::Entity> entities(kCount);
+    bulk.CreateEntities(entities.size(), entities);
+    bulk.Insert<BenchPosition>(entities, positions);
+    bulk.Insert<BenchVelocity>(entities);
+    auto bulkTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    std::cout << "  " << kCount << " entities x2 components: CreateEntity+Add " << singleTime
+              << " us, CreateEntities+Insert " << bulkTime << " us\n";
+
+    REQUIRE(bulk.AliveCount() == single.AliveCount());
+    REQUIRE(bulk.GetPoolMemoryStats<BenchVelocity>().entityCount == kCount);
+}
+
+TEST_CASE("Benchmark - ECS Storage Backends", "[Benchmark][ECS]") {
+    constexpr int kCount = 100000;
+
+    for (ECS::StorageMode mode : {ECS::StorageMode::SparseSet, ECS::StorageMode::Archetype}) {
+        const char* name = mode == ECS::StorageMode::SparseSet ? "sparse set" : "archetype";
+        ECS::Registry reg(mode);
+        PopulateMovers(reg, kCount);
+
+        double checksum = 0.0;
+        auto iterateTime = TimeMovementPasses(reg, 10, checksum);
+
+        // Add/remove churn: a status component toggled on a quarter of the movers
+        std::vector<ECS::Entity> movers;
+        reg.ForEach<const BenchVelocity>([&](ECS::Entity e, const BenchVelocity&) { movers.push_back(e); });
+        auto start = high_resolution_clock::now();
+        for (int pass = 0; pass < 4; ++pass) {
+            for (size_t i = pass; i < movers.size(); i += 4) reg.Add<BenchFiller<0>>(movers[i]);
+            for (size_t i = pass; i < movers.size(); i += 4) reg.Remove<BenchFiller<0>>(movers[i]);
+        }
+        auto churnTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        ECS::Registry destroyReg(mode);
+        auto destroyTime = TimeMassDestroy(destroyReg, kCount);
+
+        std::cout << "  " << name << " @ " << kCount << ": ForEach x10 " << iterateTime << " us, add/remove churn "
+                  << churnTime << " us, DestroyEntity " << destroyTime << " us";
+        if (mode == ECS::StorageMode::Archetype) {
+            std::cout << " (" << reg.ArchetypeCount() << " archetypes, " << reg.ArchetypeChunkBytes() / 1024 << " KB chunks)";
+        }
+        std::cout << "\n";
+
+        REQUIRE(checksum == Catch::Approx(kCount * 0.75 * 0.16).margin(1.0));
+        REQUIRE(reg.Count<BenchFiller<0>>() == 0);
+        REQUIRE(destroyReg.AliveCount() == 0);
+    }
+}
+
+TEST_CASE("Benchmark - ECS Snapshot and Restore", "[Benchmark][ECS]") {
+    constexpr int kCount = 100000;
+    ECS::Registry reg;
+    PopulateMovers(reg, kCount);
+
+    auto start = high_resolution_clock::now();
+    ECS::RegistrySnapshot snapshot = reg.Snapshot();
+    auto snapshotTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    reg.ForEach<BenchPosition>([](ECS::Entity, BenchPosition& p) { p.x += 1.0f; });
+
+    // Second restore reuses the live pools' allocations
+    start = high_resolution_clock::now();
+    reg.Restore(snapshot);
+    auto restoreTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    double checksum = 0.0;
+    reg.ForEach<const BenchPosition>([&](ECS::Entity, const BenchPosition& p) { checksum += p.x; });
+
+    std::cout << "  " << kCount << " entities: Snapshot " << snapshotTime << " us, Restore " << restoreTime << " us\n";
+
+    REQUIRE(checksum == Catch::Approx(0.0));
+    REQUIRE(reg.AliveCount() == kCount);
+    REQUIRE(snapshotTime < 20000); // a few ms expected; generous for debug builds
+}
+
+namespace {
+    // Uniform grid over entity handles, like a broadphase or culling index:
+    // the entities of a cell are scattered over the pool unless it is sorted
+    struct BenchGrid {
+        static constexpr int kCells = 64;
+        static constexpr float kCellSize = 5000.0f / kCells;
+        std::vector<std::vector<ECS::Entity>> cells = std::vector<std::vector<ECS::Entity>>(kCells * kCells);
+
+        static int CellOf(float v) { return std::clamp(static_cast<int>(v / kCellSize), 0, kCells - 1); }
+
+        void Build(ECS::Registry& reg) {
+            for (auto& cell : cells) cell.clear();
+            // Insert in pool order so a cell lists its entities in memory order
+            reg.ForEach<const BenchPosition>([&](ECS::Entity e, const BenchPosition& p) {
+                cells[CellOf(p.y) * kCells + CellOf(p.x)].push_back(e);
+            });
+        }
+    };
+
+    // Culling (entities of the cells under a view rect) and broadphase
+    // (neighbour cells of every cell) through Get<>, i.e. pool lookups
+    long long TimeSpatialQueries(ECS::Registry& reg, const BenchGrid& grid, double& checksum) {
+        const ECS::Registry& view = reg;
+        checksum = 0.0;
+        auto start = high_resolution_clock::now();
+        for (int viewY = 0; viewY + 8 <= BenchGrid::kCells; viewY += 4) {
+            for (int viewX = 0; viewX + 12 <= BenchGrid::kCells; viewX += 4) {
+                for (int y = viewY; y < viewY + 8; ++y) {
+                    for (int x = viewX; x < viewX + 12; ++x) {
+                        for (ECS::Entity e : grid.cells[y * BenchGrid::kCells + x]) checksum += view.Get<BenchPosition>(e)->x;
+                    }
+                }
+            }
+        }
+        for (int y = 1; y + 1 < BenchGrid::kCells; ++y) {
+            for (int x = 1; x + 1 < BenchGrid::kCells; ++x) {
+                for (int ny = y - 1; ny <= y + 1; ++ny) {
+                    for (ECS::Entity e : grid.cells[ny * BenchGrid::kCells + x - 1]) checksum += view.Get<BenchPosition>(e)->y;
+                    for (ECS::Entity e : grid.cells[ny * BenchGrid::kCells + x + 1]) checksum += view.Get<BenchPosition>(e)->y;
+                }
+            }
+        }
+        return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    }
+}
+
+TEST_CASE("Benchmark - ECS Morton Reordering", "[Benchmark][ECS]") {
+    constexpr int kCount = 500000;
+    ECS::Registry reg;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dist(0.0f, 5000.0f);
+    for (int i = 0; i < kCount; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<BenchPosition>(e, BenchPosition{dist(gen), dist(gen)});
+    }
+
+    BenchGrid grid;
+    grid.Build(reg);
+    double creationSum = 0.0;
+    auto creationTime = TimeSpatialQueries(reg, grid, creationSum);
+
+    auto start = high_resolution_clock::now();
+    reg.SortByKey<BenchPosition>([](const BenchPosition& p) { return Morton::FromPosition({p.x, p.y}, BenchGrid::kCellSize); });
+    auto sortTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    // Amortized upkeep: one eighth of the pool per frame
+    start = high_resolution_clock::now();
+    reg.SortByKey<BenchPosition>([](const BenchPosition& p) { return Morton::FromPosition({p.x, p.y}, BenchGrid::kCellSize); },
+                                 0, kCount / 8);
+    auto windowTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    grid.Build(reg);
+    double mortonSum = 0.0;
+    auto mortonTime = TimeSpatialQueries(reg, grid, mortonSum);
+
+    std::cout << "  culling + neighbour queries @ " << kCount << ": creation order " << creationTime
+              << " us, Morton order " << mortonTime << " us (full sort " << sortTime << " us, 1/8 window "
+              << windowTime << " us)\n";
+
+    REQUIRE(creationSum == Catch::Approx(mortonSum));
+}
+
+namespace {
+    void PopulateTransformMovers(ECS::Registry& reg, int count, bool soa) {
+        for (int i = 0; i < count; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<ECS::TransformComponent>(e).position = {static_cast<float>(i % 1000), static_cast<float>(i / 1000)};
+            auto& velocity = reg.Add<ECS::VelocityComponent>(e);
+            velocity.velocity = {1.0f + static_cast<float>(i % 7), -2.0f};
+            velocity.angularVelocity = 0.5f;
+            if (soa) reg.Add<ECS::SoAMotionTag>(e);
+        }
+    }
+
+    double TransformChecksum(ECS::Registry& reg) {
+        double checksum = 0.0;
+        reg.ForEach<const ECS::TransformComponent>([&](ECS::Entity, const ECS::TransformComponent& t) {
+            checksum += t.position.x + t.position.y + t.rotation;
+        });
+        return checksum;
+    }
+}
+
+TEST_CASE("Benchmark - ECS SoA Motion", "[Benchmark][ECS]") {
+    constexpr int kCount = 1000000;
+    constexpr int kFrames = 10;
+    constexpr float kDelta = 1.0f / 60.0f;
+
+    // AoS: the MovementSystem loop over TransformComponent/VelocityComponent
+    ECS::Registry aos;
+    PopulateTransformMovers(aos, kCount, false);
+    auto start = high_resolution_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        aos.ForEach<ECS::TransformComponent, const ECS::VelocityComponent>(
+            [](ECS::Entity, ECS::TransformComponent& t, const ECS::VelocityComponent& v) {
+                t.position += v.velocity * kDelta;
+                t.rotation += v.angularVelocity * kDelta;
+            });
+        aos.ClearChangeTracking();
+    }
+    auto aosTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    // SoA streams; ClearChangeTracking between frames stands in for the scheduler
+    ECS::Registry soa;
+    PopulateTransformMovers(soa, kCount, true);
+    auto& streams = ECS::UseMotionStreams(soa);
+    auto timeSteps = [&]() {
+        auto begin = high_resolution_clock::now();
+        for (int frame = 0; frame < kFrames; ++frame) {
+            streams.Step(kDelta);
+            soa.ClearChangeTracking();
+        }
+        return duration_cast<microseconds>(high_resolution_clock::now() - begin).count();
+    };
+    auto writeBackTime = timeSteps();
+    REQUIRE(TransformChecksum(soa) == Catch::Approx(TransformChecksum(aos)).margin(1.0));
+
+    streams.writeBack = false;
+    auto streamsTime = timeSteps();
+
+    std::cout << "  Motion x" << kFrames << " @ " << kCount << " entities (" << ECS::MotionSimdPath() << "): AoS "
+              << aosTime << " us, SoA + write-back " << writeBackTime << " us, SoA streams only "
+              << streamsTime << " us (x"
+              << static_cast<float>(aosTime) / static_cast<float>(std::max<long long>(streamsTime, 1)) << ")\n";
+
+    REQUIRE(streams.Size() == static_cast<size_t>(kCount));
+    REQUIRE(aosTime > 0);
+}
+
+TEST_CASE("Benchmark - ECS System Profiling Overhead", "[Benchmark][ECS]") {
+    constexpr int kCount = 10000;
+    constexpr int kSystems = 16;
+    constexpr int kFrames = 100;
+
+    struct MoveSystem : ECS::ISystem {
+        void Tick(ECS::Registry& reg, float dt) override {
+            reg.ForEach<BenchPosition, const BenchVelocity>([dt](ECS::Entity, BenchPosition& p, const BenchVelocity& v) {
+                p.x += v.vx * dt;
+            });
+        }
+    };
+
+    ECS::Registry reg;
+    PopulateMovers(reg, kCount);
+    ECS::SystemScheduler sched;
+    for (int i = 0; i < kSystems; ++i) sched.AddSystem<MoveSystem>();
+
+    // Ring only: the Profiler bridge is measured by its own benchmark
+    const bool profilerWasEnabled = Profiler::Get().IsEnabled();
+    Profiler::Get().SetEnabled(false);
+    auto timeFrames = [&]() {
+        auto start = high_resolution_clock::now();
+        for (int frame = 0; frame < kFrames; ++frame) sched.UpdateAll(reg, 0.016f);
+        return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    };
+    auto offTime = timeFrames();
+    sched.SetProfiling(true);
+    auto onTime = timeFrames();
+    Profiler::Get().SetEnabled(profilerWasEnabled);
+
+    const ECS::SystemProfile profile = sched.GetSystemProfile(0);
+    std::cout << "  " << kSystems << " systems x" << kFrames << " frames @ " << kCount << " entities: profiling off "
+              << offTime << " us, on " << onTime << " us; " << profile.name << " avg " << profile.avgMs
+              << " ms, p99 " << profile.p99Ms << " ms\n";
+
+    REQUIRE(profile.samples == static_cast<size_t>(kFrames));
+    REQUIRE(profile.avgEntities == Catch::Approx(kCount * 0.75));
+}
+
+TEST_CASE("Benchmark - ECS Collision Broadphase", "[Benchmark][ECS]") {
+    constexpr int kFrames = 10;
+
+    for (int count : {1000, 10000, 50000}) {
+        // ~64x64 world units per 16..48 collider: about one pair per collider
+        ECS::Registry reg;
+        std::mt19937 rng(static_cast<uint32_t>(count));
+        const float side = std::sqrt(static_cast<float>(count)) * 64.0f;
+        std::uniform_real_distribution<float> pos(0.0f, side);
+        std::uniform_real_distribution<float> extent(16.0f, 48.0f);
+        for (int i = 0; i < count; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<ECS::TransformComponent>(e).position = {pos(rng), pos(rng)};
+            reg.Add<ECS::ColliderComponent>(e).size = {extent(rng), extent(rng)};
+        }
+
+        ECS::CollisionSystem collision;
+        collision.Tick(reg, 0.0f); // warm up the reused buffers
+        auto start = high_resolution_clock::now();
+        for (int frame = 0; frame < kFrames; ++frame) {
+            reg.ForEach<ECS::TransformComponent>([frame](ECS::Entity, ECS::TransformComponent& t) {
+                t.position.x += (frame % 2 == 0) ? 4.0f : -4.0f;
+            });
+            collision.Tick(reg, 0.0f);
+        }
+        auto hashTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        std::cout << "  Collision x" << kFrames << " @ " << count << " colliders: spatial hash " << hashTime
+                  << " us, " << collision.GetPairs().size() << " pairs";
+
+        // The previous O(n^2) pair loop, on the sizes where it finishes
+        if (count <= 10000) {
+            std::vector<Rect> rects;
+            reg.ForEach<const ECS::ColliderComponent, const ECS::TransformComponent>(
+                [&](ECS::Entity, const ECS::ColliderComponent& c, const ECS::TransformComponent& t) {
+                    rects.push_back(Rect::FromCenter(t.position + c.offset, c.size));
+                });
+            size_t brutePairs = 0;
+            auto bruteStart = high_resolution_clock::now();
+            for (size_t i = 0; i < rects.size(); ++i) {
+                for (size_t j = i + 1; j < rects.size(); ++j) {
+                    brutePairs += rects[i].Intersects(rects[j]) ? 1 : 0;
+                }
+            }
+            auto bruteTime = duration_cast<microseconds>(high_resolution_clock::now() - bruteStart).count();
+            std::cout << "; O(n^2) single frame " << bruteTime << " us";
+            REQUIRE(brutePairs == collision.GetPairs().size());
+        }
+        std::cout << "\n";
+        REQUIRE(hashTime > 0);
+    }
+}
+
+TEST_CASE("Benchmark - ECS Sprite Culling", "[Benchmark][ECS]") {
+    constexpr int kCount = 100000;
+    constexpr int kFrames = 20;
+
+    // 20k x 20k world, 1280x720 camera: about 0.2% of the sprites on screen
+    auto populate = [](ECS::Registry& reg) {
+        auto texture = std::make_shared<Texture>();
+        auto camera = reg.CreateEntity();
+        reg.Add<ECS::CameraComponent>(camera).camera = Camera2D(1280.0f, 720.0f);
+        reg.Add<ECS::TransformComponent>(camera).position = {10000.0f, 10000.0f};
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> pos(0.0f, 20000.0f);
+        for (int i = 0; i < kCount; ++i) {
+            auto e = reg.CreateEntity();
+            reg.Add<ECS::TransformComponent>(e).position = {pos(rng), pos(rng)};
+            auto& sprite = reg.Add<ECS::SpriteComponent>(e);
+            sprite.sprite.SetTexture(texture);
+            sprite.layer = i % 4;
+        }
+    };
+    // Stands in for SpriteRenderer: one transformed quad per submitted sprite
+    std::vector<Vector2> vertices;
+    vertices.reserve(static_cast<size_t>(kCount) * 4);
+    auto timeFrames = [&vertices](ECS::Registry& reg, ECS::SpriteRenderSystem& system) {
+        system.SetDrawCallback([&vertices](const Sprite& sprite) {
+            const Matrix3 transform = Matrix3::Translation(sprite.transform.position) *
+                                      Matrix3::Rotation(sprite.transform.rotation);
+            const Vector2 size = sprite.GetSize();
+            vertices.push_back(transform.TransformPoint({0.0f, 0.0f}));
+            vertices.push_back(transform.TransformPoint({size.x, 0.0f}));
+            vertices.push_back(transform.TransformPoint({size.x, size.y}));
+            vertices.push_back(transform.TransformPoint({0.0f, size.y}));
+        });
+        system.Tick(reg, 0.016f); // first frame computes every AABB
+        reg.ClearChangeTracking();
+        auto start = high_resolution_clock::now();
+        for (int frame = 0; frame < kFrames; ++frame) {
+            vertices.clear();
+            system.Tick(reg, 0.016f);
+            reg.ClearChangeTracking();
+        }
+        return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    };
+
+    ECS::Registry noCullReg;
+    populate(noCullReg);
+    ECS::SpriteRenderSystem noCull;
+    noCull.culling = false;
+    auto noCullTime = timeFrames(noCullReg, noCull);
+
+    ECS::Registry linearReg;
+    populate(linearReg);
+    ECS::SpriteRenderSystem linear;
+    linear.spatialIndexThreshold = static_cast<size_t>(-1);
+    auto linearTime = timeFrames(linearReg, linear);
+
+    ECS::Registry indexedReg;
+    populate(indexedReg);
+    ECS::SpriteRenderSystem indexed;
+    auto indexedTime = timeFrames(indexedReg, indexed);
+
+    std::cout << "  Sprite culling x" << kFrames << " @ " << kCount << " sprites: no culling " << noCullTime
+              << " us, linear " << linearTime << " us, spatial index " << indexedTime << " us; submitted "
+              << indexed.GetSubmittedCount() << ", culled " << indexed.GetCulledCount() << "\n";
+
+    REQUIRE(indexed.GetSubmittedCount() == linear.GetSubmittedCount());
+    REQUIRE(indexed.GetCulledCount() == linear.GetCulledCount());
+    REQUIRE(noCull.GetSubmittedCount() == static_cast<uint32_t>(kCount));
+}
+
+TEST_CASE("Benchmark - Sprite Sort Keys", "[Benchmark][Rendering]") {
+    constexpr size_t kCount = 100000;
+    constexpr int kFrames = 20;
+
+    // Draw records as the batcher used to sort them: compared field by field
+    struct DrawRecord {
+        bool translucent;
+        int layer;
+        const Texture* texture;
+        uint32_t sequence;
+    };
+    std::vector<std::shared_ptr<Texture>> textures;
+    for (int i = 0; i < 8; ++i) {
+        textures.push_back(std::make_shared<Texture>());
+    }
+    std::mt19937 rng(3);
+    std::vector<DrawRecord> records(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        const bool translucent = rng() % 5 == 0;
+        records[i] = {translucent, static_cast<int>(rng() % 8), textures[rng() % textures.size()].get(),
+                      translucent ? static_cast<uint32_t>(i) : 0u};
+    }
+
+    std::vector<DrawRecord> sorted;
+    auto start = high_resolution_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        sorted = records;
+        std::stable_sort(sorted.begin(), sorted.end(), [](const DrawRecord& a, const DrawRecord& b) {
+            if (a.translucent != b.translucent) return b.translucent;
+            if (a.layer != b.layer) return a.layer < b.layer;
+            if (a.sequence != b.sequence) return a.sequence < b.sequence;
+            return a.texture < b.texture;
+        });
+    }
+    auto comparatorTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    // Same order from one 64-bit key per draw; buffers keep their capacity across frames
+    std::vector<SortEntry> keys;
+    std::vector<SortEntry> scratch;
+    start = high_resolution_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        keys.resize(kCount);
+        for (size_t i = 0; i < kCount; ++i) {
+            const DrawRecord& r = records[i];
+            keys[i] = {SpriteSortKey::Make(r.translucent, r.layer, 0, r.sequence, SpriteSortKey::TextureId(r.texture)),
+                       static_cast<uint32_t>(i)};
+        }
+        RadixSort(keys, scratch);
+    }
+    auto radixTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    std::cout << "  Sprite sort x" << kFrames << " @ " << kCount << " draws: comparator stable_sort "
+              << comparatorTime << " us, key + radix sort " << radixTime << " us\n";
+
+    // Both orders agree on everything but ties between colliding texture ids
+    REQUIRE(keys.size() == sorted.size());
+    for (size_t i = 0; i < kCount; ++i) {
+        const DrawRecord& r = records[keys[i].index];
+        REQUIRE(r.translucent == sorted[i].translucent);
+        REQUIRE(r.layer == sorted[i].layer);
+        REQUIRE(r.sequence == sorted[i].sequence);
+    }
+}
+
+TEST_CASE("Benchmark - ECS Animation Playheads", "[Benchmark][ECS]") {
+    constexpr int kCount = 5000;
+    constexpr int kFrames = 200;
+    const char* names[] = {"idle", "walk", "attack", "die"};
+
+    std::vector<AnimationClip> clips;
+    for (const char* name : names) {
+        AnimationClip clip(name);
+        for (int i = 0; i < 8; ++i) {
+            clip.AddFrame(Rect{0.125f * static_cast<float>(i), 0.0f, 0.125f, 0.25f}, 0.1f);
+        }
+        clips.push_back(clip);
+    }
+
+    // Before: every entity owns an Animator with its own copy of the clips
+    std::vector<Animator> animators(kCount);
+    std::vector<Sprite> sprites(kCount);
+    for (int i = 0; i < kCount; ++i) {
+        for (const auto& clip : clips) {
+            animators[i].AddClip(clip);
+        }
+        animators[i].Play(names[i % 4]);
+        animators[i].Update(0.013f * static_cast<float>(i % 8));
+    }
+    auto start = high_resolution_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (int i = 0; i < kCount; ++i) {
+            animators[i].Update(0.016f);
+            if (const auto* data = animators[i].GetCurrentFrameData()) {
+                sprites[i].textureRect = data->uvRect;
+                sprites[i].transform.origin = data->pivot;
+            }
+        }
+    }
+    auto animatorTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    // Estimate: the Animator, and per clip a map node, bucket and frame array
+    size_t clipBytes = 0;
+    for (const auto& clip : clips) {
+        clipBytes += sizeof(std::pair<const std::string, AnimationClip>) + 2 * sizeof(void*) +
+                     clip.GetFrameCount() * sizeof(AnimationFrame);
+    }
+    const size_t animatorBytes = kCount * (sizeof(Animator) + clipBytes);
+
+    // After: one shared library, a 16-byte playhead per entity
+    ECS::Registry reg;
+    auto library = std::make_shared<AnimationClipLibrary>();
+    std::vector<AnimationClipId> ids;
+    for (const auto& clip : clips) {
+        ids.push_back(library->Add(clip));
+    }
+    reg.Ctx<ECS::AnimationLibrary>().clips = library;
+    for (int i = 0; i < kCount; ++i) {
+        auto e = reg.CreateEntity();
+        reg.Add<ECS::SpriteComponent>(e);
+        ECS::PlayAnimation(reg, e, ids[i % 4]);
+        reg.Get<ECS::AnimationComponent>(e)->elapsed = 0.013f * static_cast<float>(i % 8);
+    }
+    ECS::AnimationSystem system;
+    start = high_resolution_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        system.Tick(reg, 0.016f);
+    }
+    auto playheadTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    const size_t playheadBytes = kCount * sizeof(ECS::AnimationComponent) + library->GetMemoryUsage();
+
+    std::cout << "  Animation x" << kFrames << " @ " << kCount << " entities: Animator " << animatorTime
+              << " us, ~" << animatorBytes / 1024 << " KiB; shared library " << playheadTime << " us, ~"
+              << playheadBytes / 1024 << " KiB\n";
+
+    // Same clock, same frames: both ways land on the same frame
+    size_t index = 0;
+    reg.ForEach<const ECS::AnimationComponent>([&](ECS::Entity, const ECS::AnimationComponent& anim) {
+        REQUIRE(anim.frame == animators[index].GetCurrentFrame());
+        ++index;
+    });
+    REQUIRE(index == static_cast<size_t>(kCount));
+    REQUIRE(playheadBytes < animatorBytes);
+}
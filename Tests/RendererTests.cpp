@@ -7,6 +7,9 @@
 #include "SAGE/Math/Color.h"
 #include "SAGE/Graphics/Renderer.h"
 #include "SAGE/Core/CommandLine.h"
+#include "SAGE/Core/ECSSystems.h"
+#include "SAGE/Graphics/ParticleSystem.h"
+#include "OpenGLStub.h"
 
 #include <filesystem>
 #include <fstream>
@@ -14,6 +17,7 @@
 #include <chrono>
 #include <string>
 #include <system_error>
+#include <vector>
 
 using namespace SAGE;
 
@@ -56,9 +60,16 @@ public:
 
     void BeginSpriteBatch(const Camera2D*) override {}
     void SubmitSprite(const Sprite&) override {}
+    void SubmitSprite(const Sprite&, uint64_t) override {}
     void FlushSpriteBatch() override {}
+    void RecordCulledSprites(uint32_t count) override { stats.spritesCulled += count; }
 
-    void DrawParticle(const Vector2&, float, const Color&, float) override {}
+    void DrawParticle(const Vector2&, float, const Color&, float) override { stats.drawCalls++; }
+    void DrawParticles(std::span<const ParticleInstance> particles, Texture* texture) override {
+        stats.drawCalls++;
+        stats.vertices += static_cast<uint32_t>(particles.size() * 4);
+        particleTextures.push_back(texture);
+    }
 
     void SetProjectionMatrix(const Matrix3& projection) override { projectionMatrix = projection; }
     void SetViewMatrix(const Matrix3& view) override { viewMatrix = view; }
@@ -78,6 +89,7 @@ public:
     Matrix3 projectionMatrix = Matrix3::Identity();
     Matrix3 viewMatrix = Matrix3::Identity();
     RenderStats stats{};
+    std::vector<Texture*> particleTextures;
 };
 
 void SetEnvVar(const char* name, const char* value) {
@@ -312,3 +324,49 @@ TEST_CASE("Renderer can disable runtime overrides", "[Renderer][Config]") {
     REQUIRE(backendInstance->receivedConfig.backend == RenderBackendType::OpenGL);
     REQUIRE(Renderer::GetConfig().backend == RenderBackendType::OpenGL);
 }
+
+TEST_CASE("ParticleSystemSystem draws one batch per emitter", "[Renderer][Particles]") {
+    RendererTestCleanup cleanup;
+
+    StubRenderBackend* backendInstance = nullptr;
+    Renderer::SetBackendFactory([&](RenderBackendType) {
+        auto backend = std::make_unique<StubRenderBackend>();
+        backendInstance = backend.get();
+        return backend;
+    });
+    RendererConfig config{};
+    config.enableRuntimeOverrides = false;
+    Renderer::Init(config);
+    REQUIRE(backendInstance != nullptr);
+
+    ECS::Registry reg;
+    auto texture = std::make_shared<Texture>(); // headless: no GL object behind it
+    auto makeEmitter = [&](int particles, std::shared_ptr<Texture> tex) {
+        auto e = reg.CreateEntity();
+        reg.Add<ECS::TransformComponent>(e).position = {10.0f, 20.0f};
+        auto& emitter = reg.Add<ECS::ParticleEmitterComponent>(e);
+        emitter.system = std::make_shared<ParticleSystem>(static_cast<size_t>(particles));
+        ParticleSystem::EmitterConfig emitterConfig;
+        emitterConfig.autoEmit = false;
+        emitterConfig.lifetimeMin = emitterConfig.lifetimeMax = 10.0f;
+        emitter.system->SetEmitterConfig(emitterConfig);
+        emitter.system->SetTexture(std::move(tex));
+        emitter.system->Start();
+        emitter.system->Burst(particles);
+        emitter.emissionRate = 0.0f;
+        return e;
+    };
+    makeEmitter(5000, nullptr);
+    makeEmitter(300, texture);
+
+    ECS::ParticleSystemSystem system;
+    backendInstance->ResetStats();
+    system.Tick(reg, 0.016f);
+
+    // 5300 particles, previously one draw call each
+    REQUIRE(backendInstance->GetStats().drawCalls == 2);
+    REQUIRE(backendInstance->GetStats().vertices == 5300 * 4);
+    REQUIRE(backendInstance->particleTextures.size() == 2);
+    REQUIRE(backendInstance->particleTextures[0] == nullptr);
+    REQUIRE(backendInstance->particleTextures[1] == texture.get());
+}